@@ -0,0 +1,172 @@
+/**
+ *  Throughput of `batch_step` against the number of threads.
+ *
+ *  Runs the same ROM in many instances, which share the ROM buffer, for
+ *  a few batches per thread count (1, 2, 4, ... up to -j, one per core by
+ *  default) and reports the frames per second of the whole pool, the
+ *  speedup over one thread and the efficiency per thread.
+ *
+ *  All instances run the same code with no input, so they must end in
+ *  the same state whatever the thread count. Any instance that doesn't
+ *  is reported, as a check of the pool.
+ *
+ *  Build from emu_core (host only):
+ *      gcc -std=gnu11 -O2 -Iinclude -Iinclude/core -Ipy_scripts \
+ *          bench/batch_bench.c src/batch.c src/emulator.c src/rewind.c \
+ *          src/core/{bus,cart,interrupt,memory,schedule,serial}.c \
+ *          src/core/cpu/{alu_tables,block_cache,cpu,cpu_instrs,profiler,tracer}.c \
+ *          src/platform/pc/error_handling.c -lpthread -o batch_bench
+ *
+ *  Usage:
+ *      batch_bench <rom> [--instances n] [--frames n] [--batches n] [-j threads]
+ */
+
+#define _GNU_SOURCE
+#include <common.h>
+#include <batch.h>
+#include <emulator.h>
+#include <gb_instance.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_INSTANCES     64
+#define BENCH_DEFAULT_FRAMES        60
+#define BENCH_DEFAULT_BATCHES       5
+
+#define BENCH_MAX_ROM_SIZE          (8u * 1024 * 1024)
+
+typedef struct bench {
+    uint8_t *rom;
+    size_t rom_size;
+
+    unsigned instances;
+    unsigned frames;
+    unsigned batches;
+
+    double base_fps;
+} bench_t;
+
+static bench_t bench;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static bool load_rom(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    bench.rom = calloc(BENCH_MAX_ROM_SIZE, 1);
+    bench.rom_size = (bench.rom != NULL) ? fread(bench.rom, 1, BENCH_MAX_ROM_SIZE, file) : 0;
+    fclose(file);
+
+    /* The cartridge expects at least both ROM banks */
+    if (bench.rom_size < 0x8000) bench.rom_size = 0x8000;
+    return bench.rom != NULL;
+}
+
+/**
+ *  Counts the instances whose state differs from the first one.
+ */
+static unsigned count_mismatches(const batch_job_t *jobs)
+{
+    unsigned mismatches = 0;
+
+    for (unsigned i = 1; i < bench.instances; ++i){
+        if (jobs[i].cycles != jobs[0].cycles
+            || cpu_get_cycles(jobs[i].gb) != cpu_get_cycles(jobs[0].gb)
+            || memcmp(jobs[i].view.wram, jobs[0].view.wram, WRAM_SIZE) != 0
+            || memcmp(jobs[i].view.frame, jobs[0].view.frame, VRAM_SIZE) != 0){
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static bool bench_threads(unsigned threads)
+{
+    batch_pool_t *pool = batch_pool_create(threads);
+    batch_job_t *jobs = aligned_alloc(GB_CACHE_LINE_SIZE, bench.instances * sizeof(batch_job_t));
+    if (pool == NULL || jobs == NULL) return false;
+
+    for (unsigned i = 0; i < bench.instances; ++i){
+        jobs[i] = (batch_job_t) { .gb = emulator_create() };
+        if (jobs[i].gb == NULL) return false;
+        emulator_init(jobs[i].gb, bench.rom, bench.rom_size);
+    }
+
+    /* Warms up the caches and the decoded blocks */
+    batch_step(pool, jobs, bench.instances, 1);
+
+    uint64_t start_ns = now_ns();
+    for (unsigned i = 0; i < bench.batches; ++i){
+        batch_step(pool, jobs, bench.instances, bench.frames);
+    }
+    double seconds = (now_ns() - start_ns) / 1e9;
+
+    double fps = (double) bench.instances * bench.frames * bench.batches / seconds;
+    if (threads == 1) bench.base_fps = fps;
+
+    double speedup = fps / bench.base_fps;
+    printf("%3u threads %12.0f frames/s %6.2fx %5.1f%% per thread, %u mismatching\n", threads, fps, speedup,
+           100.0 * speedup / threads, count_mismatches(jobs));
+
+    for (unsigned i = 0; i < bench.instances; ++i){
+        emulator_destroy(jobs[i].gb);
+    }
+    free(jobs);
+    batch_pool_destroy(pool);
+    return true;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s <rom> [--instances n] [--frames n] [--batches n] [-j threads]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *rom_path = NULL;
+    long max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    bench.instances = BENCH_DEFAULT_INSTANCES;
+    bench.frames = BENCH_DEFAULT_FRAMES;
+    bench.batches = BENCH_DEFAULT_BATCHES;
+
+    for (int i = 1; i < argc; ++i){
+        if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) bench.instances = (unsigned) atol(argv[++i]);
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) bench.frames = (unsigned) atol(argv[++i]);
+        else if (strcmp(argv[i], "--batches") == 0 && i + 1 < argc) bench.batches = (unsigned) atol(argv[++i]);
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) max_threads = atol(argv[++i]);
+        else if (argv[i][0] != '-' && rom_path == NULL) rom_path = argv[i];
+        else usage(argv[0]);
+    }
+    if (rom_path == NULL || bench.instances == 0 || bench.frames == 0 || bench.batches == 0) usage(argv[0]);
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > BATCH_MAX_THREADS) max_threads = BATCH_MAX_THREADS;
+
+    if (!load_rom(rom_path)){
+        perror(rom_path);
+        return EXIT_FAILURE;
+    }
+
+    printf("%u instances, %u frames per batch, %u batches\n", bench.instances, bench.frames, bench.batches);
+    for (unsigned threads = 1; ; threads *= 2){
+        if (threads > (unsigned) max_threads) threads = (unsigned) max_threads;
+        if (!bench_threads(threads)){
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+        if (threads == (unsigned) max_threads) break;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,372 @@
+/**
+ *  Per-opcode microbenchmark of the instruction handlers.
+ *
+ *  Runs every handler of the dispatch tables (CPU_OPTABLE and
+ *  CPU_PREFIX_OPTABLE, so the specialized ones unless built with
+ *  -DCPU_SPECIALIZED_HANDLERS=0) in isolation against a flat 64K RAM bus,
+ *  then weighted instruction mixes: uniform over the legal opcodes, plus
+ *  one per opcode profile given with --profile (the report written by
+ *  `profiler_write_report`).
+ *
+ *  Registers, SP and PC are reset before every call so each one runs the
+ *  same path, the cost of the reset is measured with an empty handler and
+ *  subtracted. Results are written as JSON (default) or CSV, for comparing
+ *  runs before and after a change to the handlers or the flag code.
+ *
+ *  Build from emu_core (host only):
+ *      gcc -std=gnu11 -O2 -Iinclude -Iinclude/core -Ipy_scripts \
+ *          bench/opcode_bench.c src/core/{bus,interrupt,schedule}.c \
+ *          src/core/cpu/{alu_tables,block_cache,cpu,cpu_instrs,profiler,tracer}.c \
+ *          src/core/cart.c src/platform/pc/error_handling.c -lpthread -o opcode_bench
+ *
+ *  Usage:
+ *      opcode_bench [--iters n] [--repeat n] [--profile report.txt]... [--csv] [--out file]
+ */
+
+#define _GNU_SOURCE
+#include <common.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/cpu_instrs.h>
+#include <core/interrupt.h>
+#include <gb_instance.h>
+#include <schedule.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_ITERS         200000
+#define BENCH_DEFAULT_REPEAT        3
+
+/* Instructions of a mix, run over and over */
+#define BENCH_MIX_LEN               4096
+#define BENCH_MAX_MIXES             8
+
+/* Flat RAM layout: immediates read as 0, CB opcodes at BENCH_CB_CODE + op */
+#define BENCH_ZERO_CODE             0x0100
+#define BENCH_CB_CODE               0x0200
+#define BENCH_DATA                  0xC000
+#define BENCH_STACK                 0xDFF0
+
+typedef struct bench_result {
+    double ns;
+    double mcycles;
+} bench_result_t;
+
+typedef struct bench_mix {
+    char name[128];
+    double weights[512];
+
+    bench_result_t result;
+} bench_mix_t;
+
+typedef struct bench {
+    gb_instance_t gb;
+    uint8_t ram[0x10000];
+    master_slave_conn_t ram_conn;
+
+    unsigned iters;
+    unsigned repeat;
+    double overhead_ns;
+
+    bench_result_t opcodes[512];
+
+    bench_mix_t mixes[BENCH_MAX_MIXES];
+    unsigned mixes_size;
+
+    /* One mix expanded into calls */
+    INSTR_FUNC mix_funcs[BENCH_MIX_LEN];
+    uint8_t mix_opcodes[BENCH_MIX_LEN];
+    addr_t mix_pcs[BENCH_MIX_LEN];
+
+} bench_t;
+
+static bench_t bench;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void bench_noop(cpu_context_t *context, uint8_t opcode)
+{
+    (void) context;
+    (void) opcode;
+}
+
+static bool is_legal(unsigned index)
+{
+    return index >= 256 || optable[index] != instr_unimplemented;
+}
+
+static void bench_init()
+{
+    /* Everything is plain RAM, no I/O */
+    bench.ram_conn = (master_slave_conn_t) {
+        .start_addr = 0x0000,
+        .end_addr = 0xFFFF,
+        .direct_read = bench.ram,
+        .direct_write = bench.ram,
+    };
+    for (unsigned op = 0; op < 256; ++op){
+        bench.ram[BENCH_CB_CODE + op] = (uint8_t) op;
+    }
+
+    schedule_init(&bench.gb);
+    interrupt_init(&bench.gb);
+    if (bus_connect(&bench.gb, &bench.ram_conn) != STATUS_OK){
+        fprintf(stderr, "Can't connect the RAM\n");
+        exit(EXIT_FAILURE);
+    }
+    bus_init(&bench.gb);
+    cpu_init(&bench.gb);
+}
+
+/**
+ *  Same starting state for every call, pointers into the data area.
+ */
+static inline void reset_context(cpu_context_t *context, addr_t pc)
+{
+    context->pc = pc;
+    context->sp = BENCH_STACK;
+    context->bc.full = BENCH_DATA;
+    context->de.full = BENCH_DATA;
+    context->hl.full = BENCH_DATA;
+    context->sleep_state = CPU_SLEEP_NONE;
+}
+
+/**
+ *  Runs `count` calls of the `size` long sequence, returns ns per call
+ *  (best of `bench.repeat`) and the M-cycles per call.
+ */
+static bench_result_t run_calls(INSTR_FUNC *funcs, const uint8_t *opcodes, const addr_t *pcs,
+                                unsigned size, unsigned count)
+{
+    cpu_context_t *context = cpu_get_context(&bench.gb);
+    bench_result_t result = { .ns = 1e30 };
+
+    for (unsigned r = 0; r < bench.repeat; ++r){
+        m_cycle_t start_cycles = context->cycles;
+        uint64_t start_ns = now_ns();
+
+        for (unsigned i = 0, k = 0; i < count; ++i){
+            reset_context(context, pcs[k]);
+            funcs[k](context, opcodes[k]);
+            if (++k == size) k = 0;
+        }
+
+        double ns = (double) (now_ns() - start_ns) / count;
+        if (ns < result.ns) result.ns = ns;
+        result.mcycles = (double) (context->cycles - start_cycles) / count;
+    }
+
+    return result;
+}
+
+static void bench_opcodes()
+{
+    INSTR_FUNC noop = bench_noop;
+    uint8_t zero = 0;
+    addr_t pc = BENCH_ZERO_CODE;
+
+    bench.overhead_ns = run_calls(&noop, &zero, &pc, 1, bench.iters).ns;
+
+    for (unsigned index = 0; index < 512; ++index){
+        if (!is_legal(index)) continue;
+
+        INSTR_FUNC func = (index < 256) ? CPU_OPTABLE[index] : CPU_PREFIX_OPTABLE[index - 256];
+        uint8_t opcode = (uint8_t) index;
+
+        bench.opcodes[index] = run_calls(&func, &opcode, &pc, 1, bench.iters);
+        bench.opcodes[index].ns -= bench.overhead_ns;
+    }
+}
+
+/**
+ *  Reads the opcode table of a profiler report (`XX count cycles` and
+ *  `CB XX count cycles` lines). Returns false if there's none.
+ */
+static bool load_profile(bench_mix_t *mix, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) return false;
+
+    char line[256];
+    bool found = false;
+    while (fgets(line, sizeof(line), file) != NULL){
+        unsigned op;
+        unsigned long long count;
+
+        /* The opcode table ends at the (bank, pc) table */
+        if (strncmp(line, "# bank", 6) == 0) break;
+
+        if (sscanf(line, "CB %2x %llu", &op, &count) == 2){
+            mix->weights[256 + op] += (double) count;
+            found = true;
+        } else if (sscanf(line, "%2x %llu", &op, &count) == 2){
+            mix->weights[op] += (double) count;
+            found = true;
+        }
+    }
+    fclose(file);
+
+    snprintf(mix->name, sizeof(mix->name), "profile:%s", path);
+    return found;
+}
+
+/* xorshift32, fixed seed so every run draws the same mix */
+static uint32_t next_random(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void bench_mix(bench_mix_t *mix)
+{
+    double cumulative[512], total = 0;
+    uint32_t seed = 0x2545F491u;
+
+    for (unsigned index = 0; index < 512; ++index){
+        /* The CB prefix itself is counted through its CB opcodes */
+        if (!is_legal(index) || index == 0xCB) mix->weights[index] = 0;
+        total += mix->weights[index];
+        cumulative[index] = total;
+    }
+    if (total == 0) return;
+
+    for (unsigned i = 0; i < BENCH_MIX_LEN; ++i){
+        double pick = (next_random(&seed) / 4294967296.0) * total;
+        unsigned index = 0;
+        while (index < 511 && cumulative[index] <= pick) index++;
+
+        /* CB opcodes run through the prefix handler, like in a real stream */
+        if (index >= 256){
+            bench.mix_funcs[i] = CPU_OPTABLE[0xCB];
+            bench.mix_opcodes[i] = 0xCB;
+            bench.mix_pcs[i] = (addr_t) (BENCH_CB_CODE + index - 256);
+        } else {
+            bench.mix_funcs[i] = CPU_OPTABLE[index];
+            bench.mix_opcodes[i] = (uint8_t) index;
+            bench.mix_pcs[i] = BENCH_ZERO_CODE;
+        }
+    }
+
+    mix->result = run_calls(bench.mix_funcs, bench.mix_opcodes, bench.mix_pcs, BENCH_MIX_LEN, bench.iters * 4);
+    mix->result.ns -= bench.overhead_ns;
+}
+
+static const char *table_name()
+{
+#if CPU_SPECIALIZED_HANDLERS
+    return "specialized";
+#else
+    return "generic";
+#endif
+}
+
+static void write_json(FILE *file)
+{
+    fprintf(file, "{\n  \"table\": \"%s\", \"cycle_accurate\": %d, \"iterations\": %u, \"overhead_ns\": %.3f,\n",
+            table_name(), CPU_CYCLE_ACCURATE, bench.iters, bench.overhead_ns);
+
+    fprintf(file, "  \"opcodes\": [\n");
+    bool first = true;
+    for (unsigned index = 0; index < 512; ++index){
+        if (!is_legal(index)) continue;
+
+        const bench_result_t *result = &bench.opcodes[index];
+        fprintf(file, "%s    {\"opcode\": \"%s%02X\", \"ns\": %.3f, \"mips\": %.2f, \"mcycles\": %.2f}",
+                first ? "" : ",\n", (index >= 256) ? "CB " : "", index & 0xFF, result->ns,
+                (result->ns > 0) ? 1e3 / result->ns : 0.0, result->mcycles);
+        first = false;
+    }
+
+    fprintf(file, "\n  ],\n  \"mixes\": [\n");
+    for (unsigned i = 0; i < bench.mixes_size; ++i){
+        const bench_result_t *result = &bench.mixes[i].result;
+        fprintf(file, "    {\"mix\": \"%s\", \"ns\": %.3f, \"mips\": %.2f, \"mcycles\": %.2f}%s\n",
+                bench.mixes[i].name, result->ns, (result->ns > 0) ? 1e3 / result->ns : 0.0, result->mcycles,
+                (i + 1 < bench.mixes_size) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+static void write_csv(FILE *file)
+{
+    fprintf(file, "kind,name,ns,mips,mcycles\n");
+    for (unsigned index = 0; index < 512; ++index){
+        if (!is_legal(index)) continue;
+
+        const bench_result_t *result = &bench.opcodes[index];
+        fprintf(file, "opcode,%s%02X,%.3f,%.2f,%.2f\n", (index >= 256) ? "CB " : "", index & 0xFF,
+                result->ns, (result->ns > 0) ? 1e3 / result->ns : 0.0, result->mcycles);
+    }
+    for (unsigned i = 0; i < bench.mixes_size; ++i){
+        const bench_result_t *result = &bench.mixes[i].result;
+        fprintf(file, "mix,%s,%.3f,%.2f,%.2f\n", bench.mixes[i].name, result->ns,
+                (result->ns > 0) ? 1e3 / result->ns : 0.0, result->mcycles);
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [--iters n] [--repeat n] [--profile report.txt]... [--csv] [--out file]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_path = NULL;
+    bool csv = false;
+
+    bench.iters = BENCH_DEFAULT_ITERS;
+    bench.repeat = BENCH_DEFAULT_REPEAT;
+
+    /* Uniform mix over every legal instruction */
+    bench_mix_t *uniform = &bench.mixes[bench.mixes_size++];
+    snprintf(uniform->name, sizeof(uniform->name), "uniform");
+    for (unsigned index = 0; index < 512; ++index){
+        uniform->weights[index] = 1;
+    }
+
+    for (int i = 1; i < argc; ++i){
+        if (strcmp(argv[i], "--iters") == 0 && i + 1 < argc) bench.iters = (unsigned) atol(argv[++i]);
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) bench.repeat = (unsigned) atol(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0) csv = true;
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc){
+            if (bench.mixes_size == BENCH_MAX_MIXES){
+                fprintf(stderr, "At most %u mixes\n", BENCH_MAX_MIXES);
+                return 2;
+            }
+            if (!load_profile(&bench.mixes[bench.mixes_size], argv[++i])){
+                fprintf(stderr, "No opcode table in %s\n", argv[i]);
+                return 2;
+            }
+            bench.mixes_size++;
+        }
+        else usage(argv[0]);
+    }
+    if (bench.iters == 0 || bench.repeat == 0) usage(argv[0]);
+
+    bench_init();
+    bench_opcodes();
+    for (unsigned i = 0; i < bench.mixes_size; ++i){
+        bench_mix(&bench.mixes[i]);
+    }
+
+    FILE *out = (out_path != NULL) ? fopen(out_path, "w") : stdout;
+    if (out == NULL){
+        perror(out_path);
+        return EXIT_FAILURE;
+    }
+    if (csv) write_csv(out);
+    else write_json(out);
+
+    return (out == stdout || fclose(out) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,95 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+/**
+ *  Batch stepping of many instances on a thread pool (host only, uses
+ *  pthreads), for running farms of machines, e.g. reinforcement learning
+ *  or regression runs.
+ *
+ *  `batch_step` runs every job of a batch for the same number of frames.
+ *  Jobs are split in contiguous ranges, one per worker, and a worker that
+ *  runs out of jobs steals half of what's left in another worker's range,
+ *  so instances that run slower (or faster, idle loops are skipped) don't
+ *  leave cores idle. The calling thread is one of the workers.
+ *
+ *  Instances only share the read-only ROM and tables, the workers only
+ *  touch their own instance. Instances from `emulator_create`, jobs and
+ *  worker slots are cache-line aligned so no two of them share a line.
+ *
+ *  There is no PPU or joypad yet: the frame view is VRAM, which the PPU
+ *  will draw from, and input is applied by a hook before each frame.
+ */
+
+#include <common.h>
+#include <gb_instance.h>
+
+/* Most threads in a pool, the calling thread included */
+#ifndef BATCH_MAX_THREADS
+#define BATCH_MAX_THREADS           256
+#endif
+
+/**
+ *  Applies the input of a job to its instance, called on the worker
+ *  thread before every frame, `frame` counts from 0 in the batch.
+ */
+typedef void (*batch_input_hook_t)(gb_instance_t *gb, const void *input, unsigned frame);
+
+/**
+ *  Memory of an instance, pointing into the instance itself. Valid until
+ *  the instance runs again.
+ */
+typedef struct batch_view {
+    const uint8_t *frame;
+    const uint8_t *wram;
+    const uint8_t *oam;
+    const uint8_t *hram;
+} batch_view_t;
+
+/**
+ *  One instance of a batch. `gb` and `input` are set by the caller,
+ *  `cycles` and `view` are filled by `batch_step`.
+ */
+typedef struct batch_job {
+    _Alignas(GB_CACHE_LINE_SIZE) gb_instance_t *gb;
+    const void *input;
+
+    m_cycle_t cycles;
+    batch_view_t view;
+} batch_job_t;
+
+typedef struct batch_pool batch_pool_t;
+
+/**
+ *  Starts a pool of `threads` workers, the calling thread included,
+ *  one per core if 0. Returns NULL if the pool can't be made.
+ */
+batch_pool_t *batch_pool_create(unsigned threads);
+
+/**
+ *  Stops the workers and frees the pool.
+ */
+void batch_pool_destroy(batch_pool_t *pool);
+
+/**
+ *  Number of workers of the pool, the calling thread included.
+ */
+unsigned batch_pool_get_threads(batch_pool_t *pool);
+
+/**
+ *  Sets the hook applying the input of each job, none by default.
+ */
+void batch_set_input_hook(batch_pool_t *pool, batch_input_hook_t hook);
+
+/**
+ *  Runs every job for `frames` frames and returns once all are done.
+ *  An instance must not be in more than one job of a batch. The pool
+ *  runs one batch at a time.
+ */
+void batch_step(batch_pool_t *pool, batch_job_t *jobs, unsigned count, unsigned frames);
+
+/**
+ *  Views of the memory of `gb`, no copy made.
+ */
+batch_view_t batch_get_view(gb_instance_t *gb);
+
+#endif // BATCH_H
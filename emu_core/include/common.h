@@ -40,6 +40,12 @@ typedef uint64_t t_cycle_t;
 */
 #define MAX_DEVICE_NUMBER 20
 
+/*
+    One emulated machine, see `gb_instance.h`. Every module works on the
+    instance it is given, so several can run side by side.
+*/
+typedef struct gb_instance gb_instance_t;
+
 
 
 
@@ -0,0 +1,86 @@
+#ifndef ALU_TABLES_H
+#define ALU_TABLES_H
+
+/**
+ *  Precomputed flags for the 8-bit ALU and DAA.
+ *
+ *  The tables are constant expressions expanded by the preprocessor in
+ *  alu_tables.c, so they are generated by the compiler and live in
+ *  read-only memory (flash on the MCU).
+ *
+ *  CPU_ALU_TABLES picks the size:
+ *  - CPU_ALU_TABLES_FULL: Z/N/H/C of ADD/ADC and SUB/SBC/CP indexed by
+ *    (carry, a, b), 256 KiB, plus the DAA table.
+ *  - CPU_ALU_TABLES_SMALL: Z/C indexed by the 9-bit result (512 bytes),
+ *    H from the carry into bit 4, plus the DAA table. For the flash build.
+ *  - CPU_ALU_TABLES_OFF: flags are computed with compares, no tables.
+ *
+ *  The DAA table (4 KiB) holds the result and flags indexed by (NHC, A).
+ */
+
+#include <common.h>
+
+#define CPU_ALU_TABLES_OFF          0
+#define CPU_ALU_TABLES_SMALL        1
+#define CPU_ALU_TABLES_FULL         2
+
+#ifndef CPU_ALU_TABLES
+#define CPU_ALU_TABLES              CPU_ALU_TABLES_FULL
+#endif
+
+#define ALU_FLAG_Z                  0x80
+#define ALU_FLAG_N                  0x40
+#define ALU_FLAG_H                  0x20
+#define ALU_FLAG_C                  0x10
+
+#if CPU_ALU_TABLES
+
+/* Index of DAA entries: N, H, C of F as bits 2, 1, 0 */
+#define ALU_DAA_NHC(flags)          (((flags) >> 4) & 0x7)
+
+/* DAA entries: result in the low byte, F in the high byte */
+extern const uint16_t alu_daa_table[8][256];
+
+#if CPU_ALU_TABLES == CPU_ALU_TABLES_FULL
+
+extern const uint8_t alu_add_flag_table[2][256 * 256];
+extern const uint8_t alu_sub_flag_table[2][256 * 256];
+
+/**
+ *  Returns F after `a + b + carry`.
+ */
+static inline uint8_t alu_add_flags(uint8_t a, uint8_t b, uint8_t carry)
+{
+    return alu_add_flag_table[carry & 1][(a << 8) | b];
+}
+
+/**
+ *  Returns F after `a - b - carry`.
+ */
+static inline uint8_t alu_sub_flags(uint8_t a, uint8_t b, uint8_t carry)
+{
+    return alu_sub_flag_table[carry & 1][(a << 8) | b];
+}
+
+#else
+
+/* Z and C indexed by the 9-bit result, bit 8 being the carry/borrow */
+extern const uint8_t alu_zc_flag_table[512];
+
+static inline uint8_t alu_add_flags(uint8_t a, uint8_t b, uint8_t carry)
+{
+    unsigned result = (unsigned) a + b + (carry & 1);
+    return alu_zc_flag_table[result] | (((a ^ b ^ result) & 0x10) << 1);
+}
+
+static inline uint8_t alu_sub_flags(uint8_t a, uint8_t b, uint8_t carry)
+{
+    unsigned result = ((unsigned) a - b - (carry & 1)) & 0x1FF;
+    return ALU_FLAG_N | alu_zc_flag_table[result] | (((a ^ b ^ result) & 0x10) << 1);
+}
+
+#endif // CPU_ALU_TABLES == CPU_ALU_TABLES_FULL
+
+#endif // CPU_ALU_TABLES
+
+#endif // ALU_TABLES_H
@@ -0,0 +1,119 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+/**
+ *  Decoded basic-block cache for the CPU.
+ *
+ *  Straight-line runs of instructions are decoded once into arrays of
+ *  handler pointers with their operands already extracted, keyed by
+ *  (ROM bank, PC). A block ends on the first instruction that can change
+ *  control flow or interrupt state, or at the end of a 256-byte page.
+ *
+ *  Blocks decoded from RAM watch their page on the bus, and are dropped
+ *  as soon as the page is written to.
+ */
+
+#include <common.h>
+#include <core/cpu_instrs.h>
+
+/*
+    Enabled by default, define as 0 to build without the cache (e.g. for the MCU).
+    Blocks skip the per-access timing, so the cycle accurate core goes without.
+*/
+#ifndef CPU_BLOCK_CACHE_ENABLED
+#define CPU_BLOCK_CACHE_ENABLED     (!CPU_CYCLE_ACCURATE)
+#endif
+
+#if CPU_BLOCK_CACHE_ENABLED && CPU_CYCLE_ACCURATE
+#error "The block cache can't be used with the cycle accurate core"
+#endif
+
+/* Number of blocks in the cache, must be a power of two */
+#ifndef BLOCK_CACHE_ENTRIES
+#define BLOCK_CACHE_ENTRIES         1024
+#endif
+
+/* Maximum instructions decoded into a single block */
+#define BLOCK_MAX_INSTRS            16
+
+typedef struct decoded_instr
+{
+    INSTR_FUNC func;
+    uint8_t opcode;
+
+    /* Instruction length in bytes */
+    uint8_t length;
+
+    /* Immediates following the opcode (little endian) */
+    uint8_t operands[2];
+
+} decoded_instr_t;
+
+typedef struct decoded_block
+{
+    /* Key */
+    uint16_t rom_bank;
+    addr_t start_pc;
+    bool valid;
+
+    /* Number of decoded instructions */
+    uint8_t instr_count;
+
+    /* Sum of base M-cycles of all instructions in the block */
+    m_cycle_t cycles;
+
+    /*
+        Block is a loop back to its own start that only reads memory
+        (e.g. polling LY). Running it again gives the same result until
+        a device changes the polled value.
+    */
+    bool idle_loop;
+
+    decoded_instr_t instrs[BLOCK_MAX_INSTRS];
+
+} decoded_block_t;
+
+typedef struct block_cache {
+    decoded_block_t blocks[BLOCK_CACHE_ENTRIES];
+
+    /* Pages holding code decoded from RAM, watched on the bus */
+    bool watched_pages[BUS_PAGE_COUNT];
+
+    /* Bumped on every invalidation, so running blocks can bail out */
+    uint32_t epoch;
+} block_cache_t;
+
+/**
+ *  Initializes the block cache, registering its bus write watcher.
+ */
+void block_cache_init(gb_instance_t *gb);
+
+/**
+ *  Returns the block starting at `pc`, decoding it if needed.
+ *  Returns NULL if code at `pc` can't be cached (e.g. not plain memory).
+ */
+decoded_block_t *block_cache_lookup(gb_instance_t *gb, addr_t pc);
+
+/**
+ *  Executes a block. Stops early if the block is invalidated while
+ *  running (self-modifying code, bank switch).
+ */
+void block_cache_run(gb_instance_t *gb, decoded_block_t *block);
+
+/**
+ *  Drops every block decoded from `page`, or from the page mapping the
+ *  same memory (echo RAM and WRAM).
+ */
+void block_cache_invalidate_page(gb_instance_t *gb, uint8_t page);
+
+/**
+ *  Drops every block, e.g. after memory was restored behind the bus.
+ */
+void block_cache_flush(gb_instance_t *gb);
+
+/**
+ *  To be called on an MBC ROM bank switch.
+ */
+void block_cache_on_bank_switch(gb_instance_t *gb, uint16_t rom_bank);
+
+#endif // BLOCK_CACHE_H
@@ -1,7 +1,7 @@
 #ifndef BUS_H
 #define BUS_H
 
-/** 
+/**
  *  This file is responsible for managing memory reads/
  *  writes in-between devices.
  */
@@ -10,20 +10,117 @@
 #include <master_slave.h>
 #include <core/memorymap.h>
 
+/* The 16-bit address space is split into 256 pages of 256 bytes */
+#define BUS_PAGE_SHIFT              8
+#define BUS_PAGE_SIZE               (1u << BUS_PAGE_SHIFT)
+#define BUS_PAGE_COUNT              (0x10000u >> BUS_PAGE_SHIFT)
+#define BUS_PAGE_OF(addr)           ((uint8_t) ((addr) >> BUS_PAGE_SHIFT))
+#define BUS_PAGE_OFFSET(addr)       ((uint8_t) ((addr) & (BUS_PAGE_SIZE - 1)))
+
+/*
+    Pages shared by more than one connection (e.g. 0xFF00 for I/O, HRAM and IE)
+    fall back to a per-byte table. There are only a couple of these on the DMG.
+*/
+#define BUS_MAX_SHARED_PAGES        4
+
+/**
+ *  Dispatch entry for one 256-byte page.
+ *
+ *  - `read_mem`/`write_mem` point at the first byte of the page in host
+ *    memory, when the whole page is plain memory of a single connection.
+ *  - `conn` is the connection owning the whole page, used for callbacks.
+ *  - `shared` is set instead of `conn` when several connections share the page.
+ */
+typedef struct bus_page
+{
+    const uint8_t *read_mem;
+    uint8_t *write_mem;
+    master_slave_conn_t *conn;
+    master_slave_conn_t **shared;
+
+    /* Writes to a watched page are reported to the write watcher first */
+    bool watched;
+
+} bus_page_t;
+
+/* Called before a write lands on a watched page */
+typedef void (*bus_write_watcher_t)(gb_instance_t *gb, addr_t addr);
+
+/*
+    Page dispatch table, compiled from the connections in `bus_init`.
+    Looked up by every access, it lives in the hot part of the instance.
+*/
 typedef struct bus
+{
+    bus_page_t pages[BUS_PAGE_COUNT];
+
+} bus_context_t;
+
+/*
+    What the page table is compiled from, and what the slow paths need.
+    Kept apart from `bus_context_t`, in the cold part of the instance.
+*/
+typedef struct bus_setup
 {
     /* Array of master-slave connections, and size */
-    master_slave_conn_t **connections;
-    const unsigned connections_size;
+    master_slave_conn_t *connections[MAX_DEVICE_NUMBER];
+    unsigned connections_size;
 
+    /* Per-byte connection tables for shared pages */
+    master_slave_conn_t *shared_pages[BUS_MAX_SHARED_PAGES][BUS_PAGE_SIZE];
+    unsigned shared_pages_size;
 
+    bus_write_watcher_t write_watcher;
 
-} bus_context_t;
+} bus_setup_t;
+
+/**
+ *  Registers a connection on the bus. Must be called before `bus_init`.
+ *
+ *  Returns STATUS_BUS_CONFLICT if the address range overlaps a
+ *  connection that is already registered, or STATUS_FULL_CONTAINER if
+ *  there is no room left.
+ */
+error_code_t bus_connect(gb_instance_t *gb, master_slave_conn_t *conn);
 
 /*
-    Initializes bus.
+    Initializes bus, compiling every registered connection into the
+    page dispatch table.
 */
-void bus_init();
+void bus_init(gb_instance_t *gb);
+
+/**
+ *  Recompiles the pages covered by `conn`. Call this after changing
+ *  the connection's direct memory pointers (e.g. on an MBC bank switch).
+ */
+void bus_update_connection(gb_instance_t *gb, master_slave_conn_t *conn);
+
+/**
+ *  Returns the host memory backing the page of `addr`, or NULL if the
+ *  page is not plain memory owned by a single connection.
+ *  The pointer is to the first byte of the page.
+ */
+const uint8_t *bus_get_page_mem(gb_instance_t *gb, addr_t addr);
+
+/**
+ *  Returns the host memory of the connection owning `addr` and its range
+ *  in `start`/`end`, or NULL if the page of `addr` is not plain memory.
+ *  The pointer is to the byte at `start`, and stays valid until the
+ *  connection is updated.
+ */
+const uint8_t *bus_get_read_window(gb_instance_t *gb, addr_t addr, addr_t *start, addr_t *end);
+
+/**
+ *  Sets the function to be notified of writes to watched pages.
+ */
+void bus_set_write_watcher(gb_instance_t *gb, bus_write_watcher_t watcher);
+
+/**
+ *  Watches/unwatches writes to a page. Watched pages lose their direct
+ *  write path until unwatched.
+ */
+void bus_watch_page(gb_instance_t *gb, uint8_t page);
+void bus_unwatch_page(gb_instance_t *gb, uint8_t page);
 
 /*
     Internals of bus
@@ -32,11 +129,11 @@ void bus_init();
 /*
     Write address to bus.
 */
-uint8_t bus_write(addr_t addr, uint8_t value);
+error_code_t bus_write(gb_instance_t *gb, addr_t addr, uint8_t value);
 
 /*
     Read data from bus.
 */
-uint8_t bus_read(addr_t addr);
+uint8_t bus_read(gb_instance_t *gb, addr_t addr);
 
 #endif
@@ -3,8 +3,36 @@
 
 #include <common.h>
 #include <core/bus.h>
+#include <core/tracer.h>
 
 
+/*
+    Initial state of idle loop skipping, can be switched at runtime
+    with `cpu_set_idle_loop_skip`. Needs the block cache.
+*/
+#ifndef CPU_IDLE_LOOP_SKIP
+#define CPU_IDLE_LOOP_SKIP          1
+#endif
+
+/*
+    M-cycle accurate core: every memory access of an instruction happens on
+    its own M-cycle, with due device events run in between. The fast core
+    (default) only adds up each instruction's cycles once it's done.
+    Turns the block cache off.
+*/
+#ifndef CPU_CYCLE_ACCURATE
+#define CPU_CYCLE_ACCURATE          0
+#endif
+
+/*
+    Counts consecutive opcode pairs, for picking the fused pairs of
+    gen_optable.py (see `cpu_pair_profile_write`). Single steps every
+    instruction through the optable, profiling builds only.
+*/
+#ifndef CPU_PAIR_PROFILE
+#define CPU_PAIR_PROFILE            0
+#endif
+
 /* Regs */
 #define REGHIGH(reg16)              ((uint8_t) (((reg16) >> 8) & 0xff)  )
 #define REGLOW(reg16)               ((uint8_t)  ((reg16) & 0xff)        )
@@ -12,29 +40,94 @@
 
 /**
  *  Register datatype, comes in two forms,
+ *  `hi`/`lo` alias the high and low bytes of `full` on either host byte order.
  */
 typedef union reg
 {
     uint16_t full;
     struct 
     {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
         uint8_t hi;
         uint8_t lo;
+#else
+        uint8_t lo;
+        uint8_t hi;
+#endif
     };
     
-} register_t;
+} cpu_register_t;
 
 typedef union status_reg
 {
     uint16_t full;
     struct 
     {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
         uint8_t hi;
         uint8_t lo;
+#else
+        uint8_t lo;
+        uint8_t hi;
+#endif
     };
     
 } status_register_t;
 
+/**
+ *  Kinds of flag-producing operations recorded for lazy flag evaluation.
+ */
+typedef enum cpu_flag_op {
+    /* F (af.lo) is up to date */
+    CPU_FLAG_OP_NONE = 0,
+    CPU_FLAG_OP_ADD,        /* ADD/ADC */
+    CPU_FLAG_OP_SUB,        /* SUB/SBC/CP */
+    CPU_FLAG_OP_AND,
+    CPU_FLAG_OP_OR,         /* OR/XOR */
+    CPU_FLAG_OP_INC,
+    CPU_FLAG_OP_DEC,
+    CPU_FLAG_OP_SHIFT,      /* CB rotates/shifts: Z and C */
+} cpu_flag_op_t;
+
+/**
+ *  Last flag-producing operation. F is only computed from this when
+ *  something actually reads it.
+ */
+typedef struct cpu_lazy_flags {
+    uint8_t op;
+
+    /* Operands */
+    uint8_t a;
+    uint8_t b;
+
+    /* Carry in (ADD/SUB), or carry out/preserved carry (INC/DEC/SHIFT) */
+    uint8_t carry;
+
+    uint16_t result;
+
+} cpu_lazy_flags_t;
+
+/**
+ *  Low power states entered by HALT and STOP.
+ */
+typedef enum cpu_sleep_state {
+    CPU_SLEEP_NONE = 0,
+    /* Woken up by any enabled interrupt, even with IME cleared */
+    CPU_SLEEP_HALT,
+    /* Woken up by a joypad interrupt only */
+    CPU_SLEEP_STOP,
+} cpu_sleep_state_t;
+
+/**
+ *  Host memory PC is currently fetching from: `size` bytes starting at
+ *  guest address `start`. Empty (size 0) when PC is not in plain memory.
+ */
+typedef struct cpu_fetch_window {
+    const uint8_t *mem;
+    addr_t start;
+    uint32_t size;
+} cpu_fetch_window_t;
+
 /**
  *  Data structure to contain execution context 
  *  (registers, sp, lr)
@@ -42,32 +135,296 @@ typedef union status_reg
 typedef struct cpu_context {
     
     /* Registers */
-    register_t af;
-    register_t bc;
-    register_t de;
-    register_t hl;
+    cpu_register_t af;
+    cpu_register_t bc;
+    cpu_register_t de;
+    cpu_register_t hl;
     uint16_t sp;
     uint16_t pc;
 
+    /* Pending flag computation, F is stale until synced */
+    cpu_lazy_flags_t lazy_flags;
+
     /* Cycles elapsed for CPU in m_cycles*/
     uint64_t cycles;
 
+    /*
+        Cycle the running batch or block stops at. Lowered while running by
+        an earlier event being scheduled, or set to 0 by an interrupt
+        becoming serviceable, so the CPU gets back to `cpu_run` in time.
+    */
+    uint64_t deadline;
+
+    /* M-cycles already ticked by the running instruction (accurate core) */
+    uint8_t instr_mcycles;
+
     /* 
         Interrupt enable flag. 
     */
     uint8_t ime;
 
+    /* Set by EI, interrupts are held off for one more instruction */
+    uint8_t ei_delay;
+
+    /* Set by HALT/STOP, no instructions run until woken up */
+    uint8_t sleep_state;
+
+    /* Set by HALT with IME cleared and an interrupt pending, the next opcode fetch doesn't move PC */
+    uint8_t halt_bug;
+
+    /*
+        When set, immediates are read from here instead of the bus.
+        Used by the block cache to hand over pre-extracted operands.
+    */
+    const uint8_t *imm_ptr;
+
+    /* Opcode and immediate fetches read from here while PC stays inside */
+    cpu_fetch_window_t fetch;
+
 } cpu_context_t;
 
+/*
+    Instance a CPU context belongs to. The context is the first member of
+    `gb_instance_t`, so handlers only get the context and find everything
+    else from it.
+*/
+#define CPU_INSTANCE(context)       ((gb_instance_t *) (context))
+
+#if CPU_PAIR_PROFILE
+/*
+    Opcode pair counts of an instance, indexed by (first << 8) | second.
+*/
+typedef struct cpu_pair_profile {
+    uint32_t counts[256 * 256];
+
+    /* Previous opcode, or -1 after an interrupt broke the sequence */
+    int prev_opcode;
+
+} cpu_pair_profile_t;
+#endif
+
+/*
+    Idle loop skipping state.
+*/
+typedef struct cpu_idle_loop {
+    bool enabled;
+
+    /* Length of one iteration of the idle loop last run, 0 if not in one */
+    m_cycle_t loop_cycles;
+
+    /* Cycles fast-forwarded instead of running the loop */
+    m_cycle_t skipped_cycles;
+
+} cpu_idle_loop_t;
+
+/**
+ *  Architectural CPU state, as saved in snapshots. Fixed-width fields
+ *  with no host pointers, F already materialized.
+ */
+typedef struct cpu_state {
+    uint64_t cycles;
+    uint16_t af;
+    uint16_t bc;
+    uint16_t de;
+    uint16_t hl;
+    uint16_t sp;
+    uint16_t pc;
+    uint8_t ime;
+    uint8_t ei_delay;
+    uint8_t sleep_state;
+    uint8_t halt_bug;
+} cpu_state_t;
+
 // Stub, wait to define bus structures
-void cpu_init();
+void cpu_init(gb_instance_t *gb);
 
 /**
  *  Steps over one CPU cycle, i.e. steps over one instruction
  */
-void cpu_step();
+void cpu_tick(gb_instance_t *gb);
+
+/**
+ *  Runs the CPU for up to `budget` M-cycles, stopping early at the next
+ *  scheduled event. May overshoot by the length of one instruction.
+ *
+ *  HALT/STOP and idle loops skip straight to the end of the slice.
+ *  Interrupts are tested with a single load of the interrupt module's
+ *  serviceable word before each run of instructions.
+ *
+ *  Returns the number of M-cycles actually consumed.
+ */
+m_cycle_t cpu_run(gb_instance_t *gb, m_cycle_t budget);
+
+/**
+ *  Cycles elapsed since `cpu_init`, in M-cycles.
+ */
+m_cycle_t cpu_get_cycles(gb_instance_t *gb);
+
+/**
+ *  Returns the CPU state, for debuggers, savestates and test harnesses.
+ *  F is only up to date after `cpu_flags_sync`.
+ */
+cpu_context_t *cpu_get_context(gb_instance_t *gb);
+
+/**
+ *  Copies the CPU state into `state`.
+ */
+void cpu_save_state(gb_instance_t *gb, cpu_state_t *state);
+
+/**
+ *  Restores the CPU state from `state`. Decoded blocks, the fetch window
+ *  and idle loop tracking are dropped, since memory may have changed too.
+ */
+void cpu_load_state(gb_instance_t *gb, const cpu_state_t *state);
+
+/**
+ *  Enables/disables idle loop skipping.
+ */
+void cpu_set_idle_loop_skip(gb_instance_t *gb, bool enabled);
+
+/**
+ *  Cycles skipped in idle loops since `cpu_init`.
+ */
+m_cycle_t cpu_get_idle_skipped_cycles(gb_instance_t *gb);
+
+/**
+ *  Materializes F from the last flag-producing operation.
+ *  Must be called before reading `af` from outside the instruction handlers
+ *  (savestates, debuggers, tracing).
+ */
+void cpu_flags_sync(cpu_context_t *context);
+
+#if CPU_CYCLE_ACCURATE
+/**
+ *  Advances one M-cycle, running every device event that is due.
+ */
+void cpu_mcycle(cpu_context_t *context);
+
+/**
+ *  Ends an instruction taking `cycles` M-cycles, ticking the ones
+ *  not spent on memory accesses.
+ */
+void cpu_finish_instr(cpu_context_t *context, m_cycle_t cycles);
+#endif
+
+/**
+ *  Refills the fetch window around `pc` and returns the byte there.
+ *  Slow path of `cpu_fetch_pc`.
+ */
+uint8_t cpu_fetch_refill(cpu_context_t *context, addr_t pc);
+
+/**
+ *  Fetches the byte at PC and increments PC. Reads straight from host
+ *  memory while PC stays inside the fetch window.
+ */
+static inline uint8_t cpu_fetch_pc(cpu_context_t *context)
+{
+#if CPU_CYCLE_ACCURATE
+    cpu_mcycle(context);
+#endif
+    addr_t pc = context->pc++;
+    uint32_t offset = (addr_t) (pc - context->fetch.start);
+
+    if (offset < context->fetch.size){
+        return context->fetch.mem[offset];
+    }
+    return cpu_fetch_refill(context, pc);
+}
+
+/**
+ *  Returns the byte at PC without moving PC.
+ */
+static inline uint8_t cpu_peek_pc(cpu_context_t *context)
+{
+    uint32_t offset = (addr_t) (context->pc - context->fetch.start);
+
+    if (offset < context->fetch.size){
+        return context->fetch.mem[offset];
+    }
+    return bus_read(CPU_INSTANCE(context), context->pc);
+}
+
+/*
+    Timing of the instruction handlers, specialized at compile time.
+
+    - CPU_READ/CPU_WRITE: memory access by the CPU.
+    - CPU_INTERNAL: M-cycle without a memory access, where it delays the
+      accesses that follow (e.g. before the pushes of CALL).
+    - CPU_ADD_CYCLES: end of an instruction taking `n` M-cycles in total.
+
+    The fast core only counts cycles, the accurate core ticks one M-cycle
+    per access and the remaining ones at the end. Tracing builds also log
+    every CPU_READ/CPU_WRITE.
+*/
+#if CPU_CYCLE_ACCURATE
+
+static inline uint8_t cpu_timed_read(cpu_context_t *context, addr_t addr)
+{
+    cpu_mcycle(context);
+    return bus_read(CPU_INSTANCE(context), addr);
+}
+
+static inline error_code_t cpu_timed_write(cpu_context_t *context, addr_t addr, uint8_t value)
+{
+    cpu_mcycle(context);
+    return bus_write(CPU_INSTANCE(context), addr, value);
+}
+
+#define CPU_BUS_READ(context, addr)         cpu_timed_read((context), (addr))
+#define CPU_BUS_WRITE(context, addr, value) cpu_timed_write((context), (addr), (value))
+#define CPU_INTERNAL(context)               cpu_mcycle(context)
+#define CPU_ADD_CYCLES(context, n)          cpu_finish_instr((context), (n))
+
+#else
+
+#define CPU_BUS_READ(context, addr)         bus_read(CPU_INSTANCE(context), (addr))
+#define CPU_BUS_WRITE(context, addr, value) bus_write(CPU_INSTANCE(context), (addr), (value))
+#define CPU_INTERNAL(context)               ((void) 0)
+#define CPU_ADD_CYCLES(context, n)          ((context)->cycles += (n))
+
+#endif // CPU_CYCLE_ACCURATE
+
+#if CPU_TRACER
+
+static inline uint8_t cpu_traced_read(cpu_context_t *context, addr_t addr)
+{
+    uint8_t value = CPU_BUS_READ(context, addr);
+    tracer_on_access(CPU_INSTANCE(context), addr, value, TRACER_ACCESS_READ);
+    return value;
+}
+
+static inline error_code_t cpu_traced_write(cpu_context_t *context, addr_t addr, uint8_t value)
+{
+    tracer_on_access(CPU_INSTANCE(context), addr, value, TRACER_ACCESS_WRITE);
+    return CPU_BUS_WRITE(context, addr, value);
+}
+
+#define CPU_READ(context, addr)             cpu_traced_read((context), (addr))
+#define CPU_WRITE(context, addr, value)     cpu_traced_write((context), (addr), (value))
+
+#else
+
+#define CPU_READ(context, addr)             CPU_BUS_READ(context, addr)
+#define CPU_WRITE(context, addr, value)     CPU_BUS_WRITE(context, addr, value)
+
+#endif // CPU_TRACER
+
+/**
+ *  Notifies the CPU of an MBC ROM bank switch, so cached code and the
+ *  fetch window can be dropped.
+ */
+void cpu_on_bank_switch(gb_instance_t *gb, uint16_t rom_bank);
 
 void cpu_ei();
 void cpu_di();
 
+#if CPU_PAIR_PROFILE
+/**
+ *  Writes the opcode pair counts of `gb` to `path`, one `<first> <second> <count>`
+ *  line (hex opcodes) per pair seen. Input of `gen_optable.py --pair-profile`.
+ *  Returns false if the file can't be written.
+ */
+bool cpu_pair_profile_write(gb_instance_t *gb, const char *path);
+#endif
+
 #endif // CPU_H
\ No newline at end of file
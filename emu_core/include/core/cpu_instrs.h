@@ -1,3 +1,6 @@
+#ifndef CPU_INSTRS_H
+#define CPU_INSTRS_H
+
 #include <core/cpu.h>
 
 /**
@@ -5,6 +8,50 @@
  */
 typedef void (*INSTR_FUNC)(cpu_context_t * context, uint8_t opcode);
 
+/*
+    Build-time dispatch selection. When enabled, the CPU runs batches of
+    instructions through the generated threaded interpreter (`dispatch.h`)
+    instead of one call through `optable` per instruction.
+*/
+#ifndef CPU_THREADED_DISPATCH
+#define CPU_THREADED_DISPATCH       1
+#endif
+
+/*
+    When enabled, dispatch goes through one generated handler per opcode
+    (`spec_handlers.h`) with its operands decoded at generation time.
+    Turn off to save flash on the MCU build.
+*/
+#ifndef CPU_SPECIALIZED_HANDLERS
+#define CPU_SPECIALIZED_HANDLERS    1
+#endif
+
+/*
+    Generated tables, defined in `optable.h` (see py_scripts/gen_optable.py).
+    Only cpu_instrs.c includes `optable.h`, everyone else goes through these.
+*/
+extern INSTR_FUNC optable[256];
+extern INSTR_FUNC prefix_optable[256];
+
+#if CPU_SPECIALIZED_HANDLERS
+extern INSTR_FUNC spec_optable[256];
+extern INSTR_FUNC spec_prefix_optable[256];
+
+/* Tables used for dispatch */
+#define CPU_OPTABLE                 spec_optable
+#define CPU_PREFIX_OPTABLE          spec_prefix_optable
+#else
+#define CPU_OPTABLE                 optable
+#define CPU_PREFIX_OPTABLE          prefix_optable
+#endif
+
+/* Instruction length in bytes, including immediates */
+extern const uint8_t opcode_lengths[256];
+
+/* Base M-cycles of each instruction (conditional branches not taken) */
+extern const uint8_t opcode_cycles[256];
+extern const uint8_t prefix_opcode_cycles[256];
+
 /** 
  *  Instructions for the CPU. 
  *  
@@ -83,4 +130,16 @@ void instr_res_b3_r8  (cpu_context_t *context, uint8_t opcode);
 void instr_set_b3_r8  (cpu_context_t *context, uint8_t opcode);
 
 /* Instruction not implmented, just panic */
-void instr_unimplemented    (cpu_context_t *context, uint8_t opcode);
\ No newline at end of file
+void instr_unimplemented    (cpu_context_t *context, uint8_t opcode);
+
+#if CPU_THREADED_DISPATCH
+/**
+ *  Runs instructions without returning until `context->deadline` (generated in
+ *  `dispatch.h`), going past it by a single instruction at most. Returns early
+ *  after an instruction that changes interrupt state (EI, DI, RETI) or stops
+ *  the CPU (HALT, STOP).
+ */
+void cpu_run_batch(cpu_context_t *context);
+#endif
+
+#endif // CPU_INSTRS_H
@@ -4,10 +4,13 @@
 #include <common.h>
 #include <master_slave.h>
 
-#define INTERRUPT_REG_VBLANK_BITMASK      0x1
-#define INTERRUPT_REG_TIMER_BITMASK       0x2
-#define INTERRUPT_REG_SERIAL_BITMASK      0x4
-#define INTERRUPT_REG_JOYPAD_BITMASK      0x8
+/* Bit positions follow `interrupt_type_t`, lowest bit has the highest priority */
+#define INTERRUPT_REG_VBLANK_BITMASK      0x01
+#define INTERRUPT_REG_STAT_BITMASK        0x02
+#define INTERRUPT_REG_TIMER_BITMASK       0x04
+#define INTERRUPT_REG_SERIAL_BITMASK      0x08
+#define INTERRUPT_REG_JOYPAD_BITMASK      0x10
+#define INTERRUPT_REG_ALL_BITMASK         0x1F
 
 typedef enum interrupt_type {
     INTERRUPT_TYPE_VBLANK,
@@ -20,40 +23,77 @@ typedef enum interrupt_type {
     INTERRUPT_TYPE_COUNT
 } interrupt_type_t;
 
-addr_t interrupt_vector_addrs[INTERRUPT_TYPE_COUNT] = {
-    [INTERRUPT_TYPE_VBLANK]         = 0x40,
-    [INTERRUPT_TYPE_STAT]           = 0x48,
-    [INTERRUPT_TYPE_TIMER]          = 0x50,
-    [INTERRUPT_TYPE_SERIAL]         = 0x58,
-    [INTERRUPT_TYPE_JOYPAD]         = 0x60,
-    [INTERRUPT_TYPE_UNKNOWN]        = 0x0,
-    [INTERRUPT_TYPE_NONE]           = 0x0
-};
+typedef struct interrupt_context {
+    uint8_t ie_reg;
+    uint8_t if_reg;
+    uint8_t ime;
+
+    /*
+        IE & IF, and the same masked by IME. Updated on every change, so
+        the CPU can test `serviceable` with a single load before each run
+        of instructions.
+    */
+    uint8_t pending;
+    uint8_t serviceable;
+
+    master_slave_conn_t interrupt_ie_ms_conn;
+    master_slave_conn_t interrupt_if_ms_conn;
+} interrupt_context_t;
+
+/**
+ *  IE and IF, as saved in snapshots. IME belongs to the CPU state.
+ */
+typedef struct interrupt_state {
+    uint8_t ie_reg;
+    uint8_t if_reg;
+} interrupt_state_t;
 
 /**
  *  Initializes the interrupt module.
  */
-void interrupt_init();
+void interrupt_init(gb_instance_t *gb);
+
+/**
+ *  Copies IE and IF into `state`.
+ */
+void interrupt_save_state(gb_instance_t *gb, interrupt_state_t *state);
+
+/**
+ *  Restores IE and IF from `state`.
+ */
+void interrupt_load_state(gb_instance_t *gb, const interrupt_state_t *state);
 
 /**
  *  Called by devices (PPU, Timer, Serial Comm, or Joypad)
  *  Sets the interrupt bit to HIGH for the interrrupt.
  */
-void interrupt_set_flag(interrupt_type_t interrupt_type);
+void interrupt_set_flag(gb_instance_t *gb, interrupt_type_t interrupt_type);
 
 
 /**
  *  Called by devices (PPU, Timer, Serial Comm, or Joypad)
  *  Clears the interrupt bit to LOW for the interrrupt.
  */
-void interrupt_clear_flag(interrupt_type_t interrupt_type);
+void interrupt_clear_flag(gb_instance_t *gb, interrupt_type_t interrupt_type);
 
 /**
  *  Get the top priority interrupt to service.
  *  The top priority interrupt is the enabled interrupt that has
- *  the lowest bit position
+ *  the lowest bit position. Returns INTERRUPT_TYPE_NONE if IME is cleared.
+ */
+interrupt_type_t interrupt_get_top(gb_instance_t *gb);
+
+/**
+ *  Mirrors the CPU's IME flag, must be called on every change (EI, DI, RETI,
+ *  interrupt dispatch) to keep the serviceable word up to date.
+ */
+void interrupt_set_ime(gb_instance_t *gb, uint8_t ime);
+
+/**
+ *  Returns the interrupts that are both requested and enabled (IF & IE),
+ *  regardless of IME. Used to wake the CPU from HALT/STOP.
  */
-interrupt_type_t interrupt_get_top(uint8_t ime);
+uint8_t interrupt_get_pending(gb_instance_t *gb);
 
 /**
  *  Gets the interrupt vector corresponding to the interrupt type.
@@ -64,11 +104,11 @@ addr_t interrupt_get_vector_addr(interrupt_type_t interrupt_type);
 /**
  *  Returns a master slave connection to the interrupt IE register.
  */
-master_slave_conn_t *interrupt_get_ie_ms_connection();
+master_slave_conn_t *interrupt_get_ie_ms_connection(gb_instance_t *gb);
 
 /**
  *  Returns a master slave connection to the interrupt IF register.
  */
-master_slave_conn_t *interrupt_get_if_ms_connection();
+master_slave_conn_t *interrupt_get_if_ms_connection(gb_instance_t *gb);
 
 #endif // INTERRUPT_H
\ No newline at end of file
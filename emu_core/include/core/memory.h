@@ -0,0 +1,66 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+/**
+ *  Plain internal memory of the GameBoy (WRAM, VRAM, OAM, HRAM).
+ *  All regions are exposed to the bus as direct host memory.
+ */
+
+#include <common.h>
+#include <master_slave.h>
+#include <core/memorymap.h>
+
+#define WRAM_SIZE       (WRAM2_END - WRAM1_BASE + 1)
+#define VRAM_SIZE       (VRAM_END - VRAM_BASE + 1)
+#define OAM_SIZE        (OAM_END - OAM_BASE + 1)
+#define HRAM_SIZE       (HIGH_RAM_END - HIGH_RAM_BASE + 1)
+
+typedef enum memory_region {
+    MEMORY_REGION_WRAM,
+    MEMORY_REGION_ECHO,
+    MEMORY_REGION_VRAM,
+    MEMORY_REGION_OAM,
+    MEMORY_REGION_HRAM,
+    MEMORY_REGION_COUNT
+} memory_region_t;
+
+typedef struct memory_context {
+    uint8_t wram[WRAM_SIZE];
+    uint8_t vram[VRAM_SIZE];
+    uint8_t oam[OAM_SIZE];
+    uint8_t hram[HRAM_SIZE];
+    master_slave_conn_t ms_conns[MEMORY_REGION_COUNT];
+} memory_context_t;
+
+/**
+ *  Contents of every region, as saved in snapshots.
+ */
+typedef struct memory_state {
+    uint8_t wram[WRAM_SIZE];
+    uint8_t vram[VRAM_SIZE];
+    uint8_t oam[OAM_SIZE];
+    uint8_t hram[HRAM_SIZE];
+} memory_state_t;
+
+/**
+ *  Initializes the internal memory module.
+ */
+void memory_init(gb_instance_t *gb);
+
+/**
+ *  Copies every region into `state`.
+ */
+void memory_save_state(gb_instance_t *gb, memory_state_t *state);
+
+/**
+ *  Restores every region from `state`. Bypasses the bus, so write
+ *  watchers are not notified.
+ */
+void memory_load_state(gb_instance_t *gb, const memory_state_t *state);
+
+/**
+ *  Returns a master slave connection to the memory region.
+ */
+master_slave_conn_t *memory_get_ms_connection(gb_instance_t *gb, memory_region_t region);
+
+#endif // MEMORY_H
@@ -0,0 +1,157 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/**
+ *  Execution profiler.
+ *
+ *  Counts executions and M-cycles per opcode, per (ROM bank, PC) and per
+ *  call stack, following CALL/RST/interrupts and RET/RETI. Addresses are
+ *  attributed to ROM routines with an RGBDS .sym file, and call stacks are
+ *  written in the folded format flamegraph tools take.
+ *
+ *  Compiled out unless CPU_PROFILER is set, the hooks then expand to nothing.
+ *  Profiling builds single step every instruction. Each instance has its
+ *  own profiler (and symbols), reset by `cpu_init`.
+ */
+
+#include <common.h>
+
+#ifndef CPU_PROFILER
+#define CPU_PROFILER                0
+#endif
+
+/* Slots in the (bank, PC) hash table, must be a power of two */
+#define PROFILER_PC_ENTRIES         (1u << 16)
+
+/* Nodes of the call tree, one per distinct call stack */
+#define PROFILER_MAX_NODES          (1u << 14)
+
+/* Deeper calls are attributed to the deepest tracked routine */
+#define PROFILER_MAX_DEPTH          64
+
+#define PROFILER_MAX_SYMBOLS        16384
+#define PROFILER_SYMBOL_LEN         64
+
+#if CPU_PROFILER
+
+typedef struct profiler_counter {
+    uint64_t count;
+    uint64_t cycles;
+} profiler_counter_t;
+
+typedef struct profiler_pc_entry {
+    /* Key + 1, 0 for an empty slot */
+    uint32_t key;
+    profiler_counter_t counter;
+} profiler_pc_entry_t;
+
+/**
+ *  Node of the call tree, one per distinct call stack.
+ */
+typedef struct profiler_node {
+    /* Routine entry */
+    uint32_t key;
+
+    int parent;
+    int first_child;
+    int next_sibling;
+
+    /* Self cycles, spent in this routine with this exact stack */
+    uint64_t cycles;
+
+} profiler_node_t;
+
+typedef struct profiler_symbol {
+    uint32_t key;
+    char name[PROFILER_SYMBOL_LEN];
+} profiler_symbol_t;
+
+typedef struct profiler {
+    /* Main page, then the CB page */
+    profiler_counter_t opcodes[512];
+
+    profiler_pc_entry_t pcs[PROFILER_PC_ENTRIES];
+    uint64_t dropped_pcs;
+
+    /* Used entries of `pcs`, sorted for the report */
+    const profiler_pc_entry_t *pc_order[PROFILER_PC_ENTRIES];
+
+    profiler_node_t nodes[PROFILER_MAX_NODES];
+    unsigned nodes_size;
+    int current_node;
+    unsigned depth;
+
+    /* Node the running instruction started in */
+    int instr_node;
+
+    /* Calls not tracked (too deep, tree full), popped first on return */
+    unsigned untracked_depth;
+
+    /* Sorted by key */
+    profiler_symbol_t symbols[PROFILER_MAX_SYMBOLS];
+    unsigned symbols_size;
+
+} profiler_t;
+
+
+/**
+ *  Clears every counter and the call stack of `gb`. Symbols are kept.
+ */
+void profiler_init(gb_instance_t *gb);
+
+/**
+ *  To be called before running an instruction. Its cycles go to the
+ *  routine it started in, even if it calls or returns.
+ */
+void profiler_on_instr_start(gb_instance_t *gb);
+
+/**
+ *  Records one executed instruction at `pc`, taking `cycles` M-cycles.
+ *  `cb_opcode` is only used when `opcode` is the CB prefix.
+ */
+void profiler_on_instr(gb_instance_t *gb, addr_t pc, uint8_t opcode, uint8_t cb_opcode, m_cycle_t cycles);
+
+/**
+ *  Enters the routine at `target` (CALL, RST, interrupt dispatch).
+ */
+void profiler_on_call(gb_instance_t *gb, addr_t target);
+
+/**
+ *  Returns from the current routine (RET, RETI). Returns without a
+ *  matching call (e.g. stack tricks) are ignored.
+ */
+void profiler_on_ret(gb_instance_t *gb);
+
+/**
+ *  Current CALL/RET nesting depth.
+ */
+unsigned profiler_get_call_depth(gb_instance_t *gb);
+
+/**
+ *  Loads symbols from an RGBDS .sym file (`BB:AAAA Label` lines).
+ *  Returns false if the file can't be read.
+ */
+bool profiler_load_sym(gb_instance_t *gb, const char *path);
+
+/**
+ *  Writes the per-opcode and per-(bank, PC) tables, hottest first.
+ */
+bool profiler_write_report(gb_instance_t *gb, const char *path);
+
+/**
+ *  Writes one `frame;frame;frame cycles` line per call stack, for
+ *  flamegraph.pl, speedscope and the like.
+ */
+bool profiler_write_folded(gb_instance_t *gb, const char *path);
+
+#define PROFILER_CALL(gb, target)   profiler_on_call((gb), (target))
+#define PROFILER_RET(gb)            profiler_on_ret(gb)
+
+#else
+
+#define PROFILER_CALL(gb, target)   ((void) 0)
+#define PROFILER_RET(gb)            ((void) 0)
+
+#endif // CPU_PROFILER
+
+#endif // PROFILER_H
@@ -0,0 +1,79 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+/**
+ *  Serial port (SB/SC). Only the internal clock is emulated, with nothing
+ *  on the other end of the link: every byte sent shifts in 0xFF.
+ *
+ *  Bytes sent are handed to the output hook, which is how test ROMs
+ *  (e.g. Blargg's) report their results.
+ */
+
+#include <common.h>
+#include <master_slave.h>
+
+#define SERIAL_SB_ADDR              0xFF01
+#define SERIAL_SC_ADDR              0xFF02
+
+#define SERIAL_SC_TRANSFER          0x80
+#define SERIAL_SC_INTERNAL_CLOCK    0x01
+
+/* 8 bits at 8192 Hz */
+#define SERIAL_TRANSFER_CYCLES      1024
+
+/* Called with every byte sent, when its transfer completes */
+typedef void (*serial_output_hook_t)(gb_instance_t *gb, uint8_t value);
+
+typedef struct serial_context {
+    uint8_t sb;
+    uint8_t sc;
+
+    /* Cycle the transfer in flight ends at, 0 when idle */
+    m_cycle_t transfer_end;
+
+    /* A transfer end event is queued, at most one is */
+    bool event_pending;
+
+    serial_output_hook_t output_hook;
+
+    master_slave_conn_t serial_ms_conn;
+} serial_context_t;
+
+/**
+ *  SB, SC and the end of the transfer in flight (0 if none), as saved in
+ *  snapshots.
+ */
+typedef struct serial_state {
+    uint64_t transfer_end;
+    uint8_t sb;
+    uint8_t sc;
+    uint8_t reserved[6];
+} serial_state_t;
+
+/**
+ *  Initializes the serial module.
+ */
+void serial_init(gb_instance_t *gb);
+
+/**
+ *  Copies SB and SC into `state`.
+ */
+void serial_save_state(gb_instance_t *gb, serial_state_t *state);
+
+/**
+ *  Restores SB and SC from `state`, and schedules the end of the transfer
+ *  in flight. The event queue must have been emptied first.
+ */
+void serial_load_state(gb_instance_t *gb, const serial_state_t *state);
+
+/**
+ *  Sets the function notified of every byte sent, NULL to drop them.
+ */
+void serial_set_output_hook(gb_instance_t *gb, serial_output_hook_t hook);
+
+/**
+ *  Returns a master slave connection to SB and SC.
+ */
+master_slave_conn_t *serial_get_ms_connection(gb_instance_t *gb);
+
+#endif // SERIAL_H
@@ -0,0 +1,143 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+/**
+ *  Binary instruction tracer.
+ *
+ *  Logs the registers, PC and the 4 bytes at PC before every instruction,
+ *  plus the data reads and writes it makes, to a compact delta-encoded
+ *  stream. Records go through a lock-free ring to a writer thread that
+ *  flushes them to disk, so the emulation thread never waits on I/O unless
+ *  the ring is full. `py_scripts/trace_expand.py` turns a trace into
+ *  gameboy-doctor text.
+ *
+ *  Compiled out unless CPU_TRACER is set, the hooks then expand to nothing.
+ *  Tracing builds single step every instruction. Host builds only (pthreads).
+ *  Each instance has its own tracer, writer thread and file.
+ *
+ *  Stream layout, little endian:
+ *      header  "GBTR", u8 version
+ *      record  u8 regs mask    bit n: register n of A F B C D E H L follows
+ *              u8 flags        TRACER_REC_* bits
+ *              u8 regs[]       changed registers, in mask order
+ *              u16 sp          if TRACER_REC_SP
+ *              i8/u16 pc       delta from the previous PC, or absolute
+ *              u8 pcmem[]      bytes at PC+0..3 marked in TRACER_REC_PCMEM,
+ *                              the others are the last ones seen there
+ *              u8 count        if TRACER_REC_ACCESSES, then per access:
+ *              u8 kind, u16 addr, u8 value
+ */
+
+#include <common.h>
+
+#ifndef CPU_TRACER
+#define CPU_TRACER                  0
+#endif
+
+/* Bytes of the ring between the CPU and the writer, must be a power of two */
+#ifndef TRACER_RING_SIZE
+#define TRACER_RING_SIZE            (1u << 22)
+#endif
+
+#define TRACER_MAGIC                "GBTR"
+#define TRACER_VERSION              1
+
+/* Record flags */
+#define TRACER_REC_SP               0x01
+#define TRACER_REC_PC_DELTA         0x02
+#define TRACER_REC_PC_FULL          0x04
+#define TRACER_REC_ACCESSES         0x08
+#define TRACER_REC_PCMEM_SHIFT      4
+#define TRACER_REC_PCMEM            (0xF << TRACER_REC_PCMEM_SHIFT)
+
+/* Access kinds */
+#define TRACER_ACCESS_READ          0
+#define TRACER_ACCESS_WRITE         1
+
+/* Accesses logged per instruction, the rest are counted as dropped */
+#define TRACER_MAX_ACCESSES         8
+
+#if CPU_TRACER
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+/* Longest record: masks, 8 registers, SP, PC, PC bytes, access count */
+#define TRACER_HEADER_MAX           (2 + 8 + 2 + 2 + 4)
+#define TRACER_ACCESS_SIZE          4
+
+typedef struct tracer {
+    FILE *file;
+    pthread_t writer;
+    bool started;
+
+    /*
+        Single producer (CPU), single consumer (writer) ring. Both indices
+        run freely and are masked on access, head - tail bytes are pending.
+    */
+    uint8_t ring[TRACER_RING_SIZE];
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    atomic_bool stopping;
+
+    /* Set by the writer, read once it's joined */
+    bool write_error;
+
+    /* Record of the running instruction, pushed when the next one starts */
+    uint8_t header[TRACER_HEADER_MAX];
+    unsigned header_size;
+    uint8_t accesses[1 + TRACER_MAX_ACCESSES * TRACER_ACCESS_SIZE];
+    unsigned access_count;
+    bool has_record;
+
+    /* State of the previous record, deltas are taken against it */
+    bool has_prev;
+    uint8_t regs[8];
+    uint16_t sp;
+    uint16_t pc;
+
+    /* Last byte seen at each address, for the PC bytes */
+    uint8_t shadow[0x10000];
+
+    uint64_t dropped_accesses;
+
+} tracer_t;
+
+/**
+ *  Opens `path` and starts the writer thread tracing `gb`.
+ *  Returns false if the file can't be created or the thread started.
+ */
+bool tracer_start(gb_instance_t *gb, const char *path);
+
+/**
+ *  Flushes everything logged so far, stops the writer and closes the file.
+ *  Returns false on a write error.
+ */
+bool tracer_stop(gb_instance_t *gb);
+
+/**
+ *  Logs the state before running the instruction at PC. Accesses that
+ *  follow, up to the next call, belong to this instruction.
+ */
+void tracer_on_instr(gb_instance_t *gb);
+
+/**
+ *  Logs a data read or write by the CPU.
+ */
+void tracer_on_access(gb_instance_t *gb, addr_t addr, uint8_t value, uint8_t kind);
+
+/**
+ *  Accesses not logged because an instruction made too many.
+ */
+uint64_t tracer_get_dropped_accesses(gb_instance_t *gb);
+
+#define TRACER_ACCESS(gb, addr, value, kind)    tracer_on_access((gb), (addr), (value), (kind))
+
+#else
+
+#define TRACER_ACCESS(gb, addr, value, kind)    ((void) 0)
+
+#endif // CPU_TRACER
+
+#endif // TRACER_H
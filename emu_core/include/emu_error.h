@@ -7,6 +7,10 @@ typedef enum error_code {
     STATUS_SEG_FAULT,
     STATUS_EMPTY_CONTAINER,
     STATUS_FULL_CONTAINER,
+    STATUS_BUS_CONFLICT,
+    STATUS_ILLEGAL_INSTRUCTION,
+    STATUS_IO_ERROR,
+    STATUS_INVALID_FORMAT,
 } error_code_t;
 
 
@@ -2,6 +2,22 @@
 #define EMULATOR_H
 
 #include <common.h>
+#include <core/cpu.h>
+#include <core/interrupt.h>
+#include <core/memory.h>
+#include <core/serial.h>
+#include <core/cartridge/cart.h>
+
+/*
+    Start `emulator_init` from the state the DMG boot ROM leaves behind,
+    at the cartridge entry point, instead of PC 0.
+*/
+#ifndef EMULATOR_FAST_BOOT
+#define EMULATOR_FAST_BOOT          1
+#endif
+
+/* M-cycles per frame, 154 lines of 114 */
+#define EMULATOR_FRAME_CYCLES       17556
 
 /*  
     Defines the emulator context
@@ -35,11 +51,75 @@ typedef struct emulator {
 } emulator_ctx_t;
 
 
+/**
+ *  Whole machine state, the ROM aside. Plain data of fixed size with no
+ *  host pointers, saved and restored between `emulator_run` calls.
+ *  Devices keep the timestamps of their pending events in their state,
+ *  and schedule them again when loaded.
+ */
+typedef struct emulator_state {
+    uint64_t global_tick;
+    cpu_state_t cpu;
+    serial_state_t serial;
+    interrupt_state_t interrupt;
+    cart_state_t cart;
+    memory_state_t memory;
+} emulator_state_t;
+
 /*  
     Boots up emulator.
 */
 void boot();
 
+/**
+ *  Allocates a zeroed instance, aligned to a cache line.
+ *  Returns NULL when out of memory.
+ */
+gb_instance_t *emulator_create();
+
+/**
+ *  Frees an instance from `emulator_create`.
+ */
+void emulator_destroy(gb_instance_t *gb);
+
+/**
+ *  Initializes every device of a zeroed instance and hooks them to the
+ *  bus. `rom` is used in place, read only, and must outlive the instance.
+ *  Instances may share the same ROM.
+ */
+void emulator_init(gb_instance_t *gb, uint8_t *rom, size_t rom_size);
+
+/**
+ *  Puts the machine in the DMG post-boot state: registers and I/O as the
+ *  boot ROM leaves them, the logo in VRAM, PC at 0x0100. Done by
+ *  `emulator_init` when EMULATOR_FAST_BOOT is set.
+ */
+void emulator_fast_boot(gb_instance_t *gb);
+
+/**
+ *  Runs the CPU and due device events for `cycles` M-cycles.
+ *  May overshoot by the length of one instruction.
+ *
+ *  Returns the number of M-cycles actually run.
+ */
+m_cycle_t emulator_run(gb_instance_t *gb, m_cycle_t cycles);
+
+/**
+ *  Runs one frame, then takes the rewind snapshot if one is due.
+ *  Returns the number of M-cycles actually run.
+ */
+m_cycle_t emulator_run_frame(gb_instance_t *gb);
+
+/**
+ *  Copies the machine state into `state`.
+ */
+void emulator_save_state(gb_instance_t *gb, emulator_state_t *state);
+
+/**
+ *  Restores the machine state from `state`.
+ */
+void emulator_load_state(gb_instance_t *gb, const emulator_state_t *state);
+
 
 
 #endif // EMULATOR_H
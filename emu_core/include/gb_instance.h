@@ -0,0 +1,85 @@
+#ifndef GB_INSTANCE_H
+#define GB_INSTANCE_H
+
+/**
+ *  One emulated machine. Every module keeps its state in here and works on
+ *  the instance it is given, so instances are independent of each other and
+ *  can run on different threads (one thread per instance at a time). They
+ *  can share the same ROM buffer.
+ *
+ *  The whole machine is a single block, from `emulator_create` or declared
+ *  statically on targets without a heap. The state touched by every
+ *  instruction comes first: the CPU, interrupt and event words in a few
+ *  cache lines, then the bus page table (10 KB, of which each access
+ *  touches one entry). Memory, caches and setup come after.
+ *
+ *  An instance can't be copied (memcpy, assignment): the event queue, the
+ *  bus connections and the page table point into the instance itself.
+ *  Copy machines through savestates instead.
+ */
+
+#include <common.h>
+#include <schedule.h>
+#include <rewind.h>
+#include <core/cpu.h>
+#include <core/bus.h>
+#include <core/interrupt.h>
+#include <core/memory.h>
+#include <core/serial.h>
+#include <core/block_cache.h>
+#include <core/profiler.h>
+#include <core/tracer.h>
+#include <core/cartridge/cart.h>
+
+#define GB_CACHE_LINE_SIZE          64
+
+/* Size of the hot scalars, everything before the bus page table */
+#define GB_HOT_SCALARS_SIZE         (10 * GB_CACHE_LINE_SIZE)
+
+struct gb_instance {
+    /* Hot: registers, interrupt words, next event, then the page table */
+
+    /* Must come first, see `CPU_INSTANCE` */
+    cpu_context_t cpu;
+    cpu_idle_loop_t idle_loop;
+    interrupt_context_t interrupt;
+    uint64_t global_tick;
+    schedule_context_t schedule;
+    bus_context_t bus;
+
+    /* Cold: connections, memory contents, cartridge, caches */
+    _Alignas(GB_CACHE_LINE_SIZE) bus_setup_t bus_setup;
+    memory_context_t memory;
+    cart_context_t cart;
+    serial_context_t serial;
+
+#if CPU_BLOCK_CACHE_ENABLED
+    block_cache_t block_cache;
+#endif
+
+#if REWIND_ENABLED
+    rewind_context_t rewind;
+#endif
+
+#if CPU_PAIR_PROFILE
+    cpu_pair_profile_t pair_profile;
+#endif
+
+#if CPU_PROFILER
+    profiler_t profiler;
+#endif
+
+#if CPU_TRACER
+    tracer_t tracer;
+#endif
+
+    /* Left to the host, e.g. to find its own state from the hooks */
+    void *user_data;
+};
+
+_Static_assert(offsetof(gb_instance_t, cpu) == 0, "The CPU context must be the first member");
+_Static_assert(offsetof(gb_instance_t, bus) <= GB_HOT_SCALARS_SIZE, "Hot scalars outgrew their cache lines");
+_Static_assert(offsetof(gb_instance_t, bus_setup) - offsetof(gb_instance_t, bus)
+               < sizeof(bus_context_t) + GB_CACHE_LINE_SIZE, "Only the page table follows the hot scalars");
+
+#endif // GB_INSTANCE_H
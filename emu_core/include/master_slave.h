@@ -30,6 +30,15 @@ typedef struct master_slave_conn
     error_code_t (*slave_read)(void *context, addr_t addr, uint8_t *read_val);
     error_code_t (*slave_write)(void *context, addr_t addr, uint8_t value);
 
+    /*
+        Optional host memory backing the region, indexed by (addr - start_addr).
+        When set, the bus reads/writes the buffer directly instead of calling
+        the slave functions. Leave NULL for regions with side effects
+        (I/O registers, MBC control writes into ROM, etc).
+    */
+    const uint8_t *direct_read;
+    uint8_t *direct_write;
+
 } master_slave_conn_t;
 
 /**
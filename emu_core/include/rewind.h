@@ -0,0 +1,124 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+/**
+ *  Rewind buffer: snapshots of the machine state taken every few frames.
+ *
+ *  The newest snapshot is kept whole. Older ones are stored as the XOR of
+ *  each snapshot with the one after it, run-length encoded, in a ring of
+ *  fixed size. Stepping back XORs the newest delta into the whole
+ *  snapshot, so the oldest deltas can be dropped freely when the ring is
+ *  full.
+ *
+ *  The buffer is part of the instance, bounded by REWIND_MEMORY_CAP. A
+ *  snapshot costs one copy of the state, one XOR/RLE pass over it, and its delta
+ *  (a few hundred bytes when little memory changed).
+ */
+
+#include <common.h>
+#include <emu_error.h>
+#include <emulator.h>
+
+/*
+    Gives every instance a rewind buffer, snapshot from `emulator_loop`
+    once every REWIND_INTERVAL_FRAMES frames.
+*/
+#ifndef REWIND_ENABLED
+#define REWIND_ENABLED              0
+#endif
+
+#ifndef REWIND_INTERVAL_FRAMES
+#define REWIND_INTERVAL_FRAMES      4
+#endif
+
+/* Total memory used by the rewind buffer, in bytes */
+#ifndef REWIND_MEMORY_CAP
+#define REWIND_MEMORY_CAP           (2u * 1024u * 1024u)
+#endif
+
+/* Most snapshots kept, whatever their size */
+#ifndef REWIND_MAX_SNAPSHOTS
+#define REWIND_MAX_SNAPSHOTS        4096
+#endif
+
+#define REWIND_STATE_SIZE           sizeof(emulator_state_t)
+
+/*
+    Largest encoded delta. Tokens are (zero run, literal length, literals),
+    and every token but the last covers at least REWIND_MIN_ZERO_RUN + 1
+    bytes, with two varints of at most 3 bytes (sizes < 2 MiB).
+*/
+#define REWIND_MIN_ZERO_RUN         4
+#define REWIND_DELTA_MAX_SIZE       (REWIND_STATE_SIZE + 6 * (REWIND_STATE_SIZE / (REWIND_MIN_ZERO_RUN + 1) + 1))
+
+/**
+ *  Location of one delta in the ring.
+ */
+typedef struct rewind_entry {
+    uint32_t offset;
+    uint32_t size;
+} rewind_entry_t;
+
+/* Ring of encoded deltas, what's left of the cap after the fixed buffers */
+#define REWIND_FIXED_SIZE \
+    (2 * REWIND_STATE_SIZE + REWIND_DELTA_MAX_SIZE + REWIND_MAX_SNAPSHOTS * sizeof(rewind_entry_t))
+#define REWIND_RING_SIZE            (REWIND_MEMORY_CAP - REWIND_FIXED_SIZE)
+
+typedef struct rewind_context {
+    /* Newest snapshot, whole, and the buffer the next one is taken into */
+    emulator_state_t *head;
+    emulator_state_t *scratch;
+    bool head_valid;
+
+    unsigned interval_frames;
+    unsigned frame_count;
+
+    /* Deltas, oldest at `entries[first]`, each turns a snapshot into the one before */
+    rewind_entry_t entries[REWIND_MAX_SNAPSHOTS];
+    unsigned first;
+    unsigned count;
+
+    /* End of the newest delta in `ring` */
+    uint32_t ring_end;
+    size_t delta_bytes;
+
+    emulator_state_t states[2];
+    uint8_t encoded[REWIND_DELTA_MAX_SIZE];
+    uint8_t ring[REWIND_RING_SIZE];
+} rewind_context_t;
+
+/**
+ *  Empties the buffer. Snapshots are then taken every `interval_frames`
+ *  calls of `rewind_on_frame`.
+ */
+void rewind_init(gb_instance_t *gb, unsigned interval_frames);
+
+/**
+ *  To be called once per frame, takes a snapshot every interval.
+ */
+void rewind_on_frame(gb_instance_t *gb);
+
+/**
+ *  Takes a snapshot now.
+ */
+void rewind_capture(gb_instance_t *gb);
+
+/**
+ *  Goes back to the newest snapshot if the machine ran since, to the one
+ *  before it otherwise. The snapshot stepped over is dropped.
+ *
+ *  Returns STATUS_EMPTY_CONTAINER if there's nothing older to go back to.
+ */
+error_code_t rewind_step_back(gb_instance_t *gb);
+
+/**
+ *  Number of snapshots that can be stepped back to.
+ */
+unsigned rewind_get_count(gb_instance_t *gb);
+
+/**
+ *  Bytes of the ring used by deltas.
+ */
+size_t rewind_get_delta_bytes(gb_instance_t *gb);
+
+#endif // REWIND_H
@@ -0,0 +1,127 @@
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+/**
+ *  Savestate files (host only, uses mmap).
+ *
+ *  A state is a fixed header, a table of sections and the sections, one
+ *  per device. Sections hold the device `xxx_state_t` structs as they are
+ *  in memory (little-endian, fixed-width fields, no pointers), so loading
+ *  is a bounds check and a memcpy. Memory regions (WRAM, VRAM, OAM, HRAM)
+ *  start on a page boundary of the file, so tools can mmap them directly.
+ *
+ *  Layout:
+ *      0x0000  savestate_header_t
+ *      0x0040  savestate_section_t[section_count]
+ *      ...     device sections, 64-byte aligned
+ *      ...     memory sections, SAVESTATE_PAGE_SIZE aligned
+ *
+ *  `version_major` changes break compatibility and are refused, newer
+ *  `version_minor` only add sections, which are skipped. Sections carry
+ *  their own version, a section with an unknown version or size is
+ *  refused. The checksum is the CRC-32 of the whole file, computed with
+ *  the checksum field set to 0.
+ */
+
+#include <common.h>
+#include <emu_error.h>
+
+#define SAVESTATE_MAGIC             "GBSS"
+#define SAVESTATE_VERSION_MAJOR     1
+#define SAVESTATE_VERSION_MINOR     0
+
+#define SAVESTATE_PAGE_SIZE         4096
+#define SAVESTATE_SECTION_ALIGN     64
+
+/* Section ids, four characters read as a little-endian word */
+#define SAVESTATE_FOURCC(a, b, c, d) \
+    ((uint32_t) (a) | ((uint32_t) (b) << 8) | ((uint32_t) (c) << 16) | ((uint32_t) (d) << 24))
+
+#define SAVESTATE_SECTION_EMULATOR  SAVESTATE_FOURCC('E', 'M', 'U', ' ')
+#define SAVESTATE_SECTION_CPU       SAVESTATE_FOURCC('C', 'P', 'U', ' ')
+#define SAVESTATE_SECTION_INTERRUPT SAVESTATE_FOURCC('I', 'N', 'T', ' ')
+#define SAVESTATE_SECTION_SERIAL    SAVESTATE_FOURCC('S', 'E', 'R', ' ')
+#define SAVESTATE_SECTION_CART      SAVESTATE_FOURCC('C', 'A', 'R', 'T')
+#define SAVESTATE_SECTION_WRAM      SAVESTATE_FOURCC('W', 'R', 'A', 'M')
+#define SAVESTATE_SECTION_VRAM      SAVESTATE_FOURCC('V', 'R', 'A', 'M')
+#define SAVESTATE_SECTION_OAM       SAVESTATE_FOURCC('O', 'A', 'M', ' ')
+#define SAVESTATE_SECTION_HRAM      SAVESTATE_FOURCC('H', 'R', 'A', 'M')
+
+typedef struct savestate_header {
+    char magic[4];
+    uint16_t version_major;
+    uint16_t version_minor;
+
+    /* Bytes before the first section: header and section table */
+    uint32_t header_size;
+    uint32_t section_count;
+    uint64_t file_size;
+
+    /* CRC-32 of the file, with this field as 0 */
+    uint32_t checksum;
+    uint32_t flags;
+
+    /* Cartridge the state was saved from */
+    char rom_title[16];
+    uint8_t rom_header_checksum;
+    uint8_t reserved[15];
+} savestate_header_t;
+
+typedef struct savestate_section {
+    uint32_t id;
+    uint32_t version;
+    uint64_t offset;
+    uint64_t size;
+} savestate_section_t;
+
+/**
+ *  Size of a state file of the current machine.
+ */
+size_t savestate_get_size();
+
+/**
+ *  Serializes the machine into `buffer`, of at least `savestate_get_size()`
+ *  bytes. Returns the number of bytes written.
+ */
+size_t savestate_write_buffer(gb_instance_t *gb, uint8_t *buffer, size_t size);
+
+/**
+ *  Checks a serialized state: magic, version, checksum, section bounds
+ *  and cartridge. Returns STATUS_INVALID_FORMAT if anything is off.
+ */
+error_code_t savestate_validate(gb_instance_t *gb, const uint8_t *buffer, size_t size);
+
+/**
+ *  Restores the machine from a serialized state, validated first.
+ *  The machine is left untouched on error.
+ */
+error_code_t savestate_read_buffer(gb_instance_t *gb, const uint8_t *buffer, size_t size);
+
+/**
+ *  Returns the section `id` of a validated state and its size in
+ *  `section_size`, or NULL if there is none.
+ */
+const void *savestate_find_section(const uint8_t *buffer, uint32_t id, size_t *section_size);
+
+/**
+ *  Saves the machine to `path`, through a temporary file renamed over it.
+ */
+error_code_t savestate_save(gb_instance_t *gb, const char *path);
+
+/**
+ *  Restores the machine from `path`, mapped read-only.
+ */
+error_code_t savestate_load(gb_instance_t *gb, const char *path);
+
+/**
+ *  Resumes from the warm snapshot of this cartridge at `path`, if there's
+ *  a valid one. Otherwise runs the freshly booted machine for
+ *  `warmup_cycles` M-cycles, past the boot and intro, and saves the
+ *  snapshot there for the next runs.
+ *
+ *  The machine is warm on return either way, the status is that of
+ *  saving the snapshot when it had to be made.
+ */
+error_code_t savestate_warm_start(gb_instance_t *gb, const char *path, m_cycle_t warmup_cycles);
+
+#endif // SAVESTATE_H
@@ -3,20 +3,47 @@
 
 #include <common.h>
 #include <emu_error.h>
+#include <utils/static_heap.h>
+
+/* Timestamp returned when nothing is scheduled */
+#define SCHEDULE_NO_EVENT       UINT64_MAX
 
 typedef struct device_event_t {
     uint64_t timestamp; 
-    error_code_t(* exec_event)();
+    error_code_t(* exec_event)(gb_instance_t *gb);
 } device_event_t;
 
-device_event_t event_queue[MAX_DEVICE_NUMBER];
+DECL_STATIC_PQUEUE_TYPE(device_event_t)
+
+/**
+ *  Event queue of one instance.
+ */
+typedef struct schedule_context {
+    device_event_t_spqueue_t queue;
+    device_event_t events[MAX_DEVICE_NUMBER];
+} schedule_context_t;
+
+/**
+ *  Empties the event queue.
+ */
+void schedule_init(gb_instance_t *gb);
 
-error_code_t execute_next_event();
+/**
+ *  Pops the earliest event and executes it.
+ *  Returns STATUS_EMPTY_CONTAINER if nothing is scheduled.
+ */
+error_code_t execute_next_event(gb_instance_t *gb);
 
 
 /**
  *  Schedules the next event in the event queue
  */
-void schedule_next_event(device_event_t event);
+void schedule_next_event(gb_instance_t *gb, device_event_t event);
+
+/**
+ *  Timestamp of the earliest scheduled event, or SCHEDULE_NO_EVENT
+ *  if the queue is empty.
+ */
+uint64_t schedule_next_timestamp(gb_instance_t *gb);
 
-#endif // SCHEDULE_H
\ No newline at end of file
+#endif // SCHEDULE_H
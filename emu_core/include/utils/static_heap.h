@@ -10,11 +10,12 @@
 #define DECL_STATIC_PQUEUE_TYPE(type)                                                \
 typedef bool (* type##_comparator_t)(type e1, type e2);                              \
 typedef struct type##_spqueue {                                                      \
-    const size_t max_len;                                                             \
+    /* Set once by `spqueue_create`, plain members so the header can be assigned */   \
+    size_t max_len;                                                                   \
     size_t len;                                                                       \
     /* Returns TRUE if e1 < e2, and makes heap a max-heap */                          \
-    const type##_comparator_t comparator;                                             \
-    type *const data;                                                                 \
+    type##_comparator_t comparator;                                                   \
+    type *data;                                                                       \
 } type##_spqueue_t;                                                                  \
                                                                                       \
 static inline bool type##_spqueue_is_empty(type##_spqueue_t *heap) {                \
@@ -92,7 +93,7 @@ static inline type type##_spqueue_pop(type##_spqueue_t *heap) {
         priority_idx = type##_pick_priority(heap, curr_idx);                          \
     }                                                                                 \
     return front;                                                                     \
-}                                                                                     \  
+}                                                                                     \
                                                                                     \
 static inline type##_spqueue_t type##_spqueue_create(                   \
     size_t max_size,                                                    \
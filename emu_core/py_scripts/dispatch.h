@@ -0,0 +1,829 @@
+/*
+    Threaded interpreter loop, generated by gen_optable.py from `template_dispatch.h`.
+    Included at the end of cpu_instrs.c so the instr_* handlers can be inlined into it.
+*/
+#include <cpu_instrs.h>
+
+#if CPU_THREADED_DISPATCH
+
+void cpu_run_batch(cpu_context_t *context)
+{
+    uint8_t opcode;
+
+/*
+    Superinstruction: once the first handler of a fused pair ran, run the
+    second one straight away if its opcode follows, without going through
+    the dispatch table. Peeked after the first one, so jumps and code
+    writes are seen.
+*/
+#define DISPATCH_FUSED(next_opcode, handler)                                    \
+    do {                                                                        \
+        if (context->cycles < context->deadline                                 \
+            && cpu_peek_pc(context) == (next_opcode)){                          \
+            (void) cpu_fetch_pc(context);                                       \
+            handler(context, next_opcode);                                      \
+        }                                                                       \
+    } while (0)
+
+#if defined(__GNUC__) && !defined(CPU_DISPATCH_FORCE_SWITCH)
+    /* Labels-as-values: every handler jumps straight to the next one */
+    static const void *dispatch_table[256] = {
+        
+		[0x00] 	= 	&&op_0x00, 
+		[0x01] 	= 	&&op_0x01, 
+		[0x02] 	= 	&&op_0x02, 
+		[0x03] 	= 	&&op_0x03, 
+		[0x04] 	= 	&&op_0x04, 
+		[0x05] 	= 	&&op_0x05, 
+		[0x06] 	= 	&&op_0x06, 
+		[0x07] 	= 	&&op_0x07, 
+		[0x08] 	= 	&&op_0x08, 
+		[0x09] 	= 	&&op_0x09, 
+		[0x0a] 	= 	&&op_0x0a, 
+		[0x0b] 	= 	&&op_0x0b, 
+		[0x0c] 	= 	&&op_0x0c, 
+		[0x0d] 	= 	&&op_0x0d, 
+		[0x0e] 	= 	&&op_0x0e, 
+		[0x0f] 	= 	&&op_0x0f, 
+		[0x10] 	= 	&&op_0x10, 
+		[0x11] 	= 	&&op_0x11, 
+		[0x12] 	= 	&&op_0x12, 
+		[0x13] 	= 	&&op_0x13, 
+		[0x14] 	= 	&&op_0x14, 
+		[0x15] 	= 	&&op_0x15, 
+		[0x16] 	= 	&&op_0x16, 
+		[0x17] 	= 	&&op_0x17, 
+		[0x18] 	= 	&&op_0x18, 
+		[0x19] 	= 	&&op_0x19, 
+		[0x1a] 	= 	&&op_0x1a, 
+		[0x1b] 	= 	&&op_0x1b, 
+		[0x1c] 	= 	&&op_0x1c, 
+		[0x1d] 	= 	&&op_0x1d, 
+		[0x1e] 	= 	&&op_0x1e, 
+		[0x1f] 	= 	&&op_0x1f, 
+		[0x20] 	= 	&&op_0x20, 
+		[0x21] 	= 	&&op_0x21, 
+		[0x22] 	= 	&&op_0x22, 
+		[0x23] 	= 	&&op_0x23, 
+		[0x24] 	= 	&&op_0x24, 
+		[0x25] 	= 	&&op_0x25, 
+		[0x26] 	= 	&&op_0x26, 
+		[0x27] 	= 	&&op_0x27, 
+		[0x28] 	= 	&&op_0x28, 
+		[0x29] 	= 	&&op_0x29, 
+		[0x2a] 	= 	&&op_0x2a, 
+		[0x2b] 	= 	&&op_0x2b, 
+		[0x2c] 	= 	&&op_0x2c, 
+		[0x2d] 	= 	&&op_0x2d, 
+		[0x2e] 	= 	&&op_0x2e, 
+		[0x2f] 	= 	&&op_0x2f, 
+		[0x30] 	= 	&&op_0x30, 
+		[0x31] 	= 	&&op_0x31, 
+		[0x32] 	= 	&&op_0x32, 
+		[0x33] 	= 	&&op_0x33, 
+		[0x34] 	= 	&&op_0x34, 
+		[0x35] 	= 	&&op_0x35, 
+		[0x36] 	= 	&&op_0x36, 
+		[0x37] 	= 	&&op_0x37, 
+		[0x38] 	= 	&&op_0x38, 
+		[0x39] 	= 	&&op_0x39, 
+		[0x3a] 	= 	&&op_0x3a, 
+		[0x3b] 	= 	&&op_0x3b, 
+		[0x3c] 	= 	&&op_0x3c, 
+		[0x3d] 	= 	&&op_0x3d, 
+		[0x3e] 	= 	&&op_0x3e, 
+		[0x3f] 	= 	&&op_0x3f, 
+		[0x40] 	= 	&&op_0x40, 
+		[0x41] 	= 	&&op_0x41, 
+		[0x42] 	= 	&&op_0x42, 
+		[0x43] 	= 	&&op_0x43, 
+		[0x44] 	= 	&&op_0x44, 
+		[0x45] 	= 	&&op_0x45, 
+		[0x46] 	= 	&&op_0x46, 
+		[0x47] 	= 	&&op_0x47, 
+		[0x48] 	= 	&&op_0x48, 
+		[0x49] 	= 	&&op_0x49, 
+		[0x4a] 	= 	&&op_0x4a, 
+		[0x4b] 	= 	&&op_0x4b, 
+		[0x4c] 	= 	&&op_0x4c, 
+		[0x4d] 	= 	&&op_0x4d, 
+		[0x4e] 	= 	&&op_0x4e, 
+		[0x4f] 	= 	&&op_0x4f, 
+		[0x50] 	= 	&&op_0x50, 
+		[0x51] 	= 	&&op_0x51, 
+		[0x52] 	= 	&&op_0x52, 
+		[0x53] 	= 	&&op_0x53, 
+		[0x54] 	= 	&&op_0x54, 
+		[0x55] 	= 	&&op_0x55, 
+		[0x56] 	= 	&&op_0x56, 
+		[0x57] 	= 	&&op_0x57, 
+		[0x58] 	= 	&&op_0x58, 
+		[0x59] 	= 	&&op_0x59, 
+		[0x5a] 	= 	&&op_0x5a, 
+		[0x5b] 	= 	&&op_0x5b, 
+		[0x5c] 	= 	&&op_0x5c, 
+		[0x5d] 	= 	&&op_0x5d, 
+		[0x5e] 	= 	&&op_0x5e, 
+		[0x5f] 	= 	&&op_0x5f, 
+		[0x60] 	= 	&&op_0x60, 
+		[0x61] 	= 	&&op_0x61, 
+		[0x62] 	= 	&&op_0x62, 
+		[0x63] 	= 	&&op_0x63, 
+		[0x64] 	= 	&&op_0x64, 
+		[0x65] 	= 	&&op_0x65, 
+		[0x66] 	= 	&&op_0x66, 
+		[0x67] 	= 	&&op_0x67, 
+		[0x68] 	= 	&&op_0x68, 
+		[0x69] 	= 	&&op_0x69, 
+		[0x6a] 	= 	&&op_0x6a, 
+		[0x6b] 	= 	&&op_0x6b, 
+		[0x6c] 	= 	&&op_0x6c, 
+		[0x6d] 	= 	&&op_0x6d, 
+		[0x6e] 	= 	&&op_0x6e, 
+		[0x6f] 	= 	&&op_0x6f, 
+		[0x70] 	= 	&&op_0x70, 
+		[0x71] 	= 	&&op_0x71, 
+		[0x72] 	= 	&&op_0x72, 
+		[0x73] 	= 	&&op_0x73, 
+		[0x74] 	= 	&&op_0x74, 
+		[0x75] 	= 	&&op_0x75, 
+		[0x76] 	= 	&&op_0x76, 
+		[0x77] 	= 	&&op_0x77, 
+		[0x78] 	= 	&&op_0x78, 
+		[0x79] 	= 	&&op_0x79, 
+		[0x7a] 	= 	&&op_0x7a, 
+		[0x7b] 	= 	&&op_0x7b, 
+		[0x7c] 	= 	&&op_0x7c, 
+		[0x7d] 	= 	&&op_0x7d, 
+		[0x7e] 	= 	&&op_0x7e, 
+		[0x7f] 	= 	&&op_0x7f, 
+		[0x80] 	= 	&&op_0x80, 
+		[0x81] 	= 	&&op_0x81, 
+		[0x82] 	= 	&&op_0x82, 
+		[0x83] 	= 	&&op_0x83, 
+		[0x84] 	= 	&&op_0x84, 
+		[0x85] 	= 	&&op_0x85, 
+		[0x86] 	= 	&&op_0x86, 
+		[0x87] 	= 	&&op_0x87, 
+		[0x88] 	= 	&&op_0x88, 
+		[0x89] 	= 	&&op_0x89, 
+		[0x8a] 	= 	&&op_0x8a, 
+		[0x8b] 	= 	&&op_0x8b, 
+		[0x8c] 	= 	&&op_0x8c, 
+		[0x8d] 	= 	&&op_0x8d, 
+		[0x8e] 	= 	&&op_0x8e, 
+		[0x8f] 	= 	&&op_0x8f, 
+		[0x90] 	= 	&&op_0x90, 
+		[0x91] 	= 	&&op_0x91, 
+		[0x92] 	= 	&&op_0x92, 
+		[0x93] 	= 	&&op_0x93, 
+		[0x94] 	= 	&&op_0x94, 
+		[0x95] 	= 	&&op_0x95, 
+		[0x96] 	= 	&&op_0x96, 
+		[0x97] 	= 	&&op_0x97, 
+		[0x98] 	= 	&&op_0x98, 
+		[0x99] 	= 	&&op_0x99, 
+		[0x9a] 	= 	&&op_0x9a, 
+		[0x9b] 	= 	&&op_0x9b, 
+		[0x9c] 	= 	&&op_0x9c, 
+		[0x9d] 	= 	&&op_0x9d, 
+		[0x9e] 	= 	&&op_0x9e, 
+		[0x9f] 	= 	&&op_0x9f, 
+		[0xa0] 	= 	&&op_0xa0, 
+		[0xa1] 	= 	&&op_0xa1, 
+		[0xa2] 	= 	&&op_0xa2, 
+		[0xa3] 	= 	&&op_0xa3, 
+		[0xa4] 	= 	&&op_0xa4, 
+		[0xa5] 	= 	&&op_0xa5, 
+		[0xa6] 	= 	&&op_0xa6, 
+		[0xa7] 	= 	&&op_0xa7, 
+		[0xa8] 	= 	&&op_0xa8, 
+		[0xa9] 	= 	&&op_0xa9, 
+		[0xaa] 	= 	&&op_0xaa, 
+		[0xab] 	= 	&&op_0xab, 
+		[0xac] 	= 	&&op_0xac, 
+		[0xad] 	= 	&&op_0xad, 
+		[0xae] 	= 	&&op_0xae, 
+		[0xaf] 	= 	&&op_0xaf, 
+		[0xb0] 	= 	&&op_0xb0, 
+		[0xb1] 	= 	&&op_0xb1, 
+		[0xb2] 	= 	&&op_0xb2, 
+		[0xb3] 	= 	&&op_0xb3, 
+		[0xb4] 	= 	&&op_0xb4, 
+		[0xb5] 	= 	&&op_0xb5, 
+		[0xb6] 	= 	&&op_0xb6, 
+		[0xb7] 	= 	&&op_0xb7, 
+		[0xb8] 	= 	&&op_0xb8, 
+		[0xb9] 	= 	&&op_0xb9, 
+		[0xba] 	= 	&&op_0xba, 
+		[0xbb] 	= 	&&op_0xbb, 
+		[0xbc] 	= 	&&op_0xbc, 
+		[0xbd] 	= 	&&op_0xbd, 
+		[0xbe] 	= 	&&op_0xbe, 
+		[0xbf] 	= 	&&op_0xbf, 
+		[0xc0] 	= 	&&op_0xc0, 
+		[0xc1] 	= 	&&op_0xc1, 
+		[0xc2] 	= 	&&op_0xc2, 
+		[0xc3] 	= 	&&op_0xc3, 
+		[0xc4] 	= 	&&op_0xc4, 
+		[0xc5] 	= 	&&op_0xc5, 
+		[0xc6] 	= 	&&op_0xc6, 
+		[0xc7] 	= 	&&op_0xc7, 
+		[0xc8] 	= 	&&op_0xc8, 
+		[0xc9] 	= 	&&op_0xc9, 
+		[0xca] 	= 	&&op_0xca, 
+		[0xcb] 	= 	&&op_0xcb, 
+		[0xcc] 	= 	&&op_0xcc, 
+		[0xcd] 	= 	&&op_0xcd, 
+		[0xce] 	= 	&&op_0xce, 
+		[0xcf] 	= 	&&op_0xcf, 
+		[0xd0] 	= 	&&op_0xd0, 
+		[0xd1] 	= 	&&op_0xd1, 
+		[0xd2] 	= 	&&op_0xd2, 
+		[0xd3] 	= 	&&op_0xd3, 
+		[0xd4] 	= 	&&op_0xd4, 
+		[0xd5] 	= 	&&op_0xd5, 
+		[0xd6] 	= 	&&op_0xd6, 
+		[0xd7] 	= 	&&op_0xd7, 
+		[0xd8] 	= 	&&op_0xd8, 
+		[0xd9] 	= 	&&op_0xd9, 
+		[0xda] 	= 	&&op_0xda, 
+		[0xdb] 	= 	&&op_0xdb, 
+		[0xdc] 	= 	&&op_0xdc, 
+		[0xdd] 	= 	&&op_0xdd, 
+		[0xde] 	= 	&&op_0xde, 
+		[0xdf] 	= 	&&op_0xdf, 
+		[0xe0] 	= 	&&op_0xe0, 
+		[0xe1] 	= 	&&op_0xe1, 
+		[0xe2] 	= 	&&op_0xe2, 
+		[0xe3] 	= 	&&op_0xe3, 
+		[0xe4] 	= 	&&op_0xe4, 
+		[0xe5] 	= 	&&op_0xe5, 
+		[0xe6] 	= 	&&op_0xe6, 
+		[0xe7] 	= 	&&op_0xe7, 
+		[0xe8] 	= 	&&op_0xe8, 
+		[0xe9] 	= 	&&op_0xe9, 
+		[0xea] 	= 	&&op_0xea, 
+		[0xeb] 	= 	&&op_0xeb, 
+		[0xec] 	= 	&&op_0xec, 
+		[0xed] 	= 	&&op_0xed, 
+		[0xee] 	= 	&&op_0xee, 
+		[0xef] 	= 	&&op_0xef, 
+		[0xf0] 	= 	&&op_0xf0, 
+		[0xf1] 	= 	&&op_0xf1, 
+		[0xf2] 	= 	&&op_0xf2, 
+		[0xf3] 	= 	&&op_0xf3, 
+		[0xf4] 	= 	&&op_0xf4, 
+		[0xf5] 	= 	&&op_0xf5, 
+		[0xf6] 	= 	&&op_0xf6, 
+		[0xf7] 	= 	&&op_0xf7, 
+		[0xf8] 	= 	&&op_0xf8, 
+		[0xf9] 	= 	&&op_0xf9, 
+		[0xfa] 	= 	&&op_0xfa, 
+		[0xfb] 	= 	&&op_0xfb, 
+		[0xfc] 	= 	&&op_0xfc, 
+		[0xfd] 	= 	&&op_0xfd, 
+		[0xfe] 	= 	&&op_0xfe, 
+		[0xff] 	= 	&&op_0xff, 
+
+    };
+
+#define DISPATCH_NEXT()                                     \
+    do {                                                    \
+        if (context->cycles >= context->deadline) return;   \
+        opcode = cpu_fetch_pc(context);                     \
+        goto *dispatch_table[opcode];                       \
+    } while (0)
+
+    DISPATCH_NEXT();
+    
+op_0x00: 	instr_nop(context, 0x00); 	DISPATCH_NEXT();
+op_0x01: 	instr_ld_r16_imm16(context, 0x01); 	DISPATCH_NEXT();
+op_0x02: 	instr_ld_r16mem_a(context, 0x02); 	DISPATCH_NEXT();
+op_0x03: 	instr_inc_r16(context, 0x03); 	DISPATCH_NEXT();
+op_0x04: 	instr_inc_r8(context, 0x04); 	DISPATCH_NEXT();
+op_0x05: 	instr_dec_r8(context, 0x05); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	DISPATCH_NEXT();
+op_0x06: 	instr_ld_r8_imm8(context, 0x06); 	DISPATCH_NEXT();
+op_0x07: 	instr_rlca(context, 0x07); 	DISPATCH_NEXT();
+op_0x08: 	instr_ld_imm16mem_sp(context, 0x08); 	DISPATCH_NEXT();
+op_0x09: 	instr_add_hl_r16(context, 0x09); 	DISPATCH_NEXT();
+op_0x0a: 	instr_ld_a_r16mem(context, 0x0a); 	DISPATCH_NEXT();
+op_0x0b: 	instr_dec_r16(context, 0x0b); 	DISPATCH_FUSED(0x78, instr_ld_r8_r8); 	DISPATCH_NEXT();
+op_0x0c: 	instr_inc_r8(context, 0x0c); 	DISPATCH_NEXT();
+op_0x0d: 	instr_dec_r8(context, 0x0d); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	DISPATCH_NEXT();
+op_0x0e: 	instr_ld_r8_imm8(context, 0x0e); 	DISPATCH_NEXT();
+op_0x0f: 	instr_rrca(context, 0x0f); 	DISPATCH_NEXT();
+op_0x10: 	instr_stop(context, 0x10); 	return;
+op_0x11: 	instr_ld_r16_imm16(context, 0x11); 	DISPATCH_NEXT();
+op_0x12: 	instr_ld_r16mem_a(context, 0x12); 	DISPATCH_FUSED(0x13, instr_inc_r16); 	DISPATCH_NEXT();
+op_0x13: 	instr_inc_r16(context, 0x13); 	DISPATCH_NEXT();
+op_0x14: 	instr_inc_r8(context, 0x14); 	DISPATCH_NEXT();
+op_0x15: 	instr_dec_r8(context, 0x15); 	DISPATCH_NEXT();
+op_0x16: 	instr_ld_r8_imm8(context, 0x16); 	DISPATCH_NEXT();
+op_0x17: 	instr_rla(context, 0x17); 	DISPATCH_NEXT();
+op_0x18: 	instr_jr_imm8(context, 0x18); 	DISPATCH_NEXT();
+op_0x19: 	instr_add_hl_r16(context, 0x19); 	DISPATCH_NEXT();
+op_0x1a: 	instr_ld_a_r16mem(context, 0x1a); 	DISPATCH_NEXT();
+op_0x1b: 	instr_dec_r16(context, 0x1b); 	DISPATCH_NEXT();
+op_0x1c: 	instr_inc_r8(context, 0x1c); 	DISPATCH_NEXT();
+op_0x1d: 	instr_dec_r8(context, 0x1d); 	DISPATCH_NEXT();
+op_0x1e: 	instr_ld_r8_imm8(context, 0x1e); 	DISPATCH_NEXT();
+op_0x1f: 	instr_rra(context, 0x1f); 	DISPATCH_NEXT();
+op_0x20: 	instr_jr_cond_imm8(context, 0x20); 	DISPATCH_NEXT();
+op_0x21: 	instr_ld_r16_imm16(context, 0x21); 	DISPATCH_NEXT();
+op_0x22: 	instr_ld_r16mem_a(context, 0x22); 	DISPATCH_FUSED(0x05, instr_dec_r8); 	DISPATCH_NEXT();
+op_0x23: 	instr_inc_r16(context, 0x23); 	DISPATCH_NEXT();
+op_0x24: 	instr_inc_r8(context, 0x24); 	DISPATCH_NEXT();
+op_0x25: 	instr_dec_r8(context, 0x25); 	DISPATCH_NEXT();
+op_0x26: 	instr_ld_r8_imm8(context, 0x26); 	DISPATCH_NEXT();
+op_0x27: 	instr_daa(context, 0x27); 	DISPATCH_NEXT();
+op_0x28: 	instr_jr_cond_imm8(context, 0x28); 	DISPATCH_NEXT();
+op_0x29: 	instr_add_hl_r16(context, 0x29); 	DISPATCH_NEXT();
+op_0x2a: 	instr_ld_a_r16mem(context, 0x2a); 	DISPATCH_FUSED(0x12, instr_ld_r16mem_a); 	DISPATCH_NEXT();
+op_0x2b: 	instr_dec_r16(context, 0x2b); 	DISPATCH_NEXT();
+op_0x2c: 	instr_inc_r8(context, 0x2c); 	DISPATCH_NEXT();
+op_0x2d: 	instr_dec_r8(context, 0x2d); 	DISPATCH_NEXT();
+op_0x2e: 	instr_ld_r8_imm8(context, 0x2e); 	DISPATCH_NEXT();
+op_0x2f: 	instr_cpl(context, 0x2f); 	DISPATCH_NEXT();
+op_0x30: 	instr_jr_cond_imm8(context, 0x30); 	DISPATCH_NEXT();
+op_0x31: 	instr_ld_r16_imm16(context, 0x31); 	DISPATCH_NEXT();
+op_0x32: 	instr_ld_r16mem_a(context, 0x32); 	DISPATCH_NEXT();
+op_0x33: 	instr_inc_r16(context, 0x33); 	DISPATCH_NEXT();
+op_0x34: 	instr_inc_r8(context, 0x34); 	DISPATCH_NEXT();
+op_0x35: 	instr_dec_r8(context, 0x35); 	DISPATCH_NEXT();
+op_0x36: 	instr_ld_r8_imm8(context, 0x36); 	DISPATCH_NEXT();
+op_0x37: 	instr_scf(context, 0x37); 	DISPATCH_NEXT();
+op_0x38: 	instr_jr_cond_imm8(context, 0x38); 	DISPATCH_NEXT();
+op_0x39: 	instr_add_hl_r16(context, 0x39); 	DISPATCH_NEXT();
+op_0x3a: 	instr_ld_a_r16mem(context, 0x3a); 	DISPATCH_NEXT();
+op_0x3b: 	instr_dec_r16(context, 0x3b); 	DISPATCH_NEXT();
+op_0x3c: 	instr_inc_r8(context, 0x3c); 	DISPATCH_NEXT();
+op_0x3d: 	instr_dec_r8(context, 0x3d); 	DISPATCH_NEXT();
+op_0x3e: 	instr_ld_r8_imm8(context, 0x3e); 	DISPATCH_NEXT();
+op_0x3f: 	instr_ccf(context, 0x3f); 	DISPATCH_NEXT();
+op_0x40: 	instr_ld_r8_r8(context, 0x40); 	DISPATCH_NEXT();
+op_0x41: 	instr_ld_r8_r8(context, 0x41); 	DISPATCH_NEXT();
+op_0x42: 	instr_ld_r8_r8(context, 0x42); 	DISPATCH_NEXT();
+op_0x43: 	instr_ld_r8_r8(context, 0x43); 	DISPATCH_NEXT();
+op_0x44: 	instr_ld_r8_r8(context, 0x44); 	DISPATCH_NEXT();
+op_0x45: 	instr_ld_r8_r8(context, 0x45); 	DISPATCH_NEXT();
+op_0x46: 	instr_ld_r8_r8(context, 0x46); 	DISPATCH_NEXT();
+op_0x47: 	instr_ld_r8_r8(context, 0x47); 	DISPATCH_NEXT();
+op_0x48: 	instr_ld_r8_r8(context, 0x48); 	DISPATCH_NEXT();
+op_0x49: 	instr_ld_r8_r8(context, 0x49); 	DISPATCH_NEXT();
+op_0x4a: 	instr_ld_r8_r8(context, 0x4a); 	DISPATCH_NEXT();
+op_0x4b: 	instr_ld_r8_r8(context, 0x4b); 	DISPATCH_NEXT();
+op_0x4c: 	instr_ld_r8_r8(context, 0x4c); 	DISPATCH_NEXT();
+op_0x4d: 	instr_ld_r8_r8(context, 0x4d); 	DISPATCH_NEXT();
+op_0x4e: 	instr_ld_r8_r8(context, 0x4e); 	DISPATCH_NEXT();
+op_0x4f: 	instr_ld_r8_r8(context, 0x4f); 	DISPATCH_NEXT();
+op_0x50: 	instr_ld_r8_r8(context, 0x50); 	DISPATCH_NEXT();
+op_0x51: 	instr_ld_r8_r8(context, 0x51); 	DISPATCH_NEXT();
+op_0x52: 	instr_ld_r8_r8(context, 0x52); 	DISPATCH_NEXT();
+op_0x53: 	instr_ld_r8_r8(context, 0x53); 	DISPATCH_NEXT();
+op_0x54: 	instr_ld_r8_r8(context, 0x54); 	DISPATCH_NEXT();
+op_0x55: 	instr_ld_r8_r8(context, 0x55); 	DISPATCH_NEXT();
+op_0x56: 	instr_ld_r8_r8(context, 0x56); 	DISPATCH_NEXT();
+op_0x57: 	instr_ld_r8_r8(context, 0x57); 	DISPATCH_NEXT();
+op_0x58: 	instr_ld_r8_r8(context, 0x58); 	DISPATCH_NEXT();
+op_0x59: 	instr_ld_r8_r8(context, 0x59); 	DISPATCH_NEXT();
+op_0x5a: 	instr_ld_r8_r8(context, 0x5a); 	DISPATCH_NEXT();
+op_0x5b: 	instr_ld_r8_r8(context, 0x5b); 	DISPATCH_NEXT();
+op_0x5c: 	instr_ld_r8_r8(context, 0x5c); 	DISPATCH_NEXT();
+op_0x5d: 	instr_ld_r8_r8(context, 0x5d); 	DISPATCH_NEXT();
+op_0x5e: 	instr_ld_r8_r8(context, 0x5e); 	DISPATCH_NEXT();
+op_0x5f: 	instr_ld_r8_r8(context, 0x5f); 	DISPATCH_NEXT();
+op_0x60: 	instr_ld_r8_r8(context, 0x60); 	DISPATCH_NEXT();
+op_0x61: 	instr_ld_r8_r8(context, 0x61); 	DISPATCH_NEXT();
+op_0x62: 	instr_ld_r8_r8(context, 0x62); 	DISPATCH_NEXT();
+op_0x63: 	instr_ld_r8_r8(context, 0x63); 	DISPATCH_NEXT();
+op_0x64: 	instr_ld_r8_r8(context, 0x64); 	DISPATCH_NEXT();
+op_0x65: 	instr_ld_r8_r8(context, 0x65); 	DISPATCH_NEXT();
+op_0x66: 	instr_ld_r8_r8(context, 0x66); 	DISPATCH_NEXT();
+op_0x67: 	instr_ld_r8_r8(context, 0x67); 	DISPATCH_NEXT();
+op_0x68: 	instr_ld_r8_r8(context, 0x68); 	DISPATCH_NEXT();
+op_0x69: 	instr_ld_r8_r8(context, 0x69); 	DISPATCH_NEXT();
+op_0x6a: 	instr_ld_r8_r8(context, 0x6a); 	DISPATCH_NEXT();
+op_0x6b: 	instr_ld_r8_r8(context, 0x6b); 	DISPATCH_NEXT();
+op_0x6c: 	instr_ld_r8_r8(context, 0x6c); 	DISPATCH_NEXT();
+op_0x6d: 	instr_ld_r8_r8(context, 0x6d); 	DISPATCH_NEXT();
+op_0x6e: 	instr_ld_r8_r8(context, 0x6e); 	DISPATCH_NEXT();
+op_0x6f: 	instr_ld_r8_r8(context, 0x6f); 	DISPATCH_NEXT();
+op_0x70: 	instr_ld_r8_r8(context, 0x70); 	DISPATCH_NEXT();
+op_0x71: 	instr_ld_r8_r8(context, 0x71); 	DISPATCH_NEXT();
+op_0x72: 	instr_ld_r8_r8(context, 0x72); 	DISPATCH_NEXT();
+op_0x73: 	instr_ld_r8_r8(context, 0x73); 	DISPATCH_NEXT();
+op_0x74: 	instr_ld_r8_r8(context, 0x74); 	DISPATCH_NEXT();
+op_0x75: 	instr_ld_r8_r8(context, 0x75); 	DISPATCH_NEXT();
+op_0x76: 	instr_halt(context, 0x76); 	return;
+op_0x77: 	instr_ld_r8_r8(context, 0x77); 	DISPATCH_NEXT();
+op_0x78: 	instr_ld_r8_r8(context, 0x78); 	DISPATCH_FUSED(0xb1, instr_alu_op_r8); 	DISPATCH_NEXT();
+op_0x79: 	instr_ld_r8_r8(context, 0x79); 	DISPATCH_NEXT();
+op_0x7a: 	instr_ld_r8_r8(context, 0x7a); 	DISPATCH_NEXT();
+op_0x7b: 	instr_ld_r8_r8(context, 0x7b); 	DISPATCH_NEXT();
+op_0x7c: 	instr_ld_r8_r8(context, 0x7c); 	DISPATCH_NEXT();
+op_0x7d: 	instr_ld_r8_r8(context, 0x7d); 	DISPATCH_NEXT();
+op_0x7e: 	instr_ld_r8_r8(context, 0x7e); 	DISPATCH_NEXT();
+op_0x7f: 	instr_ld_r8_r8(context, 0x7f); 	DISPATCH_NEXT();
+op_0x80: 	instr_alu_op_r8(context, 0x80); 	DISPATCH_NEXT();
+op_0x81: 	instr_alu_op_r8(context, 0x81); 	DISPATCH_NEXT();
+op_0x82: 	instr_alu_op_r8(context, 0x82); 	DISPATCH_NEXT();
+op_0x83: 	instr_alu_op_r8(context, 0x83); 	DISPATCH_NEXT();
+op_0x84: 	instr_alu_op_r8(context, 0x84); 	DISPATCH_NEXT();
+op_0x85: 	instr_alu_op_r8(context, 0x85); 	DISPATCH_NEXT();
+op_0x86: 	instr_alu_op_r8(context, 0x86); 	DISPATCH_NEXT();
+op_0x87: 	instr_alu_op_r8(context, 0x87); 	DISPATCH_NEXT();
+op_0x88: 	instr_alu_op_r8(context, 0x88); 	DISPATCH_NEXT();
+op_0x89: 	instr_alu_op_r8(context, 0x89); 	DISPATCH_NEXT();
+op_0x8a: 	instr_alu_op_r8(context, 0x8a); 	DISPATCH_NEXT();
+op_0x8b: 	instr_alu_op_r8(context, 0x8b); 	DISPATCH_NEXT();
+op_0x8c: 	instr_alu_op_r8(context, 0x8c); 	DISPATCH_NEXT();
+op_0x8d: 	instr_alu_op_r8(context, 0x8d); 	DISPATCH_NEXT();
+op_0x8e: 	instr_alu_op_r8(context, 0x8e); 	DISPATCH_NEXT();
+op_0x8f: 	instr_alu_op_r8(context, 0x8f); 	DISPATCH_NEXT();
+op_0x90: 	instr_alu_op_r8(context, 0x90); 	DISPATCH_NEXT();
+op_0x91: 	instr_alu_op_r8(context, 0x91); 	DISPATCH_NEXT();
+op_0x92: 	instr_alu_op_r8(context, 0x92); 	DISPATCH_NEXT();
+op_0x93: 	instr_alu_op_r8(context, 0x93); 	DISPATCH_NEXT();
+op_0x94: 	instr_alu_op_r8(context, 0x94); 	DISPATCH_NEXT();
+op_0x95: 	instr_alu_op_r8(context, 0x95); 	DISPATCH_NEXT();
+op_0x96: 	instr_alu_op_r8(context, 0x96); 	DISPATCH_NEXT();
+op_0x97: 	instr_alu_op_r8(context, 0x97); 	DISPATCH_NEXT();
+op_0x98: 	instr_alu_op_r8(context, 0x98); 	DISPATCH_NEXT();
+op_0x99: 	instr_alu_op_r8(context, 0x99); 	DISPATCH_NEXT();
+op_0x9a: 	instr_alu_op_r8(context, 0x9a); 	DISPATCH_NEXT();
+op_0x9b: 	instr_alu_op_r8(context, 0x9b); 	DISPATCH_NEXT();
+op_0x9c: 	instr_alu_op_r8(context, 0x9c); 	DISPATCH_NEXT();
+op_0x9d: 	instr_alu_op_r8(context, 0x9d); 	DISPATCH_NEXT();
+op_0x9e: 	instr_alu_op_r8(context, 0x9e); 	DISPATCH_NEXT();
+op_0x9f: 	instr_alu_op_r8(context, 0x9f); 	DISPATCH_NEXT();
+op_0xa0: 	instr_alu_op_r8(context, 0xa0); 	DISPATCH_NEXT();
+op_0xa1: 	instr_alu_op_r8(context, 0xa1); 	DISPATCH_NEXT();
+op_0xa2: 	instr_alu_op_r8(context, 0xa2); 	DISPATCH_NEXT();
+op_0xa3: 	instr_alu_op_r8(context, 0xa3); 	DISPATCH_NEXT();
+op_0xa4: 	instr_alu_op_r8(context, 0xa4); 	DISPATCH_NEXT();
+op_0xa5: 	instr_alu_op_r8(context, 0xa5); 	DISPATCH_NEXT();
+op_0xa6: 	instr_alu_op_r8(context, 0xa6); 	DISPATCH_NEXT();
+op_0xa7: 	instr_alu_op_r8(context, 0xa7); 	DISPATCH_NEXT();
+op_0xa8: 	instr_alu_op_r8(context, 0xa8); 	DISPATCH_NEXT();
+op_0xa9: 	instr_alu_op_r8(context, 0xa9); 	DISPATCH_NEXT();
+op_0xaa: 	instr_alu_op_r8(context, 0xaa); 	DISPATCH_NEXT();
+op_0xab: 	instr_alu_op_r8(context, 0xab); 	DISPATCH_NEXT();
+op_0xac: 	instr_alu_op_r8(context, 0xac); 	DISPATCH_NEXT();
+op_0xad: 	instr_alu_op_r8(context, 0xad); 	DISPATCH_NEXT();
+op_0xae: 	instr_alu_op_r8(context, 0xae); 	DISPATCH_NEXT();
+op_0xaf: 	instr_alu_op_r8(context, 0xaf); 	DISPATCH_NEXT();
+op_0xb0: 	instr_alu_op_r8(context, 0xb0); 	DISPATCH_NEXT();
+op_0xb1: 	instr_alu_op_r8(context, 0xb1); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	DISPATCH_NEXT();
+op_0xb2: 	instr_alu_op_r8(context, 0xb2); 	DISPATCH_NEXT();
+op_0xb3: 	instr_alu_op_r8(context, 0xb3); 	DISPATCH_NEXT();
+op_0xb4: 	instr_alu_op_r8(context, 0xb4); 	DISPATCH_NEXT();
+op_0xb5: 	instr_alu_op_r8(context, 0xb5); 	DISPATCH_NEXT();
+op_0xb6: 	instr_alu_op_r8(context, 0xb6); 	DISPATCH_NEXT();
+op_0xb7: 	instr_alu_op_r8(context, 0xb7); 	DISPATCH_NEXT();
+op_0xb8: 	instr_alu_op_r8(context, 0xb8); 	DISPATCH_NEXT();
+op_0xb9: 	instr_alu_op_r8(context, 0xb9); 	DISPATCH_NEXT();
+op_0xba: 	instr_alu_op_r8(context, 0xba); 	DISPATCH_NEXT();
+op_0xbb: 	instr_alu_op_r8(context, 0xbb); 	DISPATCH_NEXT();
+op_0xbc: 	instr_alu_op_r8(context, 0xbc); 	DISPATCH_NEXT();
+op_0xbd: 	instr_alu_op_r8(context, 0xbd); 	DISPATCH_NEXT();
+op_0xbe: 	instr_alu_op_r8(context, 0xbe); 	DISPATCH_NEXT();
+op_0xbf: 	instr_alu_op_r8(context, 0xbf); 	DISPATCH_NEXT();
+op_0xc0: 	instr_ret_cond(context, 0xc0); 	DISPATCH_NEXT();
+op_0xc1: 	instr_pop_r16stk(context, 0xc1); 	DISPATCH_NEXT();
+op_0xc2: 	instr_jp_cond(context, 0xc2); 	DISPATCH_NEXT();
+op_0xc3: 	instr_jp_imm16(context, 0xc3); 	DISPATCH_NEXT();
+op_0xc4: 	instr_call_cond_imm16(context, 0xc4); 	DISPATCH_NEXT();
+op_0xc5: 	instr_push_r16stk(context, 0xc5); 	DISPATCH_NEXT();
+op_0xc6: 	instr_alu_op_imm8(context, 0xc6); 	DISPATCH_NEXT();
+op_0xc7: 	instr_rst_tgt3(context, 0xc7); 	DISPATCH_NEXT();
+op_0xc8: 	instr_ret_cond(context, 0xc8); 	DISPATCH_NEXT();
+op_0xc9: 	instr_ret(context, 0xc9); 	DISPATCH_NEXT();
+op_0xca: 	instr_jp_cond(context, 0xca); 	DISPATCH_NEXT();
+op_0xcb: 	instr_cb_prefix(context, 0xcb); 	DISPATCH_NEXT();
+op_0xcc: 	instr_call_cond_imm16(context, 0xcc); 	DISPATCH_NEXT();
+op_0xcd: 	instr_call_imm16(context, 0xcd); 	DISPATCH_NEXT();
+op_0xce: 	instr_alu_op_imm8(context, 0xce); 	DISPATCH_NEXT();
+op_0xcf: 	instr_rst_tgt3(context, 0xcf); 	DISPATCH_NEXT();
+op_0xd0: 	instr_ret_cond(context, 0xd0); 	DISPATCH_NEXT();
+op_0xd1: 	instr_pop_r16stk(context, 0xd1); 	DISPATCH_NEXT();
+op_0xd2: 	instr_jp_cond(context, 0xd2); 	DISPATCH_NEXT();
+op_0xd3: 	instr_unimplemented(context, 0xd3); 	return;
+op_0xd4: 	instr_call_cond_imm16(context, 0xd4); 	DISPATCH_NEXT();
+op_0xd5: 	instr_push_r16stk(context, 0xd5); 	DISPATCH_NEXT();
+op_0xd6: 	instr_alu_op_imm8(context, 0xd6); 	DISPATCH_NEXT();
+op_0xd7: 	instr_rst_tgt3(context, 0xd7); 	DISPATCH_NEXT();
+op_0xd8: 	instr_ret_cond(context, 0xd8); 	DISPATCH_NEXT();
+op_0xd9: 	instr_reti(context, 0xd9); 	return;
+op_0xda: 	instr_jp_cond(context, 0xda); 	DISPATCH_NEXT();
+op_0xdb: 	instr_unimplemented(context, 0xdb); 	return;
+op_0xdc: 	instr_call_cond_imm16(context, 0xdc); 	DISPATCH_NEXT();
+op_0xdd: 	instr_unimplemented(context, 0xdd); 	return;
+op_0xde: 	instr_alu_op_imm8(context, 0xde); 	DISPATCH_NEXT();
+op_0xdf: 	instr_rst_tgt3(context, 0xdf); 	DISPATCH_NEXT();
+op_0xe0: 	instr_ldh_imm8mem_a(context, 0xe0); 	DISPATCH_NEXT();
+op_0xe1: 	instr_pop_r16stk(context, 0xe1); 	DISPATCH_NEXT();
+op_0xe2: 	instr_ldh_cmem_a(context, 0xe2); 	DISPATCH_NEXT();
+op_0xe3: 	instr_unimplemented(context, 0xe3); 	return;
+op_0xe4: 	instr_unimplemented(context, 0xe4); 	return;
+op_0xe5: 	instr_push_r16stk(context, 0xe5); 	DISPATCH_NEXT();
+op_0xe6: 	instr_alu_op_imm8(context, 0xe6); 	DISPATCH_NEXT();
+op_0xe7: 	instr_rst_tgt3(context, 0xe7); 	DISPATCH_NEXT();
+op_0xe8: 	instr_add_sp_imm8(context, 0xe8); 	DISPATCH_NEXT();
+op_0xe9: 	instr_jp_hl(context, 0xe9); 	DISPATCH_NEXT();
+op_0xea: 	instr_ld_imm16mem_a(context, 0xea); 	DISPATCH_NEXT();
+op_0xeb: 	instr_unimplemented(context, 0xeb); 	return;
+op_0xec: 	instr_unimplemented(context, 0xec); 	return;
+op_0xed: 	instr_unimplemented(context, 0xed); 	return;
+op_0xee: 	instr_alu_op_imm8(context, 0xee); 	DISPATCH_NEXT();
+op_0xef: 	instr_rst_tgt3(context, 0xef); 	DISPATCH_NEXT();
+op_0xf0: 	instr_ldh_a_imm8mem(context, 0xf0); 	DISPATCH_FUSED(0xfe, instr_alu_op_imm8); 	DISPATCH_NEXT();
+op_0xf1: 	instr_pop_r16stk(context, 0xf1); 	DISPATCH_NEXT();
+op_0xf2: 	instr_ldh_a_cmem(context, 0xf2); 	DISPATCH_NEXT();
+op_0xf3: 	instr_di(context, 0xf3); 	return;
+op_0xf4: 	instr_unimplemented(context, 0xf4); 	return;
+op_0xf5: 	instr_push_r16stk(context, 0xf5); 	DISPATCH_NEXT();
+op_0xf6: 	instr_alu_op_imm8(context, 0xf6); 	DISPATCH_NEXT();
+op_0xf7: 	instr_rst_tgt3(context, 0xf7); 	DISPATCH_NEXT();
+op_0xf8: 	instr_ld_hl_sp_imm8(context, 0xf8); 	DISPATCH_NEXT();
+op_0xf9: 	instr_ld_sp_hl(context, 0xf9); 	DISPATCH_NEXT();
+op_0xfa: 	instr_ld_a_imm16mem(context, 0xfa); 	DISPATCH_NEXT();
+op_0xfb: 	instr_ei(context, 0xfb); 	return;
+op_0xfc: 	instr_unimplemented(context, 0xfc); 	return;
+op_0xfd: 	instr_unimplemented(context, 0xfd); 	return;
+op_0xfe: 	instr_alu_op_imm8(context, 0xfe); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	DISPATCH_NEXT();
+op_0xff: 	instr_rst_tgt3(context, 0xff); 	DISPATCH_NEXT();
+
+
+#undef DISPATCH_NEXT
+#else
+    /* Portable fallback, a single switch in a loop */
+    while (context->cycles < context->deadline) {
+        opcode = cpu_fetch_pc(context);
+        switch (opcode) {
+            
+			case 0x00: 	instr_nop(context, 0x00); 	break;
+			case 0x01: 	instr_ld_r16_imm16(context, 0x01); 	break;
+			case 0x02: 	instr_ld_r16mem_a(context, 0x02); 	break;
+			case 0x03: 	instr_inc_r16(context, 0x03); 	break;
+			case 0x04: 	instr_inc_r8(context, 0x04); 	break;
+			case 0x05: 	instr_dec_r8(context, 0x05); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	break;
+			case 0x06: 	instr_ld_r8_imm8(context, 0x06); 	break;
+			case 0x07: 	instr_rlca(context, 0x07); 	break;
+			case 0x08: 	instr_ld_imm16mem_sp(context, 0x08); 	break;
+			case 0x09: 	instr_add_hl_r16(context, 0x09); 	break;
+			case 0x0a: 	instr_ld_a_r16mem(context, 0x0a); 	break;
+			case 0x0b: 	instr_dec_r16(context, 0x0b); 	DISPATCH_FUSED(0x78, instr_ld_r8_r8); 	break;
+			case 0x0c: 	instr_inc_r8(context, 0x0c); 	break;
+			case 0x0d: 	instr_dec_r8(context, 0x0d); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	break;
+			case 0x0e: 	instr_ld_r8_imm8(context, 0x0e); 	break;
+			case 0x0f: 	instr_rrca(context, 0x0f); 	break;
+			case 0x10: 	instr_stop(context, 0x10); 	return;
+			case 0x11: 	instr_ld_r16_imm16(context, 0x11); 	break;
+			case 0x12: 	instr_ld_r16mem_a(context, 0x12); 	DISPATCH_FUSED(0x13, instr_inc_r16); 	break;
+			case 0x13: 	instr_inc_r16(context, 0x13); 	break;
+			case 0x14: 	instr_inc_r8(context, 0x14); 	break;
+			case 0x15: 	instr_dec_r8(context, 0x15); 	break;
+			case 0x16: 	instr_ld_r8_imm8(context, 0x16); 	break;
+			case 0x17: 	instr_rla(context, 0x17); 	break;
+			case 0x18: 	instr_jr_imm8(context, 0x18); 	break;
+			case 0x19: 	instr_add_hl_r16(context, 0x19); 	break;
+			case 0x1a: 	instr_ld_a_r16mem(context, 0x1a); 	break;
+			case 0x1b: 	instr_dec_r16(context, 0x1b); 	break;
+			case 0x1c: 	instr_inc_r8(context, 0x1c); 	break;
+			case 0x1d: 	instr_dec_r8(context, 0x1d); 	break;
+			case 0x1e: 	instr_ld_r8_imm8(context, 0x1e); 	break;
+			case 0x1f: 	instr_rra(context, 0x1f); 	break;
+			case 0x20: 	instr_jr_cond_imm8(context, 0x20); 	break;
+			case 0x21: 	instr_ld_r16_imm16(context, 0x21); 	break;
+			case 0x22: 	instr_ld_r16mem_a(context, 0x22); 	DISPATCH_FUSED(0x05, instr_dec_r8); 	break;
+			case 0x23: 	instr_inc_r16(context, 0x23); 	break;
+			case 0x24: 	instr_inc_r8(context, 0x24); 	break;
+			case 0x25: 	instr_dec_r8(context, 0x25); 	break;
+			case 0x26: 	instr_ld_r8_imm8(context, 0x26); 	break;
+			case 0x27: 	instr_daa(context, 0x27); 	break;
+			case 0x28: 	instr_jr_cond_imm8(context, 0x28); 	break;
+			case 0x29: 	instr_add_hl_r16(context, 0x29); 	break;
+			case 0x2a: 	instr_ld_a_r16mem(context, 0x2a); 	DISPATCH_FUSED(0x12, instr_ld_r16mem_a); 	break;
+			case 0x2b: 	instr_dec_r16(context, 0x2b); 	break;
+			case 0x2c: 	instr_inc_r8(context, 0x2c); 	break;
+			case 0x2d: 	instr_dec_r8(context, 0x2d); 	break;
+			case 0x2e: 	instr_ld_r8_imm8(context, 0x2e); 	break;
+			case 0x2f: 	instr_cpl(context, 0x2f); 	break;
+			case 0x30: 	instr_jr_cond_imm8(context, 0x30); 	break;
+			case 0x31: 	instr_ld_r16_imm16(context, 0x31); 	break;
+			case 0x32: 	instr_ld_r16mem_a(context, 0x32); 	break;
+			case 0x33: 	instr_inc_r16(context, 0x33); 	break;
+			case 0x34: 	instr_inc_r8(context, 0x34); 	break;
+			case 0x35: 	instr_dec_r8(context, 0x35); 	break;
+			case 0x36: 	instr_ld_r8_imm8(context, 0x36); 	break;
+			case 0x37: 	instr_scf(context, 0x37); 	break;
+			case 0x38: 	instr_jr_cond_imm8(context, 0x38); 	break;
+			case 0x39: 	instr_add_hl_r16(context, 0x39); 	break;
+			case 0x3a: 	instr_ld_a_r16mem(context, 0x3a); 	break;
+			case 0x3b: 	instr_dec_r16(context, 0x3b); 	break;
+			case 0x3c: 	instr_inc_r8(context, 0x3c); 	break;
+			case 0x3d: 	instr_dec_r8(context, 0x3d); 	break;
+			case 0x3e: 	instr_ld_r8_imm8(context, 0x3e); 	break;
+			case 0x3f: 	instr_ccf(context, 0x3f); 	break;
+			case 0x40: 	instr_ld_r8_r8(context, 0x40); 	break;
+			case 0x41: 	instr_ld_r8_r8(context, 0x41); 	break;
+			case 0x42: 	instr_ld_r8_r8(context, 0x42); 	break;
+			case 0x43: 	instr_ld_r8_r8(context, 0x43); 	break;
+			case 0x44: 	instr_ld_r8_r8(context, 0x44); 	break;
+			case 0x45: 	instr_ld_r8_r8(context, 0x45); 	break;
+			case 0x46: 	instr_ld_r8_r8(context, 0x46); 	break;
+			case 0x47: 	instr_ld_r8_r8(context, 0x47); 	break;
+			case 0x48: 	instr_ld_r8_r8(context, 0x48); 	break;
+			case 0x49: 	instr_ld_r8_r8(context, 0x49); 	break;
+			case 0x4a: 	instr_ld_r8_r8(context, 0x4a); 	break;
+			case 0x4b: 	instr_ld_r8_r8(context, 0x4b); 	break;
+			case 0x4c: 	instr_ld_r8_r8(context, 0x4c); 	break;
+			case 0x4d: 	instr_ld_r8_r8(context, 0x4d); 	break;
+			case 0x4e: 	instr_ld_r8_r8(context, 0x4e); 	break;
+			case 0x4f: 	instr_ld_r8_r8(context, 0x4f); 	break;
+			case 0x50: 	instr_ld_r8_r8(context, 0x50); 	break;
+			case 0x51: 	instr_ld_r8_r8(context, 0x51); 	break;
+			case 0x52: 	instr_ld_r8_r8(context, 0x52); 	break;
+			case 0x53: 	instr_ld_r8_r8(context, 0x53); 	break;
+			case 0x54: 	instr_ld_r8_r8(context, 0x54); 	break;
+			case 0x55: 	instr_ld_r8_r8(context, 0x55); 	break;
+			case 0x56: 	instr_ld_r8_r8(context, 0x56); 	break;
+			case 0x57: 	instr_ld_r8_r8(context, 0x57); 	break;
+			case 0x58: 	instr_ld_r8_r8(context, 0x58); 	break;
+			case 0x59: 	instr_ld_r8_r8(context, 0x59); 	break;
+			case 0x5a: 	instr_ld_r8_r8(context, 0x5a); 	break;
+			case 0x5b: 	instr_ld_r8_r8(context, 0x5b); 	break;
+			case 0x5c: 	instr_ld_r8_r8(context, 0x5c); 	break;
+			case 0x5d: 	instr_ld_r8_r8(context, 0x5d); 	break;
+			case 0x5e: 	instr_ld_r8_r8(context, 0x5e); 	break;
+			case 0x5f: 	instr_ld_r8_r8(context, 0x5f); 	break;
+			case 0x60: 	instr_ld_r8_r8(context, 0x60); 	break;
+			case 0x61: 	instr_ld_r8_r8(context, 0x61); 	break;
+			case 0x62: 	instr_ld_r8_r8(context, 0x62); 	break;
+			case 0x63: 	instr_ld_r8_r8(context, 0x63); 	break;
+			case 0x64: 	instr_ld_r8_r8(context, 0x64); 	break;
+			case 0x65: 	instr_ld_r8_r8(context, 0x65); 	break;
+			case 0x66: 	instr_ld_r8_r8(context, 0x66); 	break;
+			case 0x67: 	instr_ld_r8_r8(context, 0x67); 	break;
+			case 0x68: 	instr_ld_r8_r8(context, 0x68); 	break;
+			case 0x69: 	instr_ld_r8_r8(context, 0x69); 	break;
+			case 0x6a: 	instr_ld_r8_r8(context, 0x6a); 	break;
+			case 0x6b: 	instr_ld_r8_r8(context, 0x6b); 	break;
+			case 0x6c: 	instr_ld_r8_r8(context, 0x6c); 	break;
+			case 0x6d: 	instr_ld_r8_r8(context, 0x6d); 	break;
+			case 0x6e: 	instr_ld_r8_r8(context, 0x6e); 	break;
+			case 0x6f: 	instr_ld_r8_r8(context, 0x6f); 	break;
+			case 0x70: 	instr_ld_r8_r8(context, 0x70); 	break;
+			case 0x71: 	instr_ld_r8_r8(context, 0x71); 	break;
+			case 0x72: 	instr_ld_r8_r8(context, 0x72); 	break;
+			case 0x73: 	instr_ld_r8_r8(context, 0x73); 	break;
+			case 0x74: 	instr_ld_r8_r8(context, 0x74); 	break;
+			case 0x75: 	instr_ld_r8_r8(context, 0x75); 	break;
+			case 0x76: 	instr_halt(context, 0x76); 	return;
+			case 0x77: 	instr_ld_r8_r8(context, 0x77); 	break;
+			case 0x78: 	instr_ld_r8_r8(context, 0x78); 	DISPATCH_FUSED(0xb1, instr_alu_op_r8); 	break;
+			case 0x79: 	instr_ld_r8_r8(context, 0x79); 	break;
+			case 0x7a: 	instr_ld_r8_r8(context, 0x7a); 	break;
+			case 0x7b: 	instr_ld_r8_r8(context, 0x7b); 	break;
+			case 0x7c: 	instr_ld_r8_r8(context, 0x7c); 	break;
+			case 0x7d: 	instr_ld_r8_r8(context, 0x7d); 	break;
+			case 0x7e: 	instr_ld_r8_r8(context, 0x7e); 	break;
+			case 0x7f: 	instr_ld_r8_r8(context, 0x7f); 	break;
+			case 0x80: 	instr_alu_op_r8(context, 0x80); 	break;
+			case 0x81: 	instr_alu_op_r8(context, 0x81); 	break;
+			case 0x82: 	instr_alu_op_r8(context, 0x82); 	break;
+			case 0x83: 	instr_alu_op_r8(context, 0x83); 	break;
+			case 0x84: 	instr_alu_op_r8(context, 0x84); 	break;
+			case 0x85: 	instr_alu_op_r8(context, 0x85); 	break;
+			case 0x86: 	instr_alu_op_r8(context, 0x86); 	break;
+			case 0x87: 	instr_alu_op_r8(context, 0x87); 	break;
+			case 0x88: 	instr_alu_op_r8(context, 0x88); 	break;
+			case 0x89: 	instr_alu_op_r8(context, 0x89); 	break;
+			case 0x8a: 	instr_alu_op_r8(context, 0x8a); 	break;
+			case 0x8b: 	instr_alu_op_r8(context, 0x8b); 	break;
+			case 0x8c: 	instr_alu_op_r8(context, 0x8c); 	break;
+			case 0x8d: 	instr_alu_op_r8(context, 0x8d); 	break;
+			case 0x8e: 	instr_alu_op_r8(context, 0x8e); 	break;
+			case 0x8f: 	instr_alu_op_r8(context, 0x8f); 	break;
+			case 0x90: 	instr_alu_op_r8(context, 0x90); 	break;
+			case 0x91: 	instr_alu_op_r8(context, 0x91); 	break;
+			case 0x92: 	instr_alu_op_r8(context, 0x92); 	break;
+			case 0x93: 	instr_alu_op_r8(context, 0x93); 	break;
+			case 0x94: 	instr_alu_op_r8(context, 0x94); 	break;
+			case 0x95: 	instr_alu_op_r8(context, 0x95); 	break;
+			case 0x96: 	instr_alu_op_r8(context, 0x96); 	break;
+			case 0x97: 	instr_alu_op_r8(context, 0x97); 	break;
+			case 0x98: 	instr_alu_op_r8(context, 0x98); 	break;
+			case 0x99: 	instr_alu_op_r8(context, 0x99); 	break;
+			case 0x9a: 	instr_alu_op_r8(context, 0x9a); 	break;
+			case 0x9b: 	instr_alu_op_r8(context, 0x9b); 	break;
+			case 0x9c: 	instr_alu_op_r8(context, 0x9c); 	break;
+			case 0x9d: 	instr_alu_op_r8(context, 0x9d); 	break;
+			case 0x9e: 	instr_alu_op_r8(context, 0x9e); 	break;
+			case 0x9f: 	instr_alu_op_r8(context, 0x9f); 	break;
+			case 0xa0: 	instr_alu_op_r8(context, 0xa0); 	break;
+			case 0xa1: 	instr_alu_op_r8(context, 0xa1); 	break;
+			case 0xa2: 	instr_alu_op_r8(context, 0xa2); 	break;
+			case 0xa3: 	instr_alu_op_r8(context, 0xa3); 	break;
+			case 0xa4: 	instr_alu_op_r8(context, 0xa4); 	break;
+			case 0xa5: 	instr_alu_op_r8(context, 0xa5); 	break;
+			case 0xa6: 	instr_alu_op_r8(context, 0xa6); 	break;
+			case 0xa7: 	instr_alu_op_r8(context, 0xa7); 	break;
+			case 0xa8: 	instr_alu_op_r8(context, 0xa8); 	break;
+			case 0xa9: 	instr_alu_op_r8(context, 0xa9); 	break;
+			case 0xaa: 	instr_alu_op_r8(context, 0xaa); 	break;
+			case 0xab: 	instr_alu_op_r8(context, 0xab); 	break;
+			case 0xac: 	instr_alu_op_r8(context, 0xac); 	break;
+			case 0xad: 	instr_alu_op_r8(context, 0xad); 	break;
+			case 0xae: 	instr_alu_op_r8(context, 0xae); 	break;
+			case 0xaf: 	instr_alu_op_r8(context, 0xaf); 	break;
+			case 0xb0: 	instr_alu_op_r8(context, 0xb0); 	break;
+			case 0xb1: 	instr_alu_op_r8(context, 0xb1); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	break;
+			case 0xb2: 	instr_alu_op_r8(context, 0xb2); 	break;
+			case 0xb3: 	instr_alu_op_r8(context, 0xb3); 	break;
+			case 0xb4: 	instr_alu_op_r8(context, 0xb4); 	break;
+			case 0xb5: 	instr_alu_op_r8(context, 0xb5); 	break;
+			case 0xb6: 	instr_alu_op_r8(context, 0xb6); 	break;
+			case 0xb7: 	instr_alu_op_r8(context, 0xb7); 	break;
+			case 0xb8: 	instr_alu_op_r8(context, 0xb8); 	break;
+			case 0xb9: 	instr_alu_op_r8(context, 0xb9); 	break;
+			case 0xba: 	instr_alu_op_r8(context, 0xba); 	break;
+			case 0xbb: 	instr_alu_op_r8(context, 0xbb); 	break;
+			case 0xbc: 	instr_alu_op_r8(context, 0xbc); 	break;
+			case 0xbd: 	instr_alu_op_r8(context, 0xbd); 	break;
+			case 0xbe: 	instr_alu_op_r8(context, 0xbe); 	break;
+			case 0xbf: 	instr_alu_op_r8(context, 0xbf); 	break;
+			case 0xc0: 	instr_ret_cond(context, 0xc0); 	break;
+			case 0xc1: 	instr_pop_r16stk(context, 0xc1); 	break;
+			case 0xc2: 	instr_jp_cond(context, 0xc2); 	break;
+			case 0xc3: 	instr_jp_imm16(context, 0xc3); 	break;
+			case 0xc4: 	instr_call_cond_imm16(context, 0xc4); 	break;
+			case 0xc5: 	instr_push_r16stk(context, 0xc5); 	break;
+			case 0xc6: 	instr_alu_op_imm8(context, 0xc6); 	break;
+			case 0xc7: 	instr_rst_tgt3(context, 0xc7); 	break;
+			case 0xc8: 	instr_ret_cond(context, 0xc8); 	break;
+			case 0xc9: 	instr_ret(context, 0xc9); 	break;
+			case 0xca: 	instr_jp_cond(context, 0xca); 	break;
+			case 0xcb: 	instr_cb_prefix(context, 0xcb); 	break;
+			case 0xcc: 	instr_call_cond_imm16(context, 0xcc); 	break;
+			case 0xcd: 	instr_call_imm16(context, 0xcd); 	break;
+			case 0xce: 	instr_alu_op_imm8(context, 0xce); 	break;
+			case 0xcf: 	instr_rst_tgt3(context, 0xcf); 	break;
+			case 0xd0: 	instr_ret_cond(context, 0xd0); 	break;
+			case 0xd1: 	instr_pop_r16stk(context, 0xd1); 	break;
+			case 0xd2: 	instr_jp_cond(context, 0xd2); 	break;
+			case 0xd3: 	instr_unimplemented(context, 0xd3); 	return;
+			case 0xd4: 	instr_call_cond_imm16(context, 0xd4); 	break;
+			case 0xd5: 	instr_push_r16stk(context, 0xd5); 	break;
+			case 0xd6: 	instr_alu_op_imm8(context, 0xd6); 	break;
+			case 0xd7: 	instr_rst_tgt3(context, 0xd7); 	break;
+			case 0xd8: 	instr_ret_cond(context, 0xd8); 	break;
+			case 0xd9: 	instr_reti(context, 0xd9); 	return;
+			case 0xda: 	instr_jp_cond(context, 0xda); 	break;
+			case 0xdb: 	instr_unimplemented(context, 0xdb); 	return;
+			case 0xdc: 	instr_call_cond_imm16(context, 0xdc); 	break;
+			case 0xdd: 	instr_unimplemented(context, 0xdd); 	return;
+			case 0xde: 	instr_alu_op_imm8(context, 0xde); 	break;
+			case 0xdf: 	instr_rst_tgt3(context, 0xdf); 	break;
+			case 0xe0: 	instr_ldh_imm8mem_a(context, 0xe0); 	break;
+			case 0xe1: 	instr_pop_r16stk(context, 0xe1); 	break;
+			case 0xe2: 	instr_ldh_cmem_a(context, 0xe2); 	break;
+			case 0xe3: 	instr_unimplemented(context, 0xe3); 	return;
+			case 0xe4: 	instr_unimplemented(context, 0xe4); 	return;
+			case 0xe5: 	instr_push_r16stk(context, 0xe5); 	break;
+			case 0xe6: 	instr_alu_op_imm8(context, 0xe6); 	break;
+			case 0xe7: 	instr_rst_tgt3(context, 0xe7); 	break;
+			case 0xe8: 	instr_add_sp_imm8(context, 0xe8); 	break;
+			case 0xe9: 	instr_jp_hl(context, 0xe9); 	break;
+			case 0xea: 	instr_ld_imm16mem_a(context, 0xea); 	break;
+			case 0xeb: 	instr_unimplemented(context, 0xeb); 	return;
+			case 0xec: 	instr_unimplemented(context, 0xec); 	return;
+			case 0xed: 	instr_unimplemented(context, 0xed); 	return;
+			case 0xee: 	instr_alu_op_imm8(context, 0xee); 	break;
+			case 0xef: 	instr_rst_tgt3(context, 0xef); 	break;
+			case 0xf0: 	instr_ldh_a_imm8mem(context, 0xf0); 	DISPATCH_FUSED(0xfe, instr_alu_op_imm8); 	break;
+			case 0xf1: 	instr_pop_r16stk(context, 0xf1); 	break;
+			case 0xf2: 	instr_ldh_a_cmem(context, 0xf2); 	break;
+			case 0xf3: 	instr_di(context, 0xf3); 	return;
+			case 0xf4: 	instr_unimplemented(context, 0xf4); 	return;
+			case 0xf5: 	instr_push_r16stk(context, 0xf5); 	break;
+			case 0xf6: 	instr_alu_op_imm8(context, 0xf6); 	break;
+			case 0xf7: 	instr_rst_tgt3(context, 0xf7); 	break;
+			case 0xf8: 	instr_ld_hl_sp_imm8(context, 0xf8); 	break;
+			case 0xf9: 	instr_ld_sp_hl(context, 0xf9); 	break;
+			case 0xfa: 	instr_ld_a_imm16mem(context, 0xfa); 	break;
+			case 0xfb: 	instr_ei(context, 0xfb); 	return;
+			case 0xfc: 	instr_unimplemented(context, 0xfc); 	return;
+			case 0xfd: 	instr_unimplemented(context, 0xfd); 	return;
+			case 0xfe: 	instr_alu_op_imm8(context, 0xfe); 	DISPATCH_FUSED(0x20, instr_jr_cond_imm8); 	break;
+			case 0xff: 	instr_rst_tgt3(context, 0xff); 	break;
+
+        }
+    }
+#endif
+
+#undef DISPATCH_FUSED
+}
+
+#endif // CPU_THREADED_DISPATCH
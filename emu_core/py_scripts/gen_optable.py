@@ -1,4 +1,5 @@
 import os
+import argparse
 from collections import Counter
 
 InstructionStr = str
@@ -86,6 +87,108 @@ PREFIX_OPFILTERS = {
     '11xxx_xxx': 'instr_set_b3_r8',
 }
 
+# Instruction lengths in bytes (opcode + immediates), later filters override
+# earlier ones.
+OPCODE_LENGTH_FILTERS : dict[BitFilter, int] = {
+    'xxxx_xxxx': 1,
+    '00xx_0001': 3,     # ld r16, imm16
+    '0000_1000': 3,     # ld [imm16], sp
+    '00xx_x110': 2,     # ld r8, imm8
+    '0001_0000': 2,     # stop
+    '0001_1000': 2,     # jr imm8
+    '001x_x000': 2,     # jr cond, imm8
+    '11xx_x110': 2,     # alu imm8
+    '110x_x010': 3,     # jp cond, imm16
+    '1100_0011': 3,     # jp imm16
+    '110x_x100': 3,     # call cond, imm16
+    '1100_1101': 3,     # call imm16
+    '1100_1011': 2,     # cb prefix
+    '1110_0000': 2,     # ldh [imm8], a
+    '1111_0000': 2,     # ldh a, [imm8]
+    '1110_1010': 3,     # ld [imm16], a
+    '1111_1010': 3,     # ld a, [imm16]
+    '1110_1000': 2,     # add sp, imm8
+    '1111_1000': 2,     # ld hl, sp + imm8
+}
+
+# Base M-cycle counts (branch not taken), later filters override earlier ones.
+OPCODE_CYCLE_FILTERS : dict[BitFilter, int] = {
+    'xxxx_xxxx': 1,
+    '00xx_0001': 3,
+    '00xx_0010': 2,
+    '00xx_1010': 2,
+    '0000_1000': 5,
+    '00xx_0011': 2,
+    '00xx_1011': 2,
+    '00xx_1001': 2,
+    '0011_0100': 3,     # inc [hl]
+    '0011_0101': 3,     # dec [hl]
+    '00xx_x110': 2,
+    '0011_0110': 3,     # ld [hl], imm8
+    '0001_1000': 3,
+    '001x_x000': 2,
+    '01xx_x110': 2,     # ld r8, [hl]
+    '0111_0xxx': 2,     # ld [hl], r8
+    '0111_0110': 1,     # halt
+    '10xx_x110': 2,     # alu [hl]
+    '11xx_x110': 2,
+    '110x_x000': 2,
+    '1100_1001': 4,
+    '1101_1001': 4,
+    '110x_x010': 3,
+    '1100_0011': 4,
+    '1110_1001': 1,
+    '110x_x100': 3,
+    '1100_1101': 6,
+    '11xx_x111': 4,
+    '11xx_0001': 3,
+    '11xx_0101': 4,
+    '1100_1011': 0,     # counted by the prefixed instruction
+    '1110_0010': 2,
+    '1110_0000': 3,
+    '1110_1010': 4,
+    '1111_0010': 2,
+    '1111_0000': 3,
+    '1111_1010': 4,
+    '1110_1000': 4,
+    '1111_1000': 3,
+    '1111_1001': 2,
+}
+
+PREFIX_OPCODE_CYCLE_FILTERS : dict[BitFilter, int] = {
+    'xxxx_xxxx': 2,
+    'xxxx_x110': 4,     # [hl] operand
+    '01xx_x110': 3,     # bit b3, [hl]
+}
+
+# Instructions after which a batch in the threaded interpreter returns to
+# the caller, since they change interrupt state or put the CPU to sleep.
+BATCH_BREAKING_INSTRS : set[InstructionStr] = {
+    'instr_halt',
+    'instr_stop',
+    'instr_di',
+    'instr_ei',
+    'instr_reti',
+    'instr_unimplemented',
+}
+
+# Opcode pairs fused into superinstructions when no pair profile is given.
+# Common memcpy/memset/polling loop bodies. Only one pair per first opcode is used.
+DEFAULT_FUSED_PAIRS : list[tuple[int, int]] = [
+    (0x2a, 0x12),   # ld a, [hl+]   ; ld [de], a
+    (0x12, 0x13),   # ld [de], a    ; inc de
+    (0x22, 0x05),   # ld [hl+], a   ; dec b
+    (0x05, 0x20),   # dec b         ; jr nz
+    (0x0d, 0x20),   # dec c         ; jr nz
+    (0x0b, 0x78),   # dec bc        ; ld a, b
+    (0x78, 0xb1),   # ld a, b       ; or c
+    (0xb1, 0x20),   # or c          ; jr nz
+    (0xf0, 0xfe),   # ldh a, [a8]   ; cp imm8
+    (0xfe, 0x20),   # cp imm8       ; jr nz
+]
+
+DEFAULT_FUSED_COUNT = 16
+
 # Recursive helper function to expand the filters
 def generate_expansion(og_str: str, index: int, generated_str, str_set: set):
     if (index == len(og_str)):
@@ -115,7 +218,92 @@ def create_optable(opfilter: dict[BitFilter, InstructionStr]):
             
     return dict(sorted(optable.items()))
 
+def create_table_entries(table: dict[int, object], default) -> str:
+    entries = "\n"
+    for i in range(0, 0x100):
+        entries += f"\t[0x{i:02x}] \t= \t{table.get(i, default)}, \n"
+    return entries
+
+def read_pair_profile(path: str) -> list[tuple[int, int]]:
+    """
+    Reads a pair profile written by `cpu_pair_profile_write`, one
+    `<first> <second> <count>` line per pair (hex opcodes), and returns
+    the pairs sorted by count.
+    """
+    counts : Counter = Counter()
+    with open(path, 'r') as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) != 3:
+                continue
+            counts[(int(fields[0], 16), int(fields[1], 16))] += int(fields[2])
+    
+    return [pair for pair, _ in counts.most_common()]
+
+def select_fused_pairs(pairs: list[tuple[int, int]], optable: dict[int, InstructionStr], 
+                       default: InstructionStr, count: int) -> dict[int, int]:
+    """
+    Picks up to `count` pairs to fuse, keyed by first opcode. Pairs involving
+    the CB prefix or an instruction ending a batch are skipped.
+    """
+    fused = {}
+    for first, second in pairs:
+        if len(fused) == count:
+            break
+        if first in fused or 0xcb in (first, second):
+            continue
+        if any(optable.get(op, default) in BATCH_BREAKING_INSTRS for op in (first, second)):
+            continue
+        fused[first] = second
+    
+    return fused
+
+def create_dispatch(optable: dict[int, InstructionStr], default: InstructionStr, 
+                    fused_pairs: dict[int, int]):
+    labels = "\n"
+    threaded_ops = "\n"
+    switch_cases = "\n"
+    
+    for i in range(0, 0x100):
+        func_name = optable.get(i, default)
+        # Opcode is passed as a constant, so inlined handlers fold their decoding
+        call = f"{func_name}(context, 0x{i:02x});"
+        
+        # Superinstruction, the second handler is inlined right after the first
+        if i in fused_pairs:
+            second = fused_pairs[i]
+            call += f" \tDISPATCH_FUSED(0x{second:02x}, {optable.get(second, default)});"
+        
+        labels += f"\t\t[0x{i:02x}] \t= \t&&op_0x{i:02x}, \n"
+        if func_name in BATCH_BREAKING_INSTRS:
+            threaded_ops += f"op_0x{i:02x}: \t{call} \treturn;\n"
+            switch_cases += f"\t\t\tcase 0x{i:02x}: \t{call} \treturn;\n"
+        else:
+            threaded_ops += f"op_0x{i:02x}: \t{call} \tDISPATCH_NEXT();\n"
+            switch_cases += f"\t\t\tcase 0x{i:02x}: \t{call} \tbreak;\n"
+    
+    return labels, threaded_ops, switch_cases
+
+def create_spec_handlers(optable: dict[int, InstructionStr], default: InstructionStr, prefix: str):
+    handlers = "\n"
+    entries = "\n"
+    
+    for i in range(0, 0x100):
+        func_name = optable.get(i, default)
+        spec_name = f"spec_{prefix}_0x{i:02x}"
+        handlers += (f"SPEC_HANDLER {spec_name}(cpu_context_t *context, uint8_t opcode) "
+                     f"{{ (void) opcode; {func_name}(context, 0x{i:02x}); }}\n")
+        entries += f"\t[0x{i:02x}] \t= \t{spec_name}, \n"
+    
+    return handlers, entries
+
 def main():
+    parser = argparse.ArgumentParser(description='Generates the optables and interpreter loops.')
+    parser.add_argument('--pair-profile', 
+                        help='Opcode pair profile to pick the fused pairs from (see CPU_PAIR_PROFILE)')
+    parser.add_argument('--fuse', type=int, default=DEFAULT_FUSED_COUNT,
+                        help='Maximum number of fused opcode pairs')
+    args = parser.parse_args()
     
     optable = create_optable(OPTABLE_FILTERS)
     prefix_optable = create_optable(PREFIX_OPFILTERS)
@@ -143,10 +331,44 @@ def main():
 
     optable_file = template_file_str.replace("/*OPTABLE*/", replacement_str)
     optable_file = optable_file.replace("/*PREFIX_OPTABLE*/", prefix_entries)
+    optable_file = optable_file.replace("/*OPCODE_LENGTHS*/", 
+                        create_table_entries(create_optable(OPCODE_LENGTH_FILTERS), 1))
+    optable_file = optable_file.replace("/*OPCODE_CYCLES*/", 
+                        create_table_entries(create_optable(OPCODE_CYCLE_FILTERS), 1))
+    optable_file = optable_file.replace("/*PREFIX_OPCODE_CYCLES*/", 
+                        create_table_entries(create_optable(PREFIX_OPCODE_CYCLE_FILTERS), 2))
     
     with open(os.path.join(py_dir, 'optable.h'), 'w') as f:
         f.write(optable_file)
     
+    # Threaded interpreter
+    with open(os.path.join(py_dir, 'template_dispatch.h'), 'r') as f:
+        dispatch_file = f.read()
+    
+    pairs = read_pair_profile(args.pair_profile) if args.pair_profile else DEFAULT_FUSED_PAIRS
+    fused_pairs = select_fused_pairs(pairs, optable, uninmp_func_name, args.fuse)
+    
+    labels, threaded_ops, switch_cases = create_dispatch(optable, uninmp_func_name, fused_pairs)
+    dispatch_file = dispatch_file.replace("/*DISPATCH_LABELS*/", labels)
+    dispatch_file = dispatch_file.replace("/*THREADED_OPS*/", threaded_ops)
+    dispatch_file = dispatch_file.replace("/*SWITCH_CASES*/", switch_cases)
+    
+    with open(os.path.join(py_dir, 'dispatch.h'), 'w') as f:
+        f.write(dispatch_file)
+    
+    # Specialized per-opcode handlers
+    with open(os.path.join(py_dir, 'template_spec_handlers.h'), 'r') as f:
+        spec_file = f.read()
+    
+    handlers, spec_entries = create_spec_handlers(optable, uninmp_func_name, 'op')
+    prefix_handlers, spec_prefix_entries = create_spec_handlers(prefix_optable, uninmp_func_name, 'cb')
+    spec_file = spec_file.replace("/*SPEC_HANDLERS*/", handlers + prefix_handlers)
+    spec_file = spec_file.replace("/*SPEC_OPTABLE*/", spec_entries)
+    spec_file = spec_file.replace("/*SPEC_PREFIX_OPTABLE*/", spec_prefix_entries)
+    
+    with open(os.path.join(py_dir, 'spec_handlers.h'), 'w') as f:
+        f.write(spec_file)
+    
     
 if __name__ == '__main__':
     main()
\ No newline at end of file
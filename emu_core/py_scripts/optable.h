@@ -522,3 +522,786 @@ INSTR_FUNC prefix_optable[256] = {
 	[0xff] 	= 	instr_set_b3_r8, 
 
 };
+
+const uint8_t opcode_lengths[256] = {
+    
+	[0x00] 	= 	1, 
+	[0x01] 	= 	3, 
+	[0x02] 	= 	1, 
+	[0x03] 	= 	1, 
+	[0x04] 	= 	1, 
+	[0x05] 	= 	1, 
+	[0x06] 	= 	2, 
+	[0x07] 	= 	1, 
+	[0x08] 	= 	3, 
+	[0x09] 	= 	1, 
+	[0x0a] 	= 	1, 
+	[0x0b] 	= 	1, 
+	[0x0c] 	= 	1, 
+	[0x0d] 	= 	1, 
+	[0x0e] 	= 	2, 
+	[0x0f] 	= 	1, 
+	[0x10] 	= 	2, 
+	[0x11] 	= 	3, 
+	[0x12] 	= 	1, 
+	[0x13] 	= 	1, 
+	[0x14] 	= 	1, 
+	[0x15] 	= 	1, 
+	[0x16] 	= 	2, 
+	[0x17] 	= 	1, 
+	[0x18] 	= 	2, 
+	[0x19] 	= 	1, 
+	[0x1a] 	= 	1, 
+	[0x1b] 	= 	1, 
+	[0x1c] 	= 	1, 
+	[0x1d] 	= 	1, 
+	[0x1e] 	= 	2, 
+	[0x1f] 	= 	1, 
+	[0x20] 	= 	2, 
+	[0x21] 	= 	3, 
+	[0x22] 	= 	1, 
+	[0x23] 	= 	1, 
+	[0x24] 	= 	1, 
+	[0x25] 	= 	1, 
+	[0x26] 	= 	2, 
+	[0x27] 	= 	1, 
+	[0x28] 	= 	2, 
+	[0x29] 	= 	1, 
+	[0x2a] 	= 	1, 
+	[0x2b] 	= 	1, 
+	[0x2c] 	= 	1, 
+	[0x2d] 	= 	1, 
+	[0x2e] 	= 	2, 
+	[0x2f] 	= 	1, 
+	[0x30] 	= 	2, 
+	[0x31] 	= 	3, 
+	[0x32] 	= 	1, 
+	[0x33] 	= 	1, 
+	[0x34] 	= 	1, 
+	[0x35] 	= 	1, 
+	[0x36] 	= 	2, 
+	[0x37] 	= 	1, 
+	[0x38] 	= 	2, 
+	[0x39] 	= 	1, 
+	[0x3a] 	= 	1, 
+	[0x3b] 	= 	1, 
+	[0x3c] 	= 	1, 
+	[0x3d] 	= 	1, 
+	[0x3e] 	= 	2, 
+	[0x3f] 	= 	1, 
+	[0x40] 	= 	1, 
+	[0x41] 	= 	1, 
+	[0x42] 	= 	1, 
+	[0x43] 	= 	1, 
+	[0x44] 	= 	1, 
+	[0x45] 	= 	1, 
+	[0x46] 	= 	1, 
+	[0x47] 	= 	1, 
+	[0x48] 	= 	1, 
+	[0x49] 	= 	1, 
+	[0x4a] 	= 	1, 
+	[0x4b] 	= 	1, 
+	[0x4c] 	= 	1, 
+	[0x4d] 	= 	1, 
+	[0x4e] 	= 	1, 
+	[0x4f] 	= 	1, 
+	[0x50] 	= 	1, 
+	[0x51] 	= 	1, 
+	[0x52] 	= 	1, 
+	[0x53] 	= 	1, 
+	[0x54] 	= 	1, 
+	[0x55] 	= 	1, 
+	[0x56] 	= 	1, 
+	[0x57] 	= 	1, 
+	[0x58] 	= 	1, 
+	[0x59] 	= 	1, 
+	[0x5a] 	= 	1, 
+	[0x5b] 	= 	1, 
+	[0x5c] 	= 	1, 
+	[0x5d] 	= 	1, 
+	[0x5e] 	= 	1, 
+	[0x5f] 	= 	1, 
+	[0x60] 	= 	1, 
+	[0x61] 	= 	1, 
+	[0x62] 	= 	1, 
+	[0x63] 	= 	1, 
+	[0x64] 	= 	1, 
+	[0x65] 	= 	1, 
+	[0x66] 	= 	1, 
+	[0x67] 	= 	1, 
+	[0x68] 	= 	1, 
+	[0x69] 	= 	1, 
+	[0x6a] 	= 	1, 
+	[0x6b] 	= 	1, 
+	[0x6c] 	= 	1, 
+	[0x6d] 	= 	1, 
+	[0x6e] 	= 	1, 
+	[0x6f] 	= 	1, 
+	[0x70] 	= 	1, 
+	[0x71] 	= 	1, 
+	[0x72] 	= 	1, 
+	[0x73] 	= 	1, 
+	[0x74] 	= 	1, 
+	[0x75] 	= 	1, 
+	[0x76] 	= 	1, 
+	[0x77] 	= 	1, 
+	[0x78] 	= 	1, 
+	[0x79] 	= 	1, 
+	[0x7a] 	= 	1, 
+	[0x7b] 	= 	1, 
+	[0x7c] 	= 	1, 
+	[0x7d] 	= 	1, 
+	[0x7e] 	= 	1, 
+	[0x7f] 	= 	1, 
+	[0x80] 	= 	1, 
+	[0x81] 	= 	1, 
+	[0x82] 	= 	1, 
+	[0x83] 	= 	1, 
+	[0x84] 	= 	1, 
+	[0x85] 	= 	1, 
+	[0x86] 	= 	1, 
+	[0x87] 	= 	1, 
+	[0x88] 	= 	1, 
+	[0x89] 	= 	1, 
+	[0x8a] 	= 	1, 
+	[0x8b] 	= 	1, 
+	[0x8c] 	= 	1, 
+	[0x8d] 	= 	1, 
+	[0x8e] 	= 	1, 
+	[0x8f] 	= 	1, 
+	[0x90] 	= 	1, 
+	[0x91] 	= 	1, 
+	[0x92] 	= 	1, 
+	[0x93] 	= 	1, 
+	[0x94] 	= 	1, 
+	[0x95] 	= 	1, 
+	[0x96] 	= 	1, 
+	[0x97] 	= 	1, 
+	[0x98] 	= 	1, 
+	[0x99] 	= 	1, 
+	[0x9a] 	= 	1, 
+	[0x9b] 	= 	1, 
+	[0x9c] 	= 	1, 
+	[0x9d] 	= 	1, 
+	[0x9e] 	= 	1, 
+	[0x9f] 	= 	1, 
+	[0xa0] 	= 	1, 
+	[0xa1] 	= 	1, 
+	[0xa2] 	= 	1, 
+	[0xa3] 	= 	1, 
+	[0xa4] 	= 	1, 
+	[0xa5] 	= 	1, 
+	[0xa6] 	= 	1, 
+	[0xa7] 	= 	1, 
+	[0xa8] 	= 	1, 
+	[0xa9] 	= 	1, 
+	[0xaa] 	= 	1, 
+	[0xab] 	= 	1, 
+	[0xac] 	= 	1, 
+	[0xad] 	= 	1, 
+	[0xae] 	= 	1, 
+	[0xaf] 	= 	1, 
+	[0xb0] 	= 	1, 
+	[0xb1] 	= 	1, 
+	[0xb2] 	= 	1, 
+	[0xb3] 	= 	1, 
+	[0xb4] 	= 	1, 
+	[0xb5] 	= 	1, 
+	[0xb6] 	= 	1, 
+	[0xb7] 	= 	1, 
+	[0xb8] 	= 	1, 
+	[0xb9] 	= 	1, 
+	[0xba] 	= 	1, 
+	[0xbb] 	= 	1, 
+	[0xbc] 	= 	1, 
+	[0xbd] 	= 	1, 
+	[0xbe] 	= 	1, 
+	[0xbf] 	= 	1, 
+	[0xc0] 	= 	1, 
+	[0xc1] 	= 	1, 
+	[0xc2] 	= 	3, 
+	[0xc3] 	= 	3, 
+	[0xc4] 	= 	3, 
+	[0xc5] 	= 	1, 
+	[0xc6] 	= 	2, 
+	[0xc7] 	= 	1, 
+	[0xc8] 	= 	1, 
+	[0xc9] 	= 	1, 
+	[0xca] 	= 	3, 
+	[0xcb] 	= 	2, 
+	[0xcc] 	= 	3, 
+	[0xcd] 	= 	3, 
+	[0xce] 	= 	2, 
+	[0xcf] 	= 	1, 
+	[0xd0] 	= 	1, 
+	[0xd1] 	= 	1, 
+	[0xd2] 	= 	3, 
+	[0xd3] 	= 	1, 
+	[0xd4] 	= 	3, 
+	[0xd5] 	= 	1, 
+	[0xd6] 	= 	2, 
+	[0xd7] 	= 	1, 
+	[0xd8] 	= 	1, 
+	[0xd9] 	= 	1, 
+	[0xda] 	= 	3, 
+	[0xdb] 	= 	1, 
+	[0xdc] 	= 	3, 
+	[0xdd] 	= 	1, 
+	[0xde] 	= 	2, 
+	[0xdf] 	= 	1, 
+	[0xe0] 	= 	2, 
+	[0xe1] 	= 	1, 
+	[0xe2] 	= 	1, 
+	[0xe3] 	= 	1, 
+	[0xe4] 	= 	1, 
+	[0xe5] 	= 	1, 
+	[0xe6] 	= 	2, 
+	[0xe7] 	= 	1, 
+	[0xe8] 	= 	2, 
+	[0xe9] 	= 	1, 
+	[0xea] 	= 	3, 
+	[0xeb] 	= 	1, 
+	[0xec] 	= 	1, 
+	[0xed] 	= 	1, 
+	[0xee] 	= 	2, 
+	[0xef] 	= 	1, 
+	[0xf0] 	= 	2, 
+	[0xf1] 	= 	1, 
+	[0xf2] 	= 	1, 
+	[0xf3] 	= 	1, 
+	[0xf4] 	= 	1, 
+	[0xf5] 	= 	1, 
+	[0xf6] 	= 	2, 
+	[0xf7] 	= 	1, 
+	[0xf8] 	= 	2, 
+	[0xf9] 	= 	1, 
+	[0xfa] 	= 	3, 
+	[0xfb] 	= 	1, 
+	[0xfc] 	= 	1, 
+	[0xfd] 	= 	1, 
+	[0xfe] 	= 	2, 
+	[0xff] 	= 	1, 
+
+};
+
+const uint8_t opcode_cycles[256] = {
+    
+	[0x00] 	= 	1, 
+	[0x01] 	= 	3, 
+	[0x02] 	= 	2, 
+	[0x03] 	= 	2, 
+	[0x04] 	= 	1, 
+	[0x05] 	= 	1, 
+	[0x06] 	= 	2, 
+	[0x07] 	= 	1, 
+	[0x08] 	= 	5, 
+	[0x09] 	= 	2, 
+	[0x0a] 	= 	2, 
+	[0x0b] 	= 	2, 
+	[0x0c] 	= 	1, 
+	[0x0d] 	= 	1, 
+	[0x0e] 	= 	2, 
+	[0x0f] 	= 	1, 
+	[0x10] 	= 	1, 
+	[0x11] 	= 	3, 
+	[0x12] 	= 	2, 
+	[0x13] 	= 	2, 
+	[0x14] 	= 	1, 
+	[0x15] 	= 	1, 
+	[0x16] 	= 	2, 
+	[0x17] 	= 	1, 
+	[0x18] 	= 	3, 
+	[0x19] 	= 	2, 
+	[0x1a] 	= 	2, 
+	[0x1b] 	= 	2, 
+	[0x1c] 	= 	1, 
+	[0x1d] 	= 	1, 
+	[0x1e] 	= 	2, 
+	[0x1f] 	= 	1, 
+	[0x20] 	= 	2, 
+	[0x21] 	= 	3, 
+	[0x22] 	= 	2, 
+	[0x23] 	= 	2, 
+	[0x24] 	= 	1, 
+	[0x25] 	= 	1, 
+	[0x26] 	= 	2, 
+	[0x27] 	= 	1, 
+	[0x28] 	= 	2, 
+	[0x29] 	= 	2, 
+	[0x2a] 	= 	2, 
+	[0x2b] 	= 	2, 
+	[0x2c] 	= 	1, 
+	[0x2d] 	= 	1, 
+	[0x2e] 	= 	2, 
+	[0x2f] 	= 	1, 
+	[0x30] 	= 	2, 
+	[0x31] 	= 	3, 
+	[0x32] 	= 	2, 
+	[0x33] 	= 	2, 
+	[0x34] 	= 	3, 
+	[0x35] 	= 	3, 
+	[0x36] 	= 	3, 
+	[0x37] 	= 	1, 
+	[0x38] 	= 	2, 
+	[0x39] 	= 	2, 
+	[0x3a] 	= 	2, 
+	[0x3b] 	= 	2, 
+	[0x3c] 	= 	1, 
+	[0x3d] 	= 	1, 
+	[0x3e] 	= 	2, 
+	[0x3f] 	= 	1, 
+	[0x40] 	= 	1, 
+	[0x41] 	= 	1, 
+	[0x42] 	= 	1, 
+	[0x43] 	= 	1, 
+	[0x44] 	= 	1, 
+	[0x45] 	= 	1, 
+	[0x46] 	= 	2, 
+	[0x47] 	= 	1, 
+	[0x48] 	= 	1, 
+	[0x49] 	= 	1, 
+	[0x4a] 	= 	1, 
+	[0x4b] 	= 	1, 
+	[0x4c] 	= 	1, 
+	[0x4d] 	= 	1, 
+	[0x4e] 	= 	2, 
+	[0x4f] 	= 	1, 
+	[0x50] 	= 	1, 
+	[0x51] 	= 	1, 
+	[0x52] 	= 	1, 
+	[0x53] 	= 	1, 
+	[0x54] 	= 	1, 
+	[0x55] 	= 	1, 
+	[0x56] 	= 	2, 
+	[0x57] 	= 	1, 
+	[0x58] 	= 	1, 
+	[0x59] 	= 	1, 
+	[0x5a] 	= 	1, 
+	[0x5b] 	= 	1, 
+	[0x5c] 	= 	1, 
+	[0x5d] 	= 	1, 
+	[0x5e] 	= 	2, 
+	[0x5f] 	= 	1, 
+	[0x60] 	= 	1, 
+	[0x61] 	= 	1, 
+	[0x62] 	= 	1, 
+	[0x63] 	= 	1, 
+	[0x64] 	= 	1, 
+	[0x65] 	= 	1, 
+	[0x66] 	= 	2, 
+	[0x67] 	= 	1, 
+	[0x68] 	= 	1, 
+	[0x69] 	= 	1, 
+	[0x6a] 	= 	1, 
+	[0x6b] 	= 	1, 
+	[0x6c] 	= 	1, 
+	[0x6d] 	= 	1, 
+	[0x6e] 	= 	2, 
+	[0x6f] 	= 	1, 
+	[0x70] 	= 	2, 
+	[0x71] 	= 	2, 
+	[0x72] 	= 	2, 
+	[0x73] 	= 	2, 
+	[0x74] 	= 	2, 
+	[0x75] 	= 	2, 
+	[0x76] 	= 	1, 
+	[0x77] 	= 	2, 
+	[0x78] 	= 	1, 
+	[0x79] 	= 	1, 
+	[0x7a] 	= 	1, 
+	[0x7b] 	= 	1, 
+	[0x7c] 	= 	1, 
+	[0x7d] 	= 	1, 
+	[0x7e] 	= 	2, 
+	[0x7f] 	= 	1, 
+	[0x80] 	= 	1, 
+	[0x81] 	= 	1, 
+	[0x82] 	= 	1, 
+	[0x83] 	= 	1, 
+	[0x84] 	= 	1, 
+	[0x85] 	= 	1, 
+	[0x86] 	= 	2, 
+	[0x87] 	= 	1, 
+	[0x88] 	= 	1, 
+	[0x89] 	= 	1, 
+	[0x8a] 	= 	1, 
+	[0x8b] 	= 	1, 
+	[0x8c] 	= 	1, 
+	[0x8d] 	= 	1, 
+	[0x8e] 	= 	2, 
+	[0x8f] 	= 	1, 
+	[0x90] 	= 	1, 
+	[0x91] 	= 	1, 
+	[0x92] 	= 	1, 
+	[0x93] 	= 	1, 
+	[0x94] 	= 	1, 
+	[0x95] 	= 	1, 
+	[0x96] 	= 	2, 
+	[0x97] 	= 	1, 
+	[0x98] 	= 	1, 
+	[0x99] 	= 	1, 
+	[0x9a] 	= 	1, 
+	[0x9b] 	= 	1, 
+	[0x9c] 	= 	1, 
+	[0x9d] 	= 	1, 
+	[0x9e] 	= 	2, 
+	[0x9f] 	= 	1, 
+	[0xa0] 	= 	1, 
+	[0xa1] 	= 	1, 
+	[0xa2] 	= 	1, 
+	[0xa3] 	= 	1, 
+	[0xa4] 	= 	1, 
+	[0xa5] 	= 	1, 
+	[0xa6] 	= 	2, 
+	[0xa7] 	= 	1, 
+	[0xa8] 	= 	1, 
+	[0xa9] 	= 	1, 
+	[0xaa] 	= 	1, 
+	[0xab] 	= 	1, 
+	[0xac] 	= 	1, 
+	[0xad] 	= 	1, 
+	[0xae] 	= 	2, 
+	[0xaf] 	= 	1, 
+	[0xb0] 	= 	1, 
+	[0xb1] 	= 	1, 
+	[0xb2] 	= 	1, 
+	[0xb3] 	= 	1, 
+	[0xb4] 	= 	1, 
+	[0xb5] 	= 	1, 
+	[0xb6] 	= 	2, 
+	[0xb7] 	= 	1, 
+	[0xb8] 	= 	1, 
+	[0xb9] 	= 	1, 
+	[0xba] 	= 	1, 
+	[0xbb] 	= 	1, 
+	[0xbc] 	= 	1, 
+	[0xbd] 	= 	1, 
+	[0xbe] 	= 	2, 
+	[0xbf] 	= 	1, 
+	[0xc0] 	= 	2, 
+	[0xc1] 	= 	3, 
+	[0xc2] 	= 	3, 
+	[0xc3] 	= 	4, 
+	[0xc4] 	= 	3, 
+	[0xc5] 	= 	4, 
+	[0xc6] 	= 	2, 
+	[0xc7] 	= 	4, 
+	[0xc8] 	= 	2, 
+	[0xc9] 	= 	4, 
+	[0xca] 	= 	3, 
+	[0xcb] 	= 	0, 
+	[0xcc] 	= 	3, 
+	[0xcd] 	= 	6, 
+	[0xce] 	= 	2, 
+	[0xcf] 	= 	4, 
+	[0xd0] 	= 	2, 
+	[0xd1] 	= 	3, 
+	[0xd2] 	= 	3, 
+	[0xd3] 	= 	1, 
+	[0xd4] 	= 	3, 
+	[0xd5] 	= 	4, 
+	[0xd6] 	= 	2, 
+	[0xd7] 	= 	4, 
+	[0xd8] 	= 	2, 
+	[0xd9] 	= 	4, 
+	[0xda] 	= 	3, 
+	[0xdb] 	= 	1, 
+	[0xdc] 	= 	3, 
+	[0xdd] 	= 	1, 
+	[0xde] 	= 	2, 
+	[0xdf] 	= 	4, 
+	[0xe0] 	= 	3, 
+	[0xe1] 	= 	3, 
+	[0xe2] 	= 	2, 
+	[0xe3] 	= 	1, 
+	[0xe4] 	= 	1, 
+	[0xe5] 	= 	4, 
+	[0xe6] 	= 	2, 
+	[0xe7] 	= 	4, 
+	[0xe8] 	= 	4, 
+	[0xe9] 	= 	1, 
+	[0xea] 	= 	4, 
+	[0xeb] 	= 	1, 
+	[0xec] 	= 	1, 
+	[0xed] 	= 	1, 
+	[0xee] 	= 	2, 
+	[0xef] 	= 	4, 
+	[0xf0] 	= 	3, 
+	[0xf1] 	= 	3, 
+	[0xf2] 	= 	2, 
+	[0xf3] 	= 	1, 
+	[0xf4] 	= 	1, 
+	[0xf5] 	= 	4, 
+	[0xf6] 	= 	2, 
+	[0xf7] 	= 	4, 
+	[0xf8] 	= 	3, 
+	[0xf9] 	= 	2, 
+	[0xfa] 	= 	4, 
+	[0xfb] 	= 	1, 
+	[0xfc] 	= 	1, 
+	[0xfd] 	= 	1, 
+	[0xfe] 	= 	2, 
+	[0xff] 	= 	4, 
+
+};
+
+const uint8_t prefix_opcode_cycles[256] = {
+    
+	[0x00] 	= 	2, 
+	[0x01] 	= 	2, 
+	[0x02] 	= 	2, 
+	[0x03] 	= 	2, 
+	[0x04] 	= 	2, 
+	[0x05] 	= 	2, 
+	[0x06] 	= 	4, 
+	[0x07] 	= 	2, 
+	[0x08] 	= 	2, 
+	[0x09] 	= 	2, 
+	[0x0a] 	= 	2, 
+	[0x0b] 	= 	2, 
+	[0x0c] 	= 	2, 
+	[0x0d] 	= 	2, 
+	[0x0e] 	= 	4, 
+	[0x0f] 	= 	2, 
+	[0x10] 	= 	2, 
+	[0x11] 	= 	2, 
+	[0x12] 	= 	2, 
+	[0x13] 	= 	2, 
+	[0x14] 	= 	2, 
+	[0x15] 	= 	2, 
+	[0x16] 	= 	4, 
+	[0x17] 	= 	2, 
+	[0x18] 	= 	2, 
+	[0x19] 	= 	2, 
+	[0x1a] 	= 	2, 
+	[0x1b] 	= 	2, 
+	[0x1c] 	= 	2, 
+	[0x1d] 	= 	2, 
+	[0x1e] 	= 	4, 
+	[0x1f] 	= 	2, 
+	[0x20] 	= 	2, 
+	[0x21] 	= 	2, 
+	[0x22] 	= 	2, 
+	[0x23] 	= 	2, 
+	[0x24] 	= 	2, 
+	[0x25] 	= 	2, 
+	[0x26] 	= 	4, 
+	[0x27] 	= 	2, 
+	[0x28] 	= 	2, 
+	[0x29] 	= 	2, 
+	[0x2a] 	= 	2, 
+	[0x2b] 	= 	2, 
+	[0x2c] 	= 	2, 
+	[0x2d] 	= 	2, 
+	[0x2e] 	= 	4, 
+	[0x2f] 	= 	2, 
+	[0x30] 	= 	2, 
+	[0x31] 	= 	2, 
+	[0x32] 	= 	2, 
+	[0x33] 	= 	2, 
+	[0x34] 	= 	2, 
+	[0x35] 	= 	2, 
+	[0x36] 	= 	4, 
+	[0x37] 	= 	2, 
+	[0x38] 	= 	2, 
+	[0x39] 	= 	2, 
+	[0x3a] 	= 	2, 
+	[0x3b] 	= 	2, 
+	[0x3c] 	= 	2, 
+	[0x3d] 	= 	2, 
+	[0x3e] 	= 	4, 
+	[0x3f] 	= 	2, 
+	[0x40] 	= 	2, 
+	[0x41] 	= 	2, 
+	[0x42] 	= 	2, 
+	[0x43] 	= 	2, 
+	[0x44] 	= 	2, 
+	[0x45] 	= 	2, 
+	[0x46] 	= 	3, 
+	[0x47] 	= 	2, 
+	[0x48] 	= 	2, 
+	[0x49] 	= 	2, 
+	[0x4a] 	= 	2, 
+	[0x4b] 	= 	2, 
+	[0x4c] 	= 	2, 
+	[0x4d] 	= 	2, 
+	[0x4e] 	= 	3, 
+	[0x4f] 	= 	2, 
+	[0x50] 	= 	2, 
+	[0x51] 	= 	2, 
+	[0x52] 	= 	2, 
+	[0x53] 	= 	2, 
+	[0x54] 	= 	2, 
+	[0x55] 	= 	2, 
+	[0x56] 	= 	3, 
+	[0x57] 	= 	2, 
+	[0x58] 	= 	2, 
+	[0x59] 	= 	2, 
+	[0x5a] 	= 	2, 
+	[0x5b] 	= 	2, 
+	[0x5c] 	= 	2, 
+	[0x5d] 	= 	2, 
+	[0x5e] 	= 	3, 
+	[0x5f] 	= 	2, 
+	[0x60] 	= 	2, 
+	[0x61] 	= 	2, 
+	[0x62] 	= 	2, 
+	[0x63] 	= 	2, 
+	[0x64] 	= 	2, 
+	[0x65] 	= 	2, 
+	[0x66] 	= 	3, 
+	[0x67] 	= 	2, 
+	[0x68] 	= 	2, 
+	[0x69] 	= 	2, 
+	[0x6a] 	= 	2, 
+	[0x6b] 	= 	2, 
+	[0x6c] 	= 	2, 
+	[0x6d] 	= 	2, 
+	[0x6e] 	= 	3, 
+	[0x6f] 	= 	2, 
+	[0x70] 	= 	2, 
+	[0x71] 	= 	2, 
+	[0x72] 	= 	2, 
+	[0x73] 	= 	2, 
+	[0x74] 	= 	2, 
+	[0x75] 	= 	2, 
+	[0x76] 	= 	3, 
+	[0x77] 	= 	2, 
+	[0x78] 	= 	2, 
+	[0x79] 	= 	2, 
+	[0x7a] 	= 	2, 
+	[0x7b] 	= 	2, 
+	[0x7c] 	= 	2, 
+	[0x7d] 	= 	2, 
+	[0x7e] 	= 	3, 
+	[0x7f] 	= 	2, 
+	[0x80] 	= 	2, 
+	[0x81] 	= 	2, 
+	[0x82] 	= 	2, 
+	[0x83] 	= 	2, 
+	[0x84] 	= 	2, 
+	[0x85] 	= 	2, 
+	[0x86] 	= 	4, 
+	[0x87] 	= 	2, 
+	[0x88] 	= 	2, 
+	[0x89] 	= 	2, 
+	[0x8a] 	= 	2, 
+	[0x8b] 	= 	2, 
+	[0x8c] 	= 	2, 
+	[0x8d] 	= 	2, 
+	[0x8e] 	= 	4, 
+	[0x8f] 	= 	2, 
+	[0x90] 	= 	2, 
+	[0x91] 	= 	2, 
+	[0x92] 	= 	2, 
+	[0x93] 	= 	2, 
+	[0x94] 	= 	2, 
+	[0x95] 	= 	2, 
+	[0x96] 	= 	4, 
+	[0x97] 	= 	2, 
+	[0x98] 	= 	2, 
+	[0x99] 	= 	2, 
+	[0x9a] 	= 	2, 
+	[0x9b] 	= 	2, 
+	[0x9c] 	= 	2, 
+	[0x9d] 	= 	2, 
+	[0x9e] 	= 	4, 
+	[0x9f] 	= 	2, 
+	[0xa0] 	= 	2, 
+	[0xa1] 	= 	2, 
+	[0xa2] 	= 	2, 
+	[0xa3] 	= 	2, 
+	[0xa4] 	= 	2, 
+	[0xa5] 	= 	2, 
+	[0xa6] 	= 	4, 
+	[0xa7] 	= 	2, 
+	[0xa8] 	= 	2, 
+	[0xa9] 	= 	2, 
+	[0xaa] 	= 	2, 
+	[0xab] 	= 	2, 
+	[0xac] 	= 	2, 
+	[0xad] 	= 	2, 
+	[0xae] 	= 	4, 
+	[0xaf] 	= 	2, 
+	[0xb0] 	= 	2, 
+	[0xb1] 	= 	2, 
+	[0xb2] 	= 	2, 
+	[0xb3] 	= 	2, 
+	[0xb4] 	= 	2, 
+	[0xb5] 	= 	2, 
+	[0xb6] 	= 	4, 
+	[0xb7] 	= 	2, 
+	[0xb8] 	= 	2, 
+	[0xb9] 	= 	2, 
+	[0xba] 	= 	2, 
+	[0xbb] 	= 	2, 
+	[0xbc] 	= 	2, 
+	[0xbd] 	= 	2, 
+	[0xbe] 	= 	4, 
+	[0xbf] 	= 	2, 
+	[0xc0] 	= 	2, 
+	[0xc1] 	= 	2, 
+	[0xc2] 	= 	2, 
+	[0xc3] 	= 	2, 
+	[0xc4] 	= 	2, 
+	[0xc5] 	= 	2, 
+	[0xc6] 	= 	4, 
+	[0xc7] 	= 	2, 
+	[0xc8] 	= 	2, 
+	[0xc9] 	= 	2, 
+	[0xca] 	= 	2, 
+	[0xcb] 	= 	2, 
+	[0xcc] 	= 	2, 
+	[0xcd] 	= 	2, 
+	[0xce] 	= 	4, 
+	[0xcf] 	= 	2, 
+	[0xd0] 	= 	2, 
+	[0xd1] 	= 	2, 
+	[0xd2] 	= 	2, 
+	[0xd3] 	= 	2, 
+	[0xd4] 	= 	2, 
+	[0xd5] 	= 	2, 
+	[0xd6] 	= 	4, 
+	[0xd7] 	= 	2, 
+	[0xd8] 	= 	2, 
+	[0xd9] 	= 	2, 
+	[0xda] 	= 	2, 
+	[0xdb] 	= 	2, 
+	[0xdc] 	= 	2, 
+	[0xdd] 	= 	2, 
+	[0xde] 	= 	4, 
+	[0xdf] 	= 	2, 
+	[0xe0] 	= 	2, 
+	[0xe1] 	= 	2, 
+	[0xe2] 	= 	2, 
+	[0xe3] 	= 	2, 
+	[0xe4] 	= 	2, 
+	[0xe5] 	= 	2, 
+	[0xe6] 	= 	4, 
+	[0xe7] 	= 	2, 
+	[0xe8] 	= 	2, 
+	[0xe9] 	= 	2, 
+	[0xea] 	= 	2, 
+	[0xeb] 	= 	2, 
+	[0xec] 	= 	2, 
+	[0xed] 	= 	2, 
+	[0xee] 	= 	4, 
+	[0xef] 	= 	2, 
+	[0xf0] 	= 	2, 
+	[0xf1] 	= 	2, 
+	[0xf2] 	= 	2, 
+	[0xf3] 	= 	2, 
+	[0xf4] 	= 	2, 
+	[0xf5] 	= 	2, 
+	[0xf6] 	= 	4, 
+	[0xf7] 	= 	2, 
+	[0xf8] 	= 	2, 
+	[0xf9] 	= 	2, 
+	[0xfa] 	= 	2, 
+	[0xfb] 	= 	2, 
+	[0xfc] 	= 	2, 
+	[0xfd] 	= 	2, 
+	[0xfe] 	= 	4, 
+	[0xff] 	= 	2, 
+
+};
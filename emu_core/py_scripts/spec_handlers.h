@@ -0,0 +1,1059 @@
+/*
+    Specialized handlers, generated by gen_optable.py from `template_spec_handlers.h`.
+    
+    One function per concrete opcode (both the main and the CB page), each calling
+    its generic handler with a constant opcode. The whole call tree is flattened
+    into the wrapper, so register, bit index and ALU op decoding fold away.
+    Included at the end of cpu_instrs.c.
+*/
+#include <cpu_instrs.h>
+
+#if CPU_SPECIALIZED_HANDLERS
+
+#if defined(__GNUC__)
+#define SPEC_HANDLER static __attribute__((flatten)) void
+#else
+#define SPEC_HANDLER static void
+#endif
+
+
+SPEC_HANDLER spec_op_0x00(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_nop(context, 0x00); }
+SPEC_HANDLER spec_op_0x01(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16_imm16(context, 0x01); }
+SPEC_HANDLER spec_op_0x02(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16mem_a(context, 0x02); }
+SPEC_HANDLER spec_op_0x03(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r16(context, 0x03); }
+SPEC_HANDLER spec_op_0x04(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x04); }
+SPEC_HANDLER spec_op_0x05(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x05); }
+SPEC_HANDLER spec_op_0x06(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x06); }
+SPEC_HANDLER spec_op_0x07(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlca(context, 0x07); }
+SPEC_HANDLER spec_op_0x08(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_imm16mem_sp(context, 0x08); }
+SPEC_HANDLER spec_op_0x09(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_add_hl_r16(context, 0x09); }
+SPEC_HANDLER spec_op_0x0a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_a_r16mem(context, 0x0a); }
+SPEC_HANDLER spec_op_0x0b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r16(context, 0x0b); }
+SPEC_HANDLER spec_op_0x0c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x0c); }
+SPEC_HANDLER spec_op_0x0d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x0d); }
+SPEC_HANDLER spec_op_0x0e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x0e); }
+SPEC_HANDLER spec_op_0x0f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrca(context, 0x0f); }
+SPEC_HANDLER spec_op_0x10(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_stop(context, 0x10); }
+SPEC_HANDLER spec_op_0x11(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16_imm16(context, 0x11); }
+SPEC_HANDLER spec_op_0x12(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16mem_a(context, 0x12); }
+SPEC_HANDLER spec_op_0x13(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r16(context, 0x13); }
+SPEC_HANDLER spec_op_0x14(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x14); }
+SPEC_HANDLER spec_op_0x15(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x15); }
+SPEC_HANDLER spec_op_0x16(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x16); }
+SPEC_HANDLER spec_op_0x17(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rla(context, 0x17); }
+SPEC_HANDLER spec_op_0x18(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jr_imm8(context, 0x18); }
+SPEC_HANDLER spec_op_0x19(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_add_hl_r16(context, 0x19); }
+SPEC_HANDLER spec_op_0x1a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_a_r16mem(context, 0x1a); }
+SPEC_HANDLER spec_op_0x1b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r16(context, 0x1b); }
+SPEC_HANDLER spec_op_0x1c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x1c); }
+SPEC_HANDLER spec_op_0x1d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x1d); }
+SPEC_HANDLER spec_op_0x1e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x1e); }
+SPEC_HANDLER spec_op_0x1f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rra(context, 0x1f); }
+SPEC_HANDLER spec_op_0x20(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jr_cond_imm8(context, 0x20); }
+SPEC_HANDLER spec_op_0x21(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16_imm16(context, 0x21); }
+SPEC_HANDLER spec_op_0x22(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16mem_a(context, 0x22); }
+SPEC_HANDLER spec_op_0x23(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r16(context, 0x23); }
+SPEC_HANDLER spec_op_0x24(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x24); }
+SPEC_HANDLER spec_op_0x25(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x25); }
+SPEC_HANDLER spec_op_0x26(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x26); }
+SPEC_HANDLER spec_op_0x27(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_daa(context, 0x27); }
+SPEC_HANDLER spec_op_0x28(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jr_cond_imm8(context, 0x28); }
+SPEC_HANDLER spec_op_0x29(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_add_hl_r16(context, 0x29); }
+SPEC_HANDLER spec_op_0x2a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_a_r16mem(context, 0x2a); }
+SPEC_HANDLER spec_op_0x2b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r16(context, 0x2b); }
+SPEC_HANDLER spec_op_0x2c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x2c); }
+SPEC_HANDLER spec_op_0x2d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x2d); }
+SPEC_HANDLER spec_op_0x2e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x2e); }
+SPEC_HANDLER spec_op_0x2f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_cpl(context, 0x2f); }
+SPEC_HANDLER spec_op_0x30(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jr_cond_imm8(context, 0x30); }
+SPEC_HANDLER spec_op_0x31(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16_imm16(context, 0x31); }
+SPEC_HANDLER spec_op_0x32(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r16mem_a(context, 0x32); }
+SPEC_HANDLER spec_op_0x33(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r16(context, 0x33); }
+SPEC_HANDLER spec_op_0x34(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x34); }
+SPEC_HANDLER spec_op_0x35(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x35); }
+SPEC_HANDLER spec_op_0x36(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x36); }
+SPEC_HANDLER spec_op_0x37(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_scf(context, 0x37); }
+SPEC_HANDLER spec_op_0x38(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jr_cond_imm8(context, 0x38); }
+SPEC_HANDLER spec_op_0x39(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_add_hl_r16(context, 0x39); }
+SPEC_HANDLER spec_op_0x3a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_a_r16mem(context, 0x3a); }
+SPEC_HANDLER spec_op_0x3b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r16(context, 0x3b); }
+SPEC_HANDLER spec_op_0x3c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_inc_r8(context, 0x3c); }
+SPEC_HANDLER spec_op_0x3d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_dec_r8(context, 0x3d); }
+SPEC_HANDLER spec_op_0x3e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_imm8(context, 0x3e); }
+SPEC_HANDLER spec_op_0x3f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ccf(context, 0x3f); }
+SPEC_HANDLER spec_op_0x40(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x40); }
+SPEC_HANDLER spec_op_0x41(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x41); }
+SPEC_HANDLER spec_op_0x42(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x42); }
+SPEC_HANDLER spec_op_0x43(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x43); }
+SPEC_HANDLER spec_op_0x44(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x44); }
+SPEC_HANDLER spec_op_0x45(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x45); }
+SPEC_HANDLER spec_op_0x46(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x46); }
+SPEC_HANDLER spec_op_0x47(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x47); }
+SPEC_HANDLER spec_op_0x48(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x48); }
+SPEC_HANDLER spec_op_0x49(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x49); }
+SPEC_HANDLER spec_op_0x4a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x4a); }
+SPEC_HANDLER spec_op_0x4b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x4b); }
+SPEC_HANDLER spec_op_0x4c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x4c); }
+SPEC_HANDLER spec_op_0x4d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x4d); }
+SPEC_HANDLER spec_op_0x4e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x4e); }
+SPEC_HANDLER spec_op_0x4f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x4f); }
+SPEC_HANDLER spec_op_0x50(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x50); }
+SPEC_HANDLER spec_op_0x51(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x51); }
+SPEC_HANDLER spec_op_0x52(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x52); }
+SPEC_HANDLER spec_op_0x53(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x53); }
+SPEC_HANDLER spec_op_0x54(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x54); }
+SPEC_HANDLER spec_op_0x55(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x55); }
+SPEC_HANDLER spec_op_0x56(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x56); }
+SPEC_HANDLER spec_op_0x57(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x57); }
+SPEC_HANDLER spec_op_0x58(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x58); }
+SPEC_HANDLER spec_op_0x59(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x59); }
+SPEC_HANDLER spec_op_0x5a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x5a); }
+SPEC_HANDLER spec_op_0x5b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x5b); }
+SPEC_HANDLER spec_op_0x5c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x5c); }
+SPEC_HANDLER spec_op_0x5d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x5d); }
+SPEC_HANDLER spec_op_0x5e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x5e); }
+SPEC_HANDLER spec_op_0x5f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x5f); }
+SPEC_HANDLER spec_op_0x60(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x60); }
+SPEC_HANDLER spec_op_0x61(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x61); }
+SPEC_HANDLER spec_op_0x62(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x62); }
+SPEC_HANDLER spec_op_0x63(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x63); }
+SPEC_HANDLER spec_op_0x64(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x64); }
+SPEC_HANDLER spec_op_0x65(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x65); }
+SPEC_HANDLER spec_op_0x66(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x66); }
+SPEC_HANDLER spec_op_0x67(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x67); }
+SPEC_HANDLER spec_op_0x68(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x68); }
+SPEC_HANDLER spec_op_0x69(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x69); }
+SPEC_HANDLER spec_op_0x6a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x6a); }
+SPEC_HANDLER spec_op_0x6b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x6b); }
+SPEC_HANDLER spec_op_0x6c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x6c); }
+SPEC_HANDLER spec_op_0x6d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x6d); }
+SPEC_HANDLER spec_op_0x6e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x6e); }
+SPEC_HANDLER spec_op_0x6f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x6f); }
+SPEC_HANDLER spec_op_0x70(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x70); }
+SPEC_HANDLER spec_op_0x71(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x71); }
+SPEC_HANDLER spec_op_0x72(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x72); }
+SPEC_HANDLER spec_op_0x73(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x73); }
+SPEC_HANDLER spec_op_0x74(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x74); }
+SPEC_HANDLER spec_op_0x75(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x75); }
+SPEC_HANDLER spec_op_0x76(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_halt(context, 0x76); }
+SPEC_HANDLER spec_op_0x77(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x77); }
+SPEC_HANDLER spec_op_0x78(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x78); }
+SPEC_HANDLER spec_op_0x79(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x79); }
+SPEC_HANDLER spec_op_0x7a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x7a); }
+SPEC_HANDLER spec_op_0x7b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x7b); }
+SPEC_HANDLER spec_op_0x7c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x7c); }
+SPEC_HANDLER spec_op_0x7d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x7d); }
+SPEC_HANDLER spec_op_0x7e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x7e); }
+SPEC_HANDLER spec_op_0x7f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_r8_r8(context, 0x7f); }
+SPEC_HANDLER spec_op_0x80(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x80); }
+SPEC_HANDLER spec_op_0x81(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x81); }
+SPEC_HANDLER spec_op_0x82(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x82); }
+SPEC_HANDLER spec_op_0x83(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x83); }
+SPEC_HANDLER spec_op_0x84(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x84); }
+SPEC_HANDLER spec_op_0x85(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x85); }
+SPEC_HANDLER spec_op_0x86(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x86); }
+SPEC_HANDLER spec_op_0x87(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x87); }
+SPEC_HANDLER spec_op_0x88(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x88); }
+SPEC_HANDLER spec_op_0x89(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x89); }
+SPEC_HANDLER spec_op_0x8a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x8a); }
+SPEC_HANDLER spec_op_0x8b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x8b); }
+SPEC_HANDLER spec_op_0x8c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x8c); }
+SPEC_HANDLER spec_op_0x8d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x8d); }
+SPEC_HANDLER spec_op_0x8e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x8e); }
+SPEC_HANDLER spec_op_0x8f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x8f); }
+SPEC_HANDLER spec_op_0x90(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x90); }
+SPEC_HANDLER spec_op_0x91(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x91); }
+SPEC_HANDLER spec_op_0x92(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x92); }
+SPEC_HANDLER spec_op_0x93(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x93); }
+SPEC_HANDLER spec_op_0x94(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x94); }
+SPEC_HANDLER spec_op_0x95(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x95); }
+SPEC_HANDLER spec_op_0x96(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x96); }
+SPEC_HANDLER spec_op_0x97(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x97); }
+SPEC_HANDLER spec_op_0x98(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x98); }
+SPEC_HANDLER spec_op_0x99(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x99); }
+SPEC_HANDLER spec_op_0x9a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x9a); }
+SPEC_HANDLER spec_op_0x9b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x9b); }
+SPEC_HANDLER spec_op_0x9c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x9c); }
+SPEC_HANDLER spec_op_0x9d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x9d); }
+SPEC_HANDLER spec_op_0x9e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x9e); }
+SPEC_HANDLER spec_op_0x9f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0x9f); }
+SPEC_HANDLER spec_op_0xa0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa0); }
+SPEC_HANDLER spec_op_0xa1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa1); }
+SPEC_HANDLER spec_op_0xa2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa2); }
+SPEC_HANDLER spec_op_0xa3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa3); }
+SPEC_HANDLER spec_op_0xa4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa4); }
+SPEC_HANDLER spec_op_0xa5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa5); }
+SPEC_HANDLER spec_op_0xa6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa6); }
+SPEC_HANDLER spec_op_0xa7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa7); }
+SPEC_HANDLER spec_op_0xa8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa8); }
+SPEC_HANDLER spec_op_0xa9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xa9); }
+SPEC_HANDLER spec_op_0xaa(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xaa); }
+SPEC_HANDLER spec_op_0xab(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xab); }
+SPEC_HANDLER spec_op_0xac(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xac); }
+SPEC_HANDLER spec_op_0xad(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xad); }
+SPEC_HANDLER spec_op_0xae(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xae); }
+SPEC_HANDLER spec_op_0xaf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xaf); }
+SPEC_HANDLER spec_op_0xb0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb0); }
+SPEC_HANDLER spec_op_0xb1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb1); }
+SPEC_HANDLER spec_op_0xb2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb2); }
+SPEC_HANDLER spec_op_0xb3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb3); }
+SPEC_HANDLER spec_op_0xb4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb4); }
+SPEC_HANDLER spec_op_0xb5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb5); }
+SPEC_HANDLER spec_op_0xb6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb6); }
+SPEC_HANDLER spec_op_0xb7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb7); }
+SPEC_HANDLER spec_op_0xb8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb8); }
+SPEC_HANDLER spec_op_0xb9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xb9); }
+SPEC_HANDLER spec_op_0xba(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xba); }
+SPEC_HANDLER spec_op_0xbb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xbb); }
+SPEC_HANDLER spec_op_0xbc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xbc); }
+SPEC_HANDLER spec_op_0xbd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xbd); }
+SPEC_HANDLER spec_op_0xbe(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xbe); }
+SPEC_HANDLER spec_op_0xbf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_r8(context, 0xbf); }
+SPEC_HANDLER spec_op_0xc0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ret_cond(context, 0xc0); }
+SPEC_HANDLER spec_op_0xc1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_pop_r16stk(context, 0xc1); }
+SPEC_HANDLER spec_op_0xc2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jp_cond(context, 0xc2); }
+SPEC_HANDLER spec_op_0xc3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jp_imm16(context, 0xc3); }
+SPEC_HANDLER spec_op_0xc4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_call_cond_imm16(context, 0xc4); }
+SPEC_HANDLER spec_op_0xc5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_push_r16stk(context, 0xc5); }
+SPEC_HANDLER spec_op_0xc6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xc6); }
+SPEC_HANDLER spec_op_0xc7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xc7); }
+SPEC_HANDLER spec_op_0xc8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ret_cond(context, 0xc8); }
+SPEC_HANDLER spec_op_0xc9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ret(context, 0xc9); }
+SPEC_HANDLER spec_op_0xca(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jp_cond(context, 0xca); }
+SPEC_HANDLER spec_op_0xcb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_cb_prefix(context, 0xcb); }
+SPEC_HANDLER spec_op_0xcc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_call_cond_imm16(context, 0xcc); }
+SPEC_HANDLER spec_op_0xcd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_call_imm16(context, 0xcd); }
+SPEC_HANDLER spec_op_0xce(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xce); }
+SPEC_HANDLER spec_op_0xcf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xcf); }
+SPEC_HANDLER spec_op_0xd0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ret_cond(context, 0xd0); }
+SPEC_HANDLER spec_op_0xd1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_pop_r16stk(context, 0xd1); }
+SPEC_HANDLER spec_op_0xd2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jp_cond(context, 0xd2); }
+SPEC_HANDLER spec_op_0xd3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xd3); }
+SPEC_HANDLER spec_op_0xd4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_call_cond_imm16(context, 0xd4); }
+SPEC_HANDLER spec_op_0xd5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_push_r16stk(context, 0xd5); }
+SPEC_HANDLER spec_op_0xd6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xd6); }
+SPEC_HANDLER spec_op_0xd7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xd7); }
+SPEC_HANDLER spec_op_0xd8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ret_cond(context, 0xd8); }
+SPEC_HANDLER spec_op_0xd9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_reti(context, 0xd9); }
+SPEC_HANDLER spec_op_0xda(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jp_cond(context, 0xda); }
+SPEC_HANDLER spec_op_0xdb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xdb); }
+SPEC_HANDLER spec_op_0xdc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_call_cond_imm16(context, 0xdc); }
+SPEC_HANDLER spec_op_0xdd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xdd); }
+SPEC_HANDLER spec_op_0xde(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xde); }
+SPEC_HANDLER spec_op_0xdf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xdf); }
+SPEC_HANDLER spec_op_0xe0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ldh_imm8mem_a(context, 0xe0); }
+SPEC_HANDLER spec_op_0xe1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_pop_r16stk(context, 0xe1); }
+SPEC_HANDLER spec_op_0xe2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ldh_cmem_a(context, 0xe2); }
+SPEC_HANDLER spec_op_0xe3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xe3); }
+SPEC_HANDLER spec_op_0xe4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xe4); }
+SPEC_HANDLER spec_op_0xe5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_push_r16stk(context, 0xe5); }
+SPEC_HANDLER spec_op_0xe6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xe6); }
+SPEC_HANDLER spec_op_0xe7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xe7); }
+SPEC_HANDLER spec_op_0xe8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_add_sp_imm8(context, 0xe8); }
+SPEC_HANDLER spec_op_0xe9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_jp_hl(context, 0xe9); }
+SPEC_HANDLER spec_op_0xea(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_imm16mem_a(context, 0xea); }
+SPEC_HANDLER spec_op_0xeb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xeb); }
+SPEC_HANDLER spec_op_0xec(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xec); }
+SPEC_HANDLER spec_op_0xed(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xed); }
+SPEC_HANDLER spec_op_0xee(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xee); }
+SPEC_HANDLER spec_op_0xef(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xef); }
+SPEC_HANDLER spec_op_0xf0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ldh_a_imm8mem(context, 0xf0); }
+SPEC_HANDLER spec_op_0xf1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_pop_r16stk(context, 0xf1); }
+SPEC_HANDLER spec_op_0xf2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ldh_a_cmem(context, 0xf2); }
+SPEC_HANDLER spec_op_0xf3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_di(context, 0xf3); }
+SPEC_HANDLER spec_op_0xf4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xf4); }
+SPEC_HANDLER spec_op_0xf5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_push_r16stk(context, 0xf5); }
+SPEC_HANDLER spec_op_0xf6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xf6); }
+SPEC_HANDLER spec_op_0xf7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xf7); }
+SPEC_HANDLER spec_op_0xf8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_hl_sp_imm8(context, 0xf8); }
+SPEC_HANDLER spec_op_0xf9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_sp_hl(context, 0xf9); }
+SPEC_HANDLER spec_op_0xfa(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ld_a_imm16mem(context, 0xfa); }
+SPEC_HANDLER spec_op_0xfb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_ei(context, 0xfb); }
+SPEC_HANDLER spec_op_0xfc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xfc); }
+SPEC_HANDLER spec_op_0xfd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_unimplemented(context, 0xfd); }
+SPEC_HANDLER spec_op_0xfe(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_alu_op_imm8(context, 0xfe); }
+SPEC_HANDLER spec_op_0xff(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rst_tgt3(context, 0xff); }
+
+SPEC_HANDLER spec_cb_0x00(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x00); }
+SPEC_HANDLER spec_cb_0x01(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x01); }
+SPEC_HANDLER spec_cb_0x02(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x02); }
+SPEC_HANDLER spec_cb_0x03(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x03); }
+SPEC_HANDLER spec_cb_0x04(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x04); }
+SPEC_HANDLER spec_cb_0x05(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x05); }
+SPEC_HANDLER spec_cb_0x06(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x06); }
+SPEC_HANDLER spec_cb_0x07(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rlc_r8(context, 0x07); }
+SPEC_HANDLER spec_cb_0x08(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x08); }
+SPEC_HANDLER spec_cb_0x09(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x09); }
+SPEC_HANDLER spec_cb_0x0a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x0a); }
+SPEC_HANDLER spec_cb_0x0b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x0b); }
+SPEC_HANDLER spec_cb_0x0c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x0c); }
+SPEC_HANDLER spec_cb_0x0d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x0d); }
+SPEC_HANDLER spec_cb_0x0e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x0e); }
+SPEC_HANDLER spec_cb_0x0f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rrc_r8(context, 0x0f); }
+SPEC_HANDLER spec_cb_0x10(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x10); }
+SPEC_HANDLER spec_cb_0x11(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x11); }
+SPEC_HANDLER spec_cb_0x12(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x12); }
+SPEC_HANDLER spec_cb_0x13(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x13); }
+SPEC_HANDLER spec_cb_0x14(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x14); }
+SPEC_HANDLER spec_cb_0x15(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x15); }
+SPEC_HANDLER spec_cb_0x16(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x16); }
+SPEC_HANDLER spec_cb_0x17(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rl_r8(context, 0x17); }
+SPEC_HANDLER spec_cb_0x18(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x18); }
+SPEC_HANDLER spec_cb_0x19(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x19); }
+SPEC_HANDLER spec_cb_0x1a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x1a); }
+SPEC_HANDLER spec_cb_0x1b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x1b); }
+SPEC_HANDLER spec_cb_0x1c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x1c); }
+SPEC_HANDLER spec_cb_0x1d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x1d); }
+SPEC_HANDLER spec_cb_0x1e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x1e); }
+SPEC_HANDLER spec_cb_0x1f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_rr_r8(context, 0x1f); }
+SPEC_HANDLER spec_cb_0x20(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x20); }
+SPEC_HANDLER spec_cb_0x21(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x21); }
+SPEC_HANDLER spec_cb_0x22(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x22); }
+SPEC_HANDLER spec_cb_0x23(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x23); }
+SPEC_HANDLER spec_cb_0x24(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x24); }
+SPEC_HANDLER spec_cb_0x25(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x25); }
+SPEC_HANDLER spec_cb_0x26(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x26); }
+SPEC_HANDLER spec_cb_0x27(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sla_r8(context, 0x27); }
+SPEC_HANDLER spec_cb_0x28(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x28); }
+SPEC_HANDLER spec_cb_0x29(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x29); }
+SPEC_HANDLER spec_cb_0x2a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x2a); }
+SPEC_HANDLER spec_cb_0x2b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x2b); }
+SPEC_HANDLER spec_cb_0x2c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x2c); }
+SPEC_HANDLER spec_cb_0x2d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x2d); }
+SPEC_HANDLER spec_cb_0x2e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x2e); }
+SPEC_HANDLER spec_cb_0x2f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_sra_r8(context, 0x2f); }
+SPEC_HANDLER spec_cb_0x30(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x30); }
+SPEC_HANDLER spec_cb_0x31(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x31); }
+SPEC_HANDLER spec_cb_0x32(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x32); }
+SPEC_HANDLER spec_cb_0x33(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x33); }
+SPEC_HANDLER spec_cb_0x34(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x34); }
+SPEC_HANDLER spec_cb_0x35(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x35); }
+SPEC_HANDLER spec_cb_0x36(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x36); }
+SPEC_HANDLER spec_cb_0x37(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_swap_r8(context, 0x37); }
+SPEC_HANDLER spec_cb_0x38(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x38); }
+SPEC_HANDLER spec_cb_0x39(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x39); }
+SPEC_HANDLER spec_cb_0x3a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x3a); }
+SPEC_HANDLER spec_cb_0x3b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x3b); }
+SPEC_HANDLER spec_cb_0x3c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x3c); }
+SPEC_HANDLER spec_cb_0x3d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x3d); }
+SPEC_HANDLER spec_cb_0x3e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x3e); }
+SPEC_HANDLER spec_cb_0x3f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_srl_r8(context, 0x3f); }
+SPEC_HANDLER spec_cb_0x40(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x40); }
+SPEC_HANDLER spec_cb_0x41(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x41); }
+SPEC_HANDLER spec_cb_0x42(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x42); }
+SPEC_HANDLER spec_cb_0x43(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x43); }
+SPEC_HANDLER spec_cb_0x44(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x44); }
+SPEC_HANDLER spec_cb_0x45(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x45); }
+SPEC_HANDLER spec_cb_0x46(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x46); }
+SPEC_HANDLER spec_cb_0x47(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x47); }
+SPEC_HANDLER spec_cb_0x48(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x48); }
+SPEC_HANDLER spec_cb_0x49(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x49); }
+SPEC_HANDLER spec_cb_0x4a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x4a); }
+SPEC_HANDLER spec_cb_0x4b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x4b); }
+SPEC_HANDLER spec_cb_0x4c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x4c); }
+SPEC_HANDLER spec_cb_0x4d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x4d); }
+SPEC_HANDLER spec_cb_0x4e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x4e); }
+SPEC_HANDLER spec_cb_0x4f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x4f); }
+SPEC_HANDLER spec_cb_0x50(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x50); }
+SPEC_HANDLER spec_cb_0x51(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x51); }
+SPEC_HANDLER spec_cb_0x52(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x52); }
+SPEC_HANDLER spec_cb_0x53(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x53); }
+SPEC_HANDLER spec_cb_0x54(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x54); }
+SPEC_HANDLER spec_cb_0x55(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x55); }
+SPEC_HANDLER spec_cb_0x56(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x56); }
+SPEC_HANDLER spec_cb_0x57(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x57); }
+SPEC_HANDLER spec_cb_0x58(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x58); }
+SPEC_HANDLER spec_cb_0x59(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x59); }
+SPEC_HANDLER spec_cb_0x5a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x5a); }
+SPEC_HANDLER spec_cb_0x5b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x5b); }
+SPEC_HANDLER spec_cb_0x5c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x5c); }
+SPEC_HANDLER spec_cb_0x5d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x5d); }
+SPEC_HANDLER spec_cb_0x5e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x5e); }
+SPEC_HANDLER spec_cb_0x5f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x5f); }
+SPEC_HANDLER spec_cb_0x60(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x60); }
+SPEC_HANDLER spec_cb_0x61(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x61); }
+SPEC_HANDLER spec_cb_0x62(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x62); }
+SPEC_HANDLER spec_cb_0x63(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x63); }
+SPEC_HANDLER spec_cb_0x64(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x64); }
+SPEC_HANDLER spec_cb_0x65(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x65); }
+SPEC_HANDLER spec_cb_0x66(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x66); }
+SPEC_HANDLER spec_cb_0x67(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x67); }
+SPEC_HANDLER spec_cb_0x68(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x68); }
+SPEC_HANDLER spec_cb_0x69(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x69); }
+SPEC_HANDLER spec_cb_0x6a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x6a); }
+SPEC_HANDLER spec_cb_0x6b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x6b); }
+SPEC_HANDLER spec_cb_0x6c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x6c); }
+SPEC_HANDLER spec_cb_0x6d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x6d); }
+SPEC_HANDLER spec_cb_0x6e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x6e); }
+SPEC_HANDLER spec_cb_0x6f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x6f); }
+SPEC_HANDLER spec_cb_0x70(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x70); }
+SPEC_HANDLER spec_cb_0x71(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x71); }
+SPEC_HANDLER spec_cb_0x72(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x72); }
+SPEC_HANDLER spec_cb_0x73(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x73); }
+SPEC_HANDLER spec_cb_0x74(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x74); }
+SPEC_HANDLER spec_cb_0x75(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x75); }
+SPEC_HANDLER spec_cb_0x76(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x76); }
+SPEC_HANDLER spec_cb_0x77(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x77); }
+SPEC_HANDLER spec_cb_0x78(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x78); }
+SPEC_HANDLER spec_cb_0x79(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x79); }
+SPEC_HANDLER spec_cb_0x7a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x7a); }
+SPEC_HANDLER spec_cb_0x7b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x7b); }
+SPEC_HANDLER spec_cb_0x7c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x7c); }
+SPEC_HANDLER spec_cb_0x7d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x7d); }
+SPEC_HANDLER spec_cb_0x7e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x7e); }
+SPEC_HANDLER spec_cb_0x7f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_bit_b3_r8(context, 0x7f); }
+SPEC_HANDLER spec_cb_0x80(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x80); }
+SPEC_HANDLER spec_cb_0x81(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x81); }
+SPEC_HANDLER spec_cb_0x82(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x82); }
+SPEC_HANDLER spec_cb_0x83(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x83); }
+SPEC_HANDLER spec_cb_0x84(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x84); }
+SPEC_HANDLER spec_cb_0x85(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x85); }
+SPEC_HANDLER spec_cb_0x86(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x86); }
+SPEC_HANDLER spec_cb_0x87(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x87); }
+SPEC_HANDLER spec_cb_0x88(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x88); }
+SPEC_HANDLER spec_cb_0x89(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x89); }
+SPEC_HANDLER spec_cb_0x8a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x8a); }
+SPEC_HANDLER spec_cb_0x8b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x8b); }
+SPEC_HANDLER spec_cb_0x8c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x8c); }
+SPEC_HANDLER spec_cb_0x8d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x8d); }
+SPEC_HANDLER spec_cb_0x8e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x8e); }
+SPEC_HANDLER spec_cb_0x8f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x8f); }
+SPEC_HANDLER spec_cb_0x90(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x90); }
+SPEC_HANDLER spec_cb_0x91(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x91); }
+SPEC_HANDLER spec_cb_0x92(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x92); }
+SPEC_HANDLER spec_cb_0x93(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x93); }
+SPEC_HANDLER spec_cb_0x94(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x94); }
+SPEC_HANDLER spec_cb_0x95(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x95); }
+SPEC_HANDLER spec_cb_0x96(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x96); }
+SPEC_HANDLER spec_cb_0x97(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x97); }
+SPEC_HANDLER spec_cb_0x98(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x98); }
+SPEC_HANDLER spec_cb_0x99(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x99); }
+SPEC_HANDLER spec_cb_0x9a(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x9a); }
+SPEC_HANDLER spec_cb_0x9b(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x9b); }
+SPEC_HANDLER spec_cb_0x9c(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x9c); }
+SPEC_HANDLER spec_cb_0x9d(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x9d); }
+SPEC_HANDLER spec_cb_0x9e(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x9e); }
+SPEC_HANDLER spec_cb_0x9f(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0x9f); }
+SPEC_HANDLER spec_cb_0xa0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa0); }
+SPEC_HANDLER spec_cb_0xa1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa1); }
+SPEC_HANDLER spec_cb_0xa2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa2); }
+SPEC_HANDLER spec_cb_0xa3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa3); }
+SPEC_HANDLER spec_cb_0xa4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa4); }
+SPEC_HANDLER spec_cb_0xa5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa5); }
+SPEC_HANDLER spec_cb_0xa6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa6); }
+SPEC_HANDLER spec_cb_0xa7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa7); }
+SPEC_HANDLER spec_cb_0xa8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa8); }
+SPEC_HANDLER spec_cb_0xa9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xa9); }
+SPEC_HANDLER spec_cb_0xaa(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xaa); }
+SPEC_HANDLER spec_cb_0xab(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xab); }
+SPEC_HANDLER spec_cb_0xac(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xac); }
+SPEC_HANDLER spec_cb_0xad(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xad); }
+SPEC_HANDLER spec_cb_0xae(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xae); }
+SPEC_HANDLER spec_cb_0xaf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xaf); }
+SPEC_HANDLER spec_cb_0xb0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb0); }
+SPEC_HANDLER spec_cb_0xb1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb1); }
+SPEC_HANDLER spec_cb_0xb2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb2); }
+SPEC_HANDLER spec_cb_0xb3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb3); }
+SPEC_HANDLER spec_cb_0xb4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb4); }
+SPEC_HANDLER spec_cb_0xb5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb5); }
+SPEC_HANDLER spec_cb_0xb6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb6); }
+SPEC_HANDLER spec_cb_0xb7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb7); }
+SPEC_HANDLER spec_cb_0xb8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb8); }
+SPEC_HANDLER spec_cb_0xb9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xb9); }
+SPEC_HANDLER spec_cb_0xba(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xba); }
+SPEC_HANDLER spec_cb_0xbb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xbb); }
+SPEC_HANDLER spec_cb_0xbc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xbc); }
+SPEC_HANDLER spec_cb_0xbd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xbd); }
+SPEC_HANDLER spec_cb_0xbe(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xbe); }
+SPEC_HANDLER spec_cb_0xbf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_res_b3_r8(context, 0xbf); }
+SPEC_HANDLER spec_cb_0xc0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc0); }
+SPEC_HANDLER spec_cb_0xc1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc1); }
+SPEC_HANDLER spec_cb_0xc2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc2); }
+SPEC_HANDLER spec_cb_0xc3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc3); }
+SPEC_HANDLER spec_cb_0xc4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc4); }
+SPEC_HANDLER spec_cb_0xc5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc5); }
+SPEC_HANDLER spec_cb_0xc6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc6); }
+SPEC_HANDLER spec_cb_0xc7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc7); }
+SPEC_HANDLER spec_cb_0xc8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc8); }
+SPEC_HANDLER spec_cb_0xc9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xc9); }
+SPEC_HANDLER spec_cb_0xca(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xca); }
+SPEC_HANDLER spec_cb_0xcb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xcb); }
+SPEC_HANDLER spec_cb_0xcc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xcc); }
+SPEC_HANDLER spec_cb_0xcd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xcd); }
+SPEC_HANDLER spec_cb_0xce(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xce); }
+SPEC_HANDLER spec_cb_0xcf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xcf); }
+SPEC_HANDLER spec_cb_0xd0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd0); }
+SPEC_HANDLER spec_cb_0xd1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd1); }
+SPEC_HANDLER spec_cb_0xd2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd2); }
+SPEC_HANDLER spec_cb_0xd3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd3); }
+SPEC_HANDLER spec_cb_0xd4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd4); }
+SPEC_HANDLER spec_cb_0xd5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd5); }
+SPEC_HANDLER spec_cb_0xd6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd6); }
+SPEC_HANDLER spec_cb_0xd7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd7); }
+SPEC_HANDLER spec_cb_0xd8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd8); }
+SPEC_HANDLER spec_cb_0xd9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xd9); }
+SPEC_HANDLER spec_cb_0xda(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xda); }
+SPEC_HANDLER spec_cb_0xdb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xdb); }
+SPEC_HANDLER spec_cb_0xdc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xdc); }
+SPEC_HANDLER spec_cb_0xdd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xdd); }
+SPEC_HANDLER spec_cb_0xde(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xde); }
+SPEC_HANDLER spec_cb_0xdf(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xdf); }
+SPEC_HANDLER spec_cb_0xe0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe0); }
+SPEC_HANDLER spec_cb_0xe1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe1); }
+SPEC_HANDLER spec_cb_0xe2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe2); }
+SPEC_HANDLER spec_cb_0xe3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe3); }
+SPEC_HANDLER spec_cb_0xe4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe4); }
+SPEC_HANDLER spec_cb_0xe5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe5); }
+SPEC_HANDLER spec_cb_0xe6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe6); }
+SPEC_HANDLER spec_cb_0xe7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe7); }
+SPEC_HANDLER spec_cb_0xe8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe8); }
+SPEC_HANDLER spec_cb_0xe9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xe9); }
+SPEC_HANDLER spec_cb_0xea(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xea); }
+SPEC_HANDLER spec_cb_0xeb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xeb); }
+SPEC_HANDLER spec_cb_0xec(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xec); }
+SPEC_HANDLER spec_cb_0xed(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xed); }
+SPEC_HANDLER spec_cb_0xee(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xee); }
+SPEC_HANDLER spec_cb_0xef(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xef); }
+SPEC_HANDLER spec_cb_0xf0(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf0); }
+SPEC_HANDLER spec_cb_0xf1(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf1); }
+SPEC_HANDLER spec_cb_0xf2(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf2); }
+SPEC_HANDLER spec_cb_0xf3(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf3); }
+SPEC_HANDLER spec_cb_0xf4(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf4); }
+SPEC_HANDLER spec_cb_0xf5(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf5); }
+SPEC_HANDLER spec_cb_0xf6(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf6); }
+SPEC_HANDLER spec_cb_0xf7(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf7); }
+SPEC_HANDLER spec_cb_0xf8(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf8); }
+SPEC_HANDLER spec_cb_0xf9(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xf9); }
+SPEC_HANDLER spec_cb_0xfa(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xfa); }
+SPEC_HANDLER spec_cb_0xfb(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xfb); }
+SPEC_HANDLER spec_cb_0xfc(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xfc); }
+SPEC_HANDLER spec_cb_0xfd(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xfd); }
+SPEC_HANDLER spec_cb_0xfe(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xfe); }
+SPEC_HANDLER spec_cb_0xff(cpu_context_t *context, uint8_t opcode) { (void) opcode; instr_set_b3_r8(context, 0xff); }
+
+
+#undef SPEC_HANDLER
+
+INSTR_FUNC spec_optable[256] = {
+    
+	[0x00] 	= 	spec_op_0x00, 
+	[0x01] 	= 	spec_op_0x01, 
+	[0x02] 	= 	spec_op_0x02, 
+	[0x03] 	= 	spec_op_0x03, 
+	[0x04] 	= 	spec_op_0x04, 
+	[0x05] 	= 	spec_op_0x05, 
+	[0x06] 	= 	spec_op_0x06, 
+	[0x07] 	= 	spec_op_0x07, 
+	[0x08] 	= 	spec_op_0x08, 
+	[0x09] 	= 	spec_op_0x09, 
+	[0x0a] 	= 	spec_op_0x0a, 
+	[0x0b] 	= 	spec_op_0x0b, 
+	[0x0c] 	= 	spec_op_0x0c, 
+	[0x0d] 	= 	spec_op_0x0d, 
+	[0x0e] 	= 	spec_op_0x0e, 
+	[0x0f] 	= 	spec_op_0x0f, 
+	[0x10] 	= 	spec_op_0x10, 
+	[0x11] 	= 	spec_op_0x11, 
+	[0x12] 	= 	spec_op_0x12, 
+	[0x13] 	= 	spec_op_0x13, 
+	[0x14] 	= 	spec_op_0x14, 
+	[0x15] 	= 	spec_op_0x15, 
+	[0x16] 	= 	spec_op_0x16, 
+	[0x17] 	= 	spec_op_0x17, 
+	[0x18] 	= 	spec_op_0x18, 
+	[0x19] 	= 	spec_op_0x19, 
+	[0x1a] 	= 	spec_op_0x1a, 
+	[0x1b] 	= 	spec_op_0x1b, 
+	[0x1c] 	= 	spec_op_0x1c, 
+	[0x1d] 	= 	spec_op_0x1d, 
+	[0x1e] 	= 	spec_op_0x1e, 
+	[0x1f] 	= 	spec_op_0x1f, 
+	[0x20] 	= 	spec_op_0x20, 
+	[0x21] 	= 	spec_op_0x21, 
+	[0x22] 	= 	spec_op_0x22, 
+	[0x23] 	= 	spec_op_0x23, 
+	[0x24] 	= 	spec_op_0x24, 
+	[0x25] 	= 	spec_op_0x25, 
+	[0x26] 	= 	spec_op_0x26, 
+	[0x27] 	= 	spec_op_0x27, 
+	[0x28] 	= 	spec_op_0x28, 
+	[0x29] 	= 	spec_op_0x29, 
+	[0x2a] 	= 	spec_op_0x2a, 
+	[0x2b] 	= 	spec_op_0x2b, 
+	[0x2c] 	= 	spec_op_0x2c, 
+	[0x2d] 	= 	spec_op_0x2d, 
+	[0x2e] 	= 	spec_op_0x2e, 
+	[0x2f] 	= 	spec_op_0x2f, 
+	[0x30] 	= 	spec_op_0x30, 
+	[0x31] 	= 	spec_op_0x31, 
+	[0x32] 	= 	spec_op_0x32, 
+	[0x33] 	= 	spec_op_0x33, 
+	[0x34] 	= 	spec_op_0x34, 
+	[0x35] 	= 	spec_op_0x35, 
+	[0x36] 	= 	spec_op_0x36, 
+	[0x37] 	= 	spec_op_0x37, 
+	[0x38] 	= 	spec_op_0x38, 
+	[0x39] 	= 	spec_op_0x39, 
+	[0x3a] 	= 	spec_op_0x3a, 
+	[0x3b] 	= 	spec_op_0x3b, 
+	[0x3c] 	= 	spec_op_0x3c, 
+	[0x3d] 	= 	spec_op_0x3d, 
+	[0x3e] 	= 	spec_op_0x3e, 
+	[0x3f] 	= 	spec_op_0x3f, 
+	[0x40] 	= 	spec_op_0x40, 
+	[0x41] 	= 	spec_op_0x41, 
+	[0x42] 	= 	spec_op_0x42, 
+	[0x43] 	= 	spec_op_0x43, 
+	[0x44] 	= 	spec_op_0x44, 
+	[0x45] 	= 	spec_op_0x45, 
+	[0x46] 	= 	spec_op_0x46, 
+	[0x47] 	= 	spec_op_0x47, 
+	[0x48] 	= 	spec_op_0x48, 
+	[0x49] 	= 	spec_op_0x49, 
+	[0x4a] 	= 	spec_op_0x4a, 
+	[0x4b] 	= 	spec_op_0x4b, 
+	[0x4c] 	= 	spec_op_0x4c, 
+	[0x4d] 	= 	spec_op_0x4d, 
+	[0x4e] 	= 	spec_op_0x4e, 
+	[0x4f] 	= 	spec_op_0x4f, 
+	[0x50] 	= 	spec_op_0x50, 
+	[0x51] 	= 	spec_op_0x51, 
+	[0x52] 	= 	spec_op_0x52, 
+	[0x53] 	= 	spec_op_0x53, 
+	[0x54] 	= 	spec_op_0x54, 
+	[0x55] 	= 	spec_op_0x55, 
+	[0x56] 	= 	spec_op_0x56, 
+	[0x57] 	= 	spec_op_0x57, 
+	[0x58] 	= 	spec_op_0x58, 
+	[0x59] 	= 	spec_op_0x59, 
+	[0x5a] 	= 	spec_op_0x5a, 
+	[0x5b] 	= 	spec_op_0x5b, 
+	[0x5c] 	= 	spec_op_0x5c, 
+	[0x5d] 	= 	spec_op_0x5d, 
+	[0x5e] 	= 	spec_op_0x5e, 
+	[0x5f] 	= 	spec_op_0x5f, 
+	[0x60] 	= 	spec_op_0x60, 
+	[0x61] 	= 	spec_op_0x61, 
+	[0x62] 	= 	spec_op_0x62, 
+	[0x63] 	= 	spec_op_0x63, 
+	[0x64] 	= 	spec_op_0x64, 
+	[0x65] 	= 	spec_op_0x65, 
+	[0x66] 	= 	spec_op_0x66, 
+	[0x67] 	= 	spec_op_0x67, 
+	[0x68] 	= 	spec_op_0x68, 
+	[0x69] 	= 	spec_op_0x69, 
+	[0x6a] 	= 	spec_op_0x6a, 
+	[0x6b] 	= 	spec_op_0x6b, 
+	[0x6c] 	= 	spec_op_0x6c, 
+	[0x6d] 	= 	spec_op_0x6d, 
+	[0x6e] 	= 	spec_op_0x6e, 
+	[0x6f] 	= 	spec_op_0x6f, 
+	[0x70] 	= 	spec_op_0x70, 
+	[0x71] 	= 	spec_op_0x71, 
+	[0x72] 	= 	spec_op_0x72, 
+	[0x73] 	= 	spec_op_0x73, 
+	[0x74] 	= 	spec_op_0x74, 
+	[0x75] 	= 	spec_op_0x75, 
+	[0x76] 	= 	spec_op_0x76, 
+	[0x77] 	= 	spec_op_0x77, 
+	[0x78] 	= 	spec_op_0x78, 
+	[0x79] 	= 	spec_op_0x79, 
+	[0x7a] 	= 	spec_op_0x7a, 
+	[0x7b] 	= 	spec_op_0x7b, 
+	[0x7c] 	= 	spec_op_0x7c, 
+	[0x7d] 	= 	spec_op_0x7d, 
+	[0x7e] 	= 	spec_op_0x7e, 
+	[0x7f] 	= 	spec_op_0x7f, 
+	[0x80] 	= 	spec_op_0x80, 
+	[0x81] 	= 	spec_op_0x81, 
+	[0x82] 	= 	spec_op_0x82, 
+	[0x83] 	= 	spec_op_0x83, 
+	[0x84] 	= 	spec_op_0x84, 
+	[0x85] 	= 	spec_op_0x85, 
+	[0x86] 	= 	spec_op_0x86, 
+	[0x87] 	= 	spec_op_0x87, 
+	[0x88] 	= 	spec_op_0x88, 
+	[0x89] 	= 	spec_op_0x89, 
+	[0x8a] 	= 	spec_op_0x8a, 
+	[0x8b] 	= 	spec_op_0x8b, 
+	[0x8c] 	= 	spec_op_0x8c, 
+	[0x8d] 	= 	spec_op_0x8d, 
+	[0x8e] 	= 	spec_op_0x8e, 
+	[0x8f] 	= 	spec_op_0x8f, 
+	[0x90] 	= 	spec_op_0x90, 
+	[0x91] 	= 	spec_op_0x91, 
+	[0x92] 	= 	spec_op_0x92, 
+	[0x93] 	= 	spec_op_0x93, 
+	[0x94] 	= 	spec_op_0x94, 
+	[0x95] 	= 	spec_op_0x95, 
+	[0x96] 	= 	spec_op_0x96, 
+	[0x97] 	= 	spec_op_0x97, 
+	[0x98] 	= 	spec_op_0x98, 
+	[0x99] 	= 	spec_op_0x99, 
+	[0x9a] 	= 	spec_op_0x9a, 
+	[0x9b] 	= 	spec_op_0x9b, 
+	[0x9c] 	= 	spec_op_0x9c, 
+	[0x9d] 	= 	spec_op_0x9d, 
+	[0x9e] 	= 	spec_op_0x9e, 
+	[0x9f] 	= 	spec_op_0x9f, 
+	[0xa0] 	= 	spec_op_0xa0, 
+	[0xa1] 	= 	spec_op_0xa1, 
+	[0xa2] 	= 	spec_op_0xa2, 
+	[0xa3] 	= 	spec_op_0xa3, 
+	[0xa4] 	= 	spec_op_0xa4, 
+	[0xa5] 	= 	spec_op_0xa5, 
+	[0xa6] 	= 	spec_op_0xa6, 
+	[0xa7] 	= 	spec_op_0xa7, 
+	[0xa8] 	= 	spec_op_0xa8, 
+	[0xa9] 	= 	spec_op_0xa9, 
+	[0xaa] 	= 	spec_op_0xaa, 
+	[0xab] 	= 	spec_op_0xab, 
+	[0xac] 	= 	spec_op_0xac, 
+	[0xad] 	= 	spec_op_0xad, 
+	[0xae] 	= 	spec_op_0xae, 
+	[0xaf] 	= 	spec_op_0xaf, 
+	[0xb0] 	= 	spec_op_0xb0, 
+	[0xb1] 	= 	spec_op_0xb1, 
+	[0xb2] 	= 	spec_op_0xb2, 
+	[0xb3] 	= 	spec_op_0xb3, 
+	[0xb4] 	= 	spec_op_0xb4, 
+	[0xb5] 	= 	spec_op_0xb5, 
+	[0xb6] 	= 	spec_op_0xb6, 
+	[0xb7] 	= 	spec_op_0xb7, 
+	[0xb8] 	= 	spec_op_0xb8, 
+	[0xb9] 	= 	spec_op_0xb9, 
+	[0xba] 	= 	spec_op_0xba, 
+	[0xbb] 	= 	spec_op_0xbb, 
+	[0xbc] 	= 	spec_op_0xbc, 
+	[0xbd] 	= 	spec_op_0xbd, 
+	[0xbe] 	= 	spec_op_0xbe, 
+	[0xbf] 	= 	spec_op_0xbf, 
+	[0xc0] 	= 	spec_op_0xc0, 
+	[0xc1] 	= 	spec_op_0xc1, 
+	[0xc2] 	= 	spec_op_0xc2, 
+	[0xc3] 	= 	spec_op_0xc3, 
+	[0xc4] 	= 	spec_op_0xc4, 
+	[0xc5] 	= 	spec_op_0xc5, 
+	[0xc6] 	= 	spec_op_0xc6, 
+	[0xc7] 	= 	spec_op_0xc7, 
+	[0xc8] 	= 	spec_op_0xc8, 
+	[0xc9] 	= 	spec_op_0xc9, 
+	[0xca] 	= 	spec_op_0xca, 
+	[0xcb] 	= 	spec_op_0xcb, 
+	[0xcc] 	= 	spec_op_0xcc, 
+	[0xcd] 	= 	spec_op_0xcd, 
+	[0xce] 	= 	spec_op_0xce, 
+	[0xcf] 	= 	spec_op_0xcf, 
+	[0xd0] 	= 	spec_op_0xd0, 
+	[0xd1] 	= 	spec_op_0xd1, 
+	[0xd2] 	= 	spec_op_0xd2, 
+	[0xd3] 	= 	spec_op_0xd3, 
+	[0xd4] 	= 	spec_op_0xd4, 
+	[0xd5] 	= 	spec_op_0xd5, 
+	[0xd6] 	= 	spec_op_0xd6, 
+	[0xd7] 	= 	spec_op_0xd7, 
+	[0xd8] 	= 	spec_op_0xd8, 
+	[0xd9] 	= 	spec_op_0xd9, 
+	[0xda] 	= 	spec_op_0xda, 
+	[0xdb] 	= 	spec_op_0xdb, 
+	[0xdc] 	= 	spec_op_0xdc, 
+	[0xdd] 	= 	spec_op_0xdd, 
+	[0xde] 	= 	spec_op_0xde, 
+	[0xdf] 	= 	spec_op_0xdf, 
+	[0xe0] 	= 	spec_op_0xe0, 
+	[0xe1] 	= 	spec_op_0xe1, 
+	[0xe2] 	= 	spec_op_0xe2, 
+	[0xe3] 	= 	spec_op_0xe3, 
+	[0xe4] 	= 	spec_op_0xe4, 
+	[0xe5] 	= 	spec_op_0xe5, 
+	[0xe6] 	= 	spec_op_0xe6, 
+	[0xe7] 	= 	spec_op_0xe7, 
+	[0xe8] 	= 	spec_op_0xe8, 
+	[0xe9] 	= 	spec_op_0xe9, 
+	[0xea] 	= 	spec_op_0xea, 
+	[0xeb] 	= 	spec_op_0xeb, 
+	[0xec] 	= 	spec_op_0xec, 
+	[0xed] 	= 	spec_op_0xed, 
+	[0xee] 	= 	spec_op_0xee, 
+	[0xef] 	= 	spec_op_0xef, 
+	[0xf0] 	= 	spec_op_0xf0, 
+	[0xf1] 	= 	spec_op_0xf1, 
+	[0xf2] 	= 	spec_op_0xf2, 
+	[0xf3] 	= 	spec_op_0xf3, 
+	[0xf4] 	= 	spec_op_0xf4, 
+	[0xf5] 	= 	spec_op_0xf5, 
+	[0xf6] 	= 	spec_op_0xf6, 
+	[0xf7] 	= 	spec_op_0xf7, 
+	[0xf8] 	= 	spec_op_0xf8, 
+	[0xf9] 	= 	spec_op_0xf9, 
+	[0xfa] 	= 	spec_op_0xfa, 
+	[0xfb] 	= 	spec_op_0xfb, 
+	[0xfc] 	= 	spec_op_0xfc, 
+	[0xfd] 	= 	spec_op_0xfd, 
+	[0xfe] 	= 	spec_op_0xfe, 
+	[0xff] 	= 	spec_op_0xff, 
+
+};
+
+INSTR_FUNC spec_prefix_optable[256] = {
+    
+	[0x00] 	= 	spec_cb_0x00, 
+	[0x01] 	= 	spec_cb_0x01, 
+	[0x02] 	= 	spec_cb_0x02, 
+	[0x03] 	= 	spec_cb_0x03, 
+	[0x04] 	= 	spec_cb_0x04, 
+	[0x05] 	= 	spec_cb_0x05, 
+	[0x06] 	= 	spec_cb_0x06, 
+	[0x07] 	= 	spec_cb_0x07, 
+	[0x08] 	= 	spec_cb_0x08, 
+	[0x09] 	= 	spec_cb_0x09, 
+	[0x0a] 	= 	spec_cb_0x0a, 
+	[0x0b] 	= 	spec_cb_0x0b, 
+	[0x0c] 	= 	spec_cb_0x0c, 
+	[0x0d] 	= 	spec_cb_0x0d, 
+	[0x0e] 	= 	spec_cb_0x0e, 
+	[0x0f] 	= 	spec_cb_0x0f, 
+	[0x10] 	= 	spec_cb_0x10, 
+	[0x11] 	= 	spec_cb_0x11, 
+	[0x12] 	= 	spec_cb_0x12, 
+	[0x13] 	= 	spec_cb_0x13, 
+	[0x14] 	= 	spec_cb_0x14, 
+	[0x15] 	= 	spec_cb_0x15, 
+	[0x16] 	= 	spec_cb_0x16, 
+	[0x17] 	= 	spec_cb_0x17, 
+	[0x18] 	= 	spec_cb_0x18, 
+	[0x19] 	= 	spec_cb_0x19, 
+	[0x1a] 	= 	spec_cb_0x1a, 
+	[0x1b] 	= 	spec_cb_0x1b, 
+	[0x1c] 	= 	spec_cb_0x1c, 
+	[0x1d] 	= 	spec_cb_0x1d, 
+	[0x1e] 	= 	spec_cb_0x1e, 
+	[0x1f] 	= 	spec_cb_0x1f, 
+	[0x20] 	= 	spec_cb_0x20, 
+	[0x21] 	= 	spec_cb_0x21, 
+	[0x22] 	= 	spec_cb_0x22, 
+	[0x23] 	= 	spec_cb_0x23, 
+	[0x24] 	= 	spec_cb_0x24, 
+	[0x25] 	= 	spec_cb_0x25, 
+	[0x26] 	= 	spec_cb_0x26, 
+	[0x27] 	= 	spec_cb_0x27, 
+	[0x28] 	= 	spec_cb_0x28, 
+	[0x29] 	= 	spec_cb_0x29, 
+	[0x2a] 	= 	spec_cb_0x2a, 
+	[0x2b] 	= 	spec_cb_0x2b, 
+	[0x2c] 	= 	spec_cb_0x2c, 
+	[0x2d] 	= 	spec_cb_0x2d, 
+	[0x2e] 	= 	spec_cb_0x2e, 
+	[0x2f] 	= 	spec_cb_0x2f, 
+	[0x30] 	= 	spec_cb_0x30, 
+	[0x31] 	= 	spec_cb_0x31, 
+	[0x32] 	= 	spec_cb_0x32, 
+	[0x33] 	= 	spec_cb_0x33, 
+	[0x34] 	= 	spec_cb_0x34, 
+	[0x35] 	= 	spec_cb_0x35, 
+	[0x36] 	= 	spec_cb_0x36, 
+	[0x37] 	= 	spec_cb_0x37, 
+	[0x38] 	= 	spec_cb_0x38, 
+	[0x39] 	= 	spec_cb_0x39, 
+	[0x3a] 	= 	spec_cb_0x3a, 
+	[0x3b] 	= 	spec_cb_0x3b, 
+	[0x3c] 	= 	spec_cb_0x3c, 
+	[0x3d] 	= 	spec_cb_0x3d, 
+	[0x3e] 	= 	spec_cb_0x3e, 
+	[0x3f] 	= 	spec_cb_0x3f, 
+	[0x40] 	= 	spec_cb_0x40, 
+	[0x41] 	= 	spec_cb_0x41, 
+	[0x42] 	= 	spec_cb_0x42, 
+	[0x43] 	= 	spec_cb_0x43, 
+	[0x44] 	= 	spec_cb_0x44, 
+	[0x45] 	= 	spec_cb_0x45, 
+	[0x46] 	= 	spec_cb_0x46, 
+	[0x47] 	= 	spec_cb_0x47, 
+	[0x48] 	= 	spec_cb_0x48, 
+	[0x49] 	= 	spec_cb_0x49, 
+	[0x4a] 	= 	spec_cb_0x4a, 
+	[0x4b] 	= 	spec_cb_0x4b, 
+	[0x4c] 	= 	spec_cb_0x4c, 
+	[0x4d] 	= 	spec_cb_0x4d, 
+	[0x4e] 	= 	spec_cb_0x4e, 
+	[0x4f] 	= 	spec_cb_0x4f, 
+	[0x50] 	= 	spec_cb_0x50, 
+	[0x51] 	= 	spec_cb_0x51, 
+	[0x52] 	= 	spec_cb_0x52, 
+	[0x53] 	= 	spec_cb_0x53, 
+	[0x54] 	= 	spec_cb_0x54, 
+	[0x55] 	= 	spec_cb_0x55, 
+	[0x56] 	= 	spec_cb_0x56, 
+	[0x57] 	= 	spec_cb_0x57, 
+	[0x58] 	= 	spec_cb_0x58, 
+	[0x59] 	= 	spec_cb_0x59, 
+	[0x5a] 	= 	spec_cb_0x5a, 
+	[0x5b] 	= 	spec_cb_0x5b, 
+	[0x5c] 	= 	spec_cb_0x5c, 
+	[0x5d] 	= 	spec_cb_0x5d, 
+	[0x5e] 	= 	spec_cb_0x5e, 
+	[0x5f] 	= 	spec_cb_0x5f, 
+	[0x60] 	= 	spec_cb_0x60, 
+	[0x61] 	= 	spec_cb_0x61, 
+	[0x62] 	= 	spec_cb_0x62, 
+	[0x63] 	= 	spec_cb_0x63, 
+	[0x64] 	= 	spec_cb_0x64, 
+	[0x65] 	= 	spec_cb_0x65, 
+	[0x66] 	= 	spec_cb_0x66, 
+	[0x67] 	= 	spec_cb_0x67, 
+	[0x68] 	= 	spec_cb_0x68, 
+	[0x69] 	= 	spec_cb_0x69, 
+	[0x6a] 	= 	spec_cb_0x6a, 
+	[0x6b] 	= 	spec_cb_0x6b, 
+	[0x6c] 	= 	spec_cb_0x6c, 
+	[0x6d] 	= 	spec_cb_0x6d, 
+	[0x6e] 	= 	spec_cb_0x6e, 
+	[0x6f] 	= 	spec_cb_0x6f, 
+	[0x70] 	= 	spec_cb_0x70, 
+	[0x71] 	= 	spec_cb_0x71, 
+	[0x72] 	= 	spec_cb_0x72, 
+	[0x73] 	= 	spec_cb_0x73, 
+	[0x74] 	= 	spec_cb_0x74, 
+	[0x75] 	= 	spec_cb_0x75, 
+	[0x76] 	= 	spec_cb_0x76, 
+	[0x77] 	= 	spec_cb_0x77, 
+	[0x78] 	= 	spec_cb_0x78, 
+	[0x79] 	= 	spec_cb_0x79, 
+	[0x7a] 	= 	spec_cb_0x7a, 
+	[0x7b] 	= 	spec_cb_0x7b, 
+	[0x7c] 	= 	spec_cb_0x7c, 
+	[0x7d] 	= 	spec_cb_0x7d, 
+	[0x7e] 	= 	spec_cb_0x7e, 
+	[0x7f] 	= 	spec_cb_0x7f, 
+	[0x80] 	= 	spec_cb_0x80, 
+	[0x81] 	= 	spec_cb_0x81, 
+	[0x82] 	= 	spec_cb_0x82, 
+	[0x83] 	= 	spec_cb_0x83, 
+	[0x84] 	= 	spec_cb_0x84, 
+	[0x85] 	= 	spec_cb_0x85, 
+	[0x86] 	= 	spec_cb_0x86, 
+	[0x87] 	= 	spec_cb_0x87, 
+	[0x88] 	= 	spec_cb_0x88, 
+	[0x89] 	= 	spec_cb_0x89, 
+	[0x8a] 	= 	spec_cb_0x8a, 
+	[0x8b] 	= 	spec_cb_0x8b, 
+	[0x8c] 	= 	spec_cb_0x8c, 
+	[0x8d] 	= 	spec_cb_0x8d, 
+	[0x8e] 	= 	spec_cb_0x8e, 
+	[0x8f] 	= 	spec_cb_0x8f, 
+	[0x90] 	= 	spec_cb_0x90, 
+	[0x91] 	= 	spec_cb_0x91, 
+	[0x92] 	= 	spec_cb_0x92, 
+	[0x93] 	= 	spec_cb_0x93, 
+	[0x94] 	= 	spec_cb_0x94, 
+	[0x95] 	= 	spec_cb_0x95, 
+	[0x96] 	= 	spec_cb_0x96, 
+	[0x97] 	= 	spec_cb_0x97, 
+	[0x98] 	= 	spec_cb_0x98, 
+	[0x99] 	= 	spec_cb_0x99, 
+	[0x9a] 	= 	spec_cb_0x9a, 
+	[0x9b] 	= 	spec_cb_0x9b, 
+	[0x9c] 	= 	spec_cb_0x9c, 
+	[0x9d] 	= 	spec_cb_0x9d, 
+	[0x9e] 	= 	spec_cb_0x9e, 
+	[0x9f] 	= 	spec_cb_0x9f, 
+	[0xa0] 	= 	spec_cb_0xa0, 
+	[0xa1] 	= 	spec_cb_0xa1, 
+	[0xa2] 	= 	spec_cb_0xa2, 
+	[0xa3] 	= 	spec_cb_0xa3, 
+	[0xa4] 	= 	spec_cb_0xa4, 
+	[0xa5] 	= 	spec_cb_0xa5, 
+	[0xa6] 	= 	spec_cb_0xa6, 
+	[0xa7] 	= 	spec_cb_0xa7, 
+	[0xa8] 	= 	spec_cb_0xa8, 
+	[0xa9] 	= 	spec_cb_0xa9, 
+	[0xaa] 	= 	spec_cb_0xaa, 
+	[0xab] 	= 	spec_cb_0xab, 
+	[0xac] 	= 	spec_cb_0xac, 
+	[0xad] 	= 	spec_cb_0xad, 
+	[0xae] 	= 	spec_cb_0xae, 
+	[0xaf] 	= 	spec_cb_0xaf, 
+	[0xb0] 	= 	spec_cb_0xb0, 
+	[0xb1] 	= 	spec_cb_0xb1, 
+	[0xb2] 	= 	spec_cb_0xb2, 
+	[0xb3] 	= 	spec_cb_0xb3, 
+	[0xb4] 	= 	spec_cb_0xb4, 
+	[0xb5] 	= 	spec_cb_0xb5, 
+	[0xb6] 	= 	spec_cb_0xb6, 
+	[0xb7] 	= 	spec_cb_0xb7, 
+	[0xb8] 	= 	spec_cb_0xb8, 
+	[0xb9] 	= 	spec_cb_0xb9, 
+	[0xba] 	= 	spec_cb_0xba, 
+	[0xbb] 	= 	spec_cb_0xbb, 
+	[0xbc] 	= 	spec_cb_0xbc, 
+	[0xbd] 	= 	spec_cb_0xbd, 
+	[0xbe] 	= 	spec_cb_0xbe, 
+	[0xbf] 	= 	spec_cb_0xbf, 
+	[0xc0] 	= 	spec_cb_0xc0, 
+	[0xc1] 	= 	spec_cb_0xc1, 
+	[0xc2] 	= 	spec_cb_0xc2, 
+	[0xc3] 	= 	spec_cb_0xc3, 
+	[0xc4] 	= 	spec_cb_0xc4, 
+	[0xc5] 	= 	spec_cb_0xc5, 
+	[0xc6] 	= 	spec_cb_0xc6, 
+	[0xc7] 	= 	spec_cb_0xc7, 
+	[0xc8] 	= 	spec_cb_0xc8, 
+	[0xc9] 	= 	spec_cb_0xc9, 
+	[0xca] 	= 	spec_cb_0xca, 
+	[0xcb] 	= 	spec_cb_0xcb, 
+	[0xcc] 	= 	spec_cb_0xcc, 
+	[0xcd] 	= 	spec_cb_0xcd, 
+	[0xce] 	= 	spec_cb_0xce, 
+	[0xcf] 	= 	spec_cb_0xcf, 
+	[0xd0] 	= 	spec_cb_0xd0, 
+	[0xd1] 	= 	spec_cb_0xd1, 
+	[0xd2] 	= 	spec_cb_0xd2, 
+	[0xd3] 	= 	spec_cb_0xd3, 
+	[0xd4] 	= 	spec_cb_0xd4, 
+	[0xd5] 	= 	spec_cb_0xd5, 
+	[0xd6] 	= 	spec_cb_0xd6, 
+	[0xd7] 	= 	spec_cb_0xd7, 
+	[0xd8] 	= 	spec_cb_0xd8, 
+	[0xd9] 	= 	spec_cb_0xd9, 
+	[0xda] 	= 	spec_cb_0xda, 
+	[0xdb] 	= 	spec_cb_0xdb, 
+	[0xdc] 	= 	spec_cb_0xdc, 
+	[0xdd] 	= 	spec_cb_0xdd, 
+	[0xde] 	= 	spec_cb_0xde, 
+	[0xdf] 	= 	spec_cb_0xdf, 
+	[0xe0] 	= 	spec_cb_0xe0, 
+	[0xe1] 	= 	spec_cb_0xe1, 
+	[0xe2] 	= 	spec_cb_0xe2, 
+	[0xe3] 	= 	spec_cb_0xe3, 
+	[0xe4] 	= 	spec_cb_0xe4, 
+	[0xe5] 	= 	spec_cb_0xe5, 
+	[0xe6] 	= 	spec_cb_0xe6, 
+	[0xe7] 	= 	spec_cb_0xe7, 
+	[0xe8] 	= 	spec_cb_0xe8, 
+	[0xe9] 	= 	spec_cb_0xe9, 
+	[0xea] 	= 	spec_cb_0xea, 
+	[0xeb] 	= 	spec_cb_0xeb, 
+	[0xec] 	= 	spec_cb_0xec, 
+	[0xed] 	= 	spec_cb_0xed, 
+	[0xee] 	= 	spec_cb_0xee, 
+	[0xef] 	= 	spec_cb_0xef, 
+	[0xf0] 	= 	spec_cb_0xf0, 
+	[0xf1] 	= 	spec_cb_0xf1, 
+	[0xf2] 	= 	spec_cb_0xf2, 
+	[0xf3] 	= 	spec_cb_0xf3, 
+	[0xf4] 	= 	spec_cb_0xf4, 
+	[0xf5] 	= 	spec_cb_0xf5, 
+	[0xf6] 	= 	spec_cb_0xf6, 
+	[0xf7] 	= 	spec_cb_0xf7, 
+	[0xf8] 	= 	spec_cb_0xf8, 
+	[0xf9] 	= 	spec_cb_0xf9, 
+	[0xfa] 	= 	spec_cb_0xfa, 
+	[0xfb] 	= 	spec_cb_0xfb, 
+	[0xfc] 	= 	spec_cb_0xfc, 
+	[0xfd] 	= 	spec_cb_0xfd, 
+	[0xfe] 	= 	spec_cb_0xfe, 
+	[0xff] 	= 	spec_cb_0xff, 
+
+};
+
+#endif // CPU_SPECIALIZED_HANDLERS
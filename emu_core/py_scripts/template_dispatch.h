@@ -0,0 +1,58 @@
+/*
+    Threaded interpreter loop, generated by gen_optable.py from `template_dispatch.h`.
+    Included at the end of cpu_instrs.c so the instr_* handlers can be inlined into it.
+*/
+#include <cpu_instrs.h>
+
+#if CPU_THREADED_DISPATCH
+
+void cpu_run_batch(cpu_context_t *context)
+{
+    uint8_t opcode;
+
+/*
+    Superinstruction: once the first handler of a fused pair ran, run the
+    second one straight away if its opcode follows, without going through
+    the dispatch table. Peeked after the first one, so jumps and code
+    writes are seen.
+*/
+#define DISPATCH_FUSED(next_opcode, handler)                                    \
+    do {                                                                        \
+        if (context->cycles < context->deadline                                 \
+            && cpu_peek_pc(context) == (next_opcode)){                          \
+            (void) cpu_fetch_pc(context);                                       \
+            handler(context, next_opcode);                                      \
+        }                                                                       \
+    } while (0)
+
+#if defined(__GNUC__) && !defined(CPU_DISPATCH_FORCE_SWITCH)
+    /* Labels-as-values: every handler jumps straight to the next one */
+    static const void *dispatch_table[256] = {
+        /*DISPATCH_LABELS*/
+    };
+
+#define DISPATCH_NEXT()                                     \
+    do {                                                    \
+        if (context->cycles >= context->deadline) return;   \
+        opcode = cpu_fetch_pc(context);                     \
+        goto *dispatch_table[opcode];                       \
+    } while (0)
+
+    DISPATCH_NEXT();
+    /*THREADED_OPS*/
+
+#undef DISPATCH_NEXT
+#else
+    /* Portable fallback, a single switch in a loop */
+    while (context->cycles < context->deadline) {
+        opcode = cpu_fetch_pc(context);
+        switch (opcode) {
+            /*SWITCH_CASES*/
+        }
+    }
+#endif
+
+#undef DISPATCH_FUSED
+}
+
+#endif // CPU_THREADED_DISPATCH
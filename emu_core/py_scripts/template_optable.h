@@ -8,3 +8,15 @@ INSTR_FUNC optable[256] = {
 INSTR_FUNC prefix_optable[256] = {
     /*PREFIX_OPTABLE*/
 };
+
+const uint8_t opcode_lengths[256] = {
+    /*OPCODE_LENGTHS*/
+};
+
+const uint8_t opcode_cycles[256] = {
+    /*OPCODE_CYCLES*/
+};
+
+const uint8_t prefix_opcode_cycles[256] = {
+    /*PREFIX_OPCODE_CYCLES*/
+};
@@ -0,0 +1,31 @@
+/*
+    Specialized handlers, generated by gen_optable.py from `template_spec_handlers.h`.
+    
+    One function per concrete opcode (both the main and the CB page), each calling
+    its generic handler with a constant opcode. The whole call tree is flattened
+    into the wrapper, so register, bit index and ALU op decoding fold away.
+    Included at the end of cpu_instrs.c.
+*/
+#include <cpu_instrs.h>
+
+#if CPU_SPECIALIZED_HANDLERS
+
+#if defined(__GNUC__)
+#define SPEC_HANDLER static __attribute__((flatten)) void
+#else
+#define SPEC_HANDLER static void
+#endif
+
+/*SPEC_HANDLERS*/
+
+#undef SPEC_HANDLER
+
+INSTR_FUNC spec_optable[256] = {
+    /*SPEC_OPTABLE*/
+};
+
+INSTR_FUNC spec_prefix_optable[256] = {
+    /*SPEC_PREFIX_OPTABLE*/
+};
+
+#endif // CPU_SPECIALIZED_HANDLERS
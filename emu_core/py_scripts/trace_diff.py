@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+Diffs our per-instruction CPU state against a reference log from another
+emulator, both in gameboy-doctor format, and stops at the first divergence:
+
+    A:01 F:B0 B:00 C:13 D:00 E:D8 H:01 L:4D SP:FFFE PC:0100 PCMEM:00,C3,13,02
+
+Text logs are mmap'd and walked line by line, binary traces from the CPU
+tracer (core/tracer.h) are expanded on the fly, so memory use stays constant
+whatever the size of the logs. Only the fields of the reference line are
+compared, extra fields on our side (e.g. bus accesses) are ignored.
+
+Usage:
+    python3 ./trace_diff.py reference.log trace.bin
+    python3 ./trace_diff.py reference.log ours.log --context 20 --sync-pc 0100
+"""
+import argparse
+import collections
+import mmap
+import sys
+
+from trace_expand import TRACER_MAGIC, format_accesses, iter_records
+
+DEFAULT_CONTEXT = 10
+
+
+def iter_text_lines(file):
+    """
+    Yields (line, None) per non-empty line of a text log, through mmap.
+    """
+    try:
+        mem = mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ)
+    except ValueError:
+        # Empty file
+        return
+
+    with mem:
+        if hasattr(mem, "madvise") and hasattr(mmap, "MADV_SEQUENTIAL"):
+            mem.madvise(mmap.MADV_SEQUENTIAL)
+
+        pos = 0
+        size = len(mem)
+        while pos < size:
+            end = mem.find(b"\n", pos)
+            if end < 0:
+                end = size
+            line = mem[pos:end].rstrip(b"\r ").decode("ascii", "replace")
+            pos = end + 1
+            if line:
+                yield line, None
+
+
+def open_log(path):
+    """
+    Yields (line, accesses or None) per instruction of a text log or binary trace.
+    """
+    with open(path, "rb") as file:
+        is_trace = file.read(len(TRACER_MAGIC)) == TRACER_MAGIC
+        file.seek(0)
+        yield from iter_records(file) if is_trace else iter_text_lines(file)
+
+
+def parse_fields(line):
+    """
+    `KEY:VALUE` tokens of a line, values upper-cased.
+    """
+    fields = {}
+    for token in line.split():
+        key, sep, value = token.partition(":")
+        if sep:
+            fields[key.upper()] = value.upper()
+    return fields
+
+
+def diff_fields(ref_line, our_line):
+    """
+    Fields of the reference line whose value differs on our side, as
+    (key, reference value, our value). Empty when the lines match.
+    """
+    if ref_line == our_line:
+        return []
+
+    ours = parse_fields(our_line)
+    return [(key, value, ours.get(key, "-"))
+            for key, value in parse_fields(ref_line).items() if ours.get(key) != value]
+
+
+def skip_to_pc(log, pc):
+    """
+    Drops lines until the first one at `pc`, returns it with its index.
+    """
+    target = f"PC:{pc:04X}"
+    for index, record in enumerate(log):
+        if target in record[0].upper():
+            return index, record
+    return None, None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Diff CPU state logs in gameboy-doctor format.")
+    parser.add_argument("reference", help="reference log (text)")
+    parser.add_argument("ours", help="our log, text or binary trace from tracer_start()")
+    parser.add_argument("--context", type=int, default=DEFAULT_CONTEXT,
+                        help="matching lines to show before the divergence")
+    parser.add_argument("--sync-pc", type=lambda value: int(value, 16), default=None,
+                        help="skip both logs up to the first instruction at this PC (hex), "
+                             "e.g. 0100 when only one side runs the boot ROM")
+    args = parser.parse_args()
+
+    ref_log = open_log(args.reference)
+    our_log = open_log(args.ours)
+    ref_offset = our_offset = 0
+    pending = []
+
+    if args.sync_pc is not None:
+        ref_offset, ref_first = skip_to_pc(ref_log, args.sync_pc)
+        our_offset, our_first = skip_to_pc(our_log, args.sync_pc)
+        if ref_first is None or our_first is None:
+            sys.exit(f"PC {args.sync_pc:04X} never reached in the "
+                     f"{'reference' if ref_first is None else 'our'} log")
+        pending = [(ref_first, our_first)]
+
+    history = collections.deque(maxlen=max(args.context, 0))
+    count = 0
+
+    while True:
+        if pending:
+            ref_record, our_record = pending.pop()
+        else:
+            ref_record = next(ref_log, None)
+            our_record = next(our_log, None)
+        if ref_record is None or our_record is None:
+            break
+
+        ref_line = ref_record[0]
+        our_line, our_accesses = our_record
+        diffs = diff_fields(ref_line, our_line)
+        if diffs:
+            print(f"Divergence at instruction {count} "
+                  f"(reference line {ref_offset + count + 1}, ours {our_offset + count + 1})")
+            print()
+            for ref_index, line, accesses in history:
+                suffix = f"  {format_accesses(accesses)}" if accesses else ""
+                print(f"  {ref_index:>10}  {line}{suffix}")
+            print(f"  ref {ref_offset + count + 1:>6}  {ref_line}")
+            print(f"  ours {our_offset + count + 1:>5}  {our_line}")
+            print()
+            for key, ref_value, our_value in diffs:
+                print(f"  {key}: expected {ref_value}, got {our_value}")
+            sys.exit(1)
+
+        history.append((ref_offset + count + 1, our_line, our_accesses))
+        count += 1
+
+    if ref_record is not None:
+        print(f"No divergence, our log ends after {count} matching instructions")
+    elif our_record is not None:
+        print(f"No divergence, the reference log ends after {count} matching instructions")
+    else:
+        print(f"Logs match, {count} instructions")
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except BrokenPipeError:
+        pass
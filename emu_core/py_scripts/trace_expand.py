@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+Expands a binary trace written by the CPU tracer (core/tracer.h) into
+gameboy-doctor text, one line per instruction:
+
+    A:01 F:B0 B:00 C:13 D:00 E:D8 H:01 L:4D SP:FFFE PC:0100 PCMEM:00,C3,13,02
+
+Usage:
+    python3 ./trace_expand.py trace.bin > trace.txt
+    python3 ./trace_expand.py trace.bin --accesses --limit 100000
+"""
+import argparse
+import sys
+
+TRACER_MAGIC = b"GBTR"
+TRACER_VERSION = 1
+
+TRACER_REC_SP = 0x01
+TRACER_REC_PC_DELTA = 0x02
+TRACER_REC_PC_FULL = 0x04
+TRACER_REC_ACCESSES = 0x08
+TRACER_REC_PCMEM_SHIFT = 4
+
+TRACER_ACCESS_WRITE = 1
+
+READ_CHUNK = 1 << 20
+
+
+class TraceReader:
+    """
+    Buffered reader over the trace, records may straddle chunks.
+    """
+
+    def __init__(self, file):
+        self.file = file
+        self.buf = b""
+        self.pos = 0
+
+    def read(self, size):
+        if self.pos + size > len(self.buf):
+            self.buf = self.buf[self.pos:] + self.file.read(max(READ_CHUNK, size))
+            self.pos = 0
+            if size > len(self.buf):
+                return None
+        data = self.buf[self.pos:self.pos + size]
+        self.pos += size
+        return data
+
+    def u8(self):
+        data = self.read(1)
+        if data is None:
+            raise EOFError
+        return data[0]
+
+    def u16(self):
+        data = self.read(2)
+        if data is None:
+            raise EOFError
+        return data[0] | (data[1] << 8)
+
+
+def iter_records(file):
+    """
+    Yields (gameboy-doctor line, [(kind, addr, value), ...]) per instruction.
+    """
+    reader = TraceReader(file)
+
+    header = reader.read(len(TRACER_MAGIC) + 1)
+    if header is None or header[:4] != TRACER_MAGIC:
+        sys.exit("not a trace file")
+    if header[4] != TRACER_VERSION:
+        sys.exit(f"unsupported trace version {header[4]}")
+
+    regs = [0] * 8
+    sp = 0
+    pc = 0
+    shadow = bytearray(0x10000)
+
+    while True:
+        try:
+            regs_mask = reader.read(1)
+            if regs_mask is None:
+                return
+            regs_mask = regs_mask[0]
+            flags = reader.u8()
+
+            for i in range(8):
+                if regs_mask & (1 << i):
+                    regs[i] = reader.u8()
+
+            if flags & TRACER_REC_SP:
+                sp = reader.u16()
+
+            if flags & TRACER_REC_PC_FULL:
+                pc = reader.u16()
+            elif flags & TRACER_REC_PC_DELTA:
+                delta = reader.u8()
+                pc = (pc + (delta - 256 if delta >= 128 else delta)) & 0xFFFF
+
+            for i in range(4):
+                if flags & (1 << (TRACER_REC_PCMEM_SHIFT + i)):
+                    shadow[(pc + i) & 0xFFFF] = reader.u8()
+
+            accesses = []
+            if flags & TRACER_REC_ACCESSES:
+                for _ in range(reader.u8()):
+                    kind = reader.u8()
+                    addr = reader.u16()
+                    value = reader.u8()
+                    accesses.append(("W" if kind == TRACER_ACCESS_WRITE else "R", addr, value))
+        except EOFError:
+            sys.stderr.write("warning: trace ends in the middle of a record\n")
+            return
+
+        pcmem = ",".join(f"{shadow[(pc + i) & 0xFFFF]:02X}" for i in range(4))
+        line = (f"A:{regs[0]:02X} F:{regs[1]:02X} B:{regs[2]:02X} C:{regs[3]:02X} "
+                f"D:{regs[4]:02X} E:{regs[5]:02X} H:{regs[6]:02X} L:{regs[7]:02X} "
+                f"SP:{sp:04X} PC:{pc:04X} PCMEM:{pcmem}")
+        yield line, accesses
+
+
+def format_accesses(accesses):
+    return " ".join(f"{kind}:{addr:04X}={value:02X}" for kind, addr, value in accesses)
+
+
+def expand(file, out, with_accesses, limit):
+    for count, (line, accesses) in enumerate(iter_records(file)):
+        if limit is not None and count >= limit:
+            break
+        if with_accesses and accesses:
+            line += " " + format_accesses(accesses)
+        out.write(line + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Expand a binary CPU trace to gameboy-doctor text.")
+    parser.add_argument("trace", help="trace file written by tracer_start()")
+    parser.add_argument("--accesses", action="store_true",
+                        help="append the bus accesses of each instruction (not gameboy-doctor compatible)")
+    parser.add_argument("--limit", type=int, default=None, help="stop after this many instructions")
+    args = parser.parse_args()
+
+    with open(args.trace, "rb") as file:
+        try:
+            expand(file, sys.stdout, args.accesses, args.limit)
+        except BrokenPipeError:
+            pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,236 @@
+#include <batch.h>
+#include <emulator.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Jobs left to a worker, [next, end) packed in one word so both move at once */
+#define BATCH_RANGE(next, end)      (((uint64_t) (next) << 32) | (uint32_t) (end))
+#define BATCH_RANGE_NEXT(range)     ((uint32_t) ((range) >> 32))
+#define BATCH_RANGE_END(range)      ((uint32_t) (range))
+
+typedef struct batch_worker {
+    /* Taken from the front by the owner, stolen from the back by the others */
+    _Alignas(GB_CACHE_LINE_SIZE) _Atomic uint64_t range;
+
+    batch_pool_t *pool;
+    unsigned index;
+    pthread_t thread;
+} batch_worker_t;
+
+struct batch_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+
+    /* Bumped for every batch, workers wait for it to change */
+    uint64_t generation;
+    unsigned running;
+    bool stopping;
+
+    /* Current batch */
+    batch_job_t *jobs;
+    unsigned frames;
+    batch_input_hook_t input_hook;
+
+    unsigned threads;
+    batch_worker_t workers[BATCH_MAX_THREADS];
+};
+
+/**
+ *  Takes the next job of the worker's own range.
+ */
+static bool take_job(batch_worker_t *worker, uint32_t *job)
+{
+    uint64_t range = atomic_load(&worker->range);
+
+    while (BATCH_RANGE_NEXT(range) < BATCH_RANGE_END(range)){
+        uint64_t rest = BATCH_RANGE(BATCH_RANGE_NEXT(range) + 1, BATCH_RANGE_END(range));
+
+        if (atomic_compare_exchange_weak(&worker->range, &range, rest)){
+            *job = BATCH_RANGE_NEXT(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ *  Moves the back half of another worker's range into the empty range of
+ *  `worker`. Returns false once every range is empty.
+ */
+static bool steal_jobs(batch_worker_t *worker)
+{
+    batch_pool_t *pool = worker->pool;
+
+    for (unsigned i = 1; i < pool->threads; ++i){
+        batch_worker_t *victim = &pool->workers[(worker->index + i) % pool->threads];
+        uint64_t range = atomic_load(&victim->range);
+
+        while (BATCH_RANGE_NEXT(range) < BATCH_RANGE_END(range)){
+            uint32_t next = BATCH_RANGE_NEXT(range), end = BATCH_RANGE_END(range);
+            uint32_t split = end - (end - next + 1) / 2;
+
+            if (atomic_compare_exchange_weak(&victim->range, &range, BATCH_RANGE(next, split))){
+                atomic_store(&worker->range, BATCH_RANGE(split, end));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void run_job(batch_pool_t *pool, batch_job_t *job)
+{
+    gb_instance_t *gb = job->gb;
+    m_cycle_t cycles = 0;
+
+    for (unsigned frame = 0; frame < pool->frames; ++frame){
+        if (pool->input_hook != NULL) pool->input_hook(gb, job->input, frame);
+        cycles += emulator_run_frame(gb);
+    }
+
+    job->cycles = cycles;
+    job->view = batch_get_view(gb);
+}
+
+static void run_worker(batch_worker_t *worker)
+{
+    uint32_t job;
+
+    do {
+        while (take_job(worker, &job)){
+            run_job(worker->pool, &worker->pool->jobs[job]);
+        }
+    } while (steal_jobs(worker));
+}
+
+static void *worker_thread(void *arg)
+{
+    batch_worker_t *worker = arg;
+    batch_pool_t *pool = worker->pool;
+    uint64_t seen = 0;
+
+    while (true){
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->stopping){
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        seen = pool->generation;
+        bool stopping = pool->stopping;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (stopping) return NULL;
+
+        run_worker(worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+batch_pool_t *batch_pool_create(unsigned threads)
+{
+    if (threads == 0){
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cores > 0) ? (unsigned) cores : 1;
+    }
+    if (threads > BATCH_MAX_THREADS) threads = BATCH_MAX_THREADS;
+
+    /* aligned_alloc wants a multiple of the alignment */
+    size_t size = (sizeof(batch_pool_t) + GB_CACHE_LINE_SIZE - 1) / GB_CACHE_LINE_SIZE * GB_CACHE_LINE_SIZE;
+    batch_pool_t *pool = aligned_alloc(GB_CACHE_LINE_SIZE, size);
+    if (pool == NULL) return NULL;
+
+    memset(pool, 0, size);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    /* Worker 0 is the thread calling `batch_step` */
+    pool->threads = 1;
+    pool->workers[0] = (batch_worker_t) { .pool = pool, .index = 0 };
+
+    for (unsigned i = 1; i < threads; ++i){
+        batch_worker_t *worker = &pool->workers[i];
+        *worker = (batch_worker_t) { .pool = pool, .index = i };
+
+        if (pthread_create(&worker->thread, NULL, worker_thread, worker) != 0){
+            batch_pool_destroy(pool);
+            return NULL;
+        }
+        pool->threads++;
+    }
+
+    return pool;
+}
+
+void batch_pool_destroy(batch_pool_t *pool)
+{
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (unsigned i = 1; i < pool->threads; ++i){
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+unsigned batch_pool_get_threads(batch_pool_t *pool)
+{
+    return pool->threads;
+}
+
+void batch_set_input_hook(batch_pool_t *pool, batch_input_hook_t hook)
+{
+    pool->input_hook = hook;
+}
+
+void batch_step(batch_pool_t *pool, batch_job_t *jobs, unsigned count, unsigned frames)
+{
+    if (count == 0) return;
+
+    /* Neighbouring jobs stay on the same worker until stolen */
+    for (unsigned i = 0; i < pool->threads; ++i){
+        uint32_t start = (uint32_t) ((uint64_t) count * i / pool->threads);
+        uint32_t end = (uint32_t) ((uint64_t) count * (i + 1) / pool->threads);
+        atomic_store(&pool->workers[i].range, BATCH_RANGE(start, end));
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->jobs = jobs;
+    pool->frames = frames;
+    pool->running = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_worker(&pool->workers[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running > 0){
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+batch_view_t batch_get_view(gb_instance_t *gb)
+{
+    return (batch_view_t) {
+        .frame = gb->memory.vram,
+        .wram = gb->memory.wram,
+        .oam = gb->memory.oam,
+        .hram = gb->memory.hram
+    };
+}
@@ -1,43 +1,180 @@
 
 #include <common.h>
-#include <bus.h>
+#include <core/bus.h>
+#include <gb_instance.h>
+#include <platform/error_handling.h>
 
-static bus_context_t bus_context;
+/* Value returned when reading from an unmapped address (open bus) */
+#define BUS_OPEN_BUS_VALUE      0xFFu
 
 /**
- *  Finds a peripheral has addr in its address range.
+ *  Checks whether the connection's range spans the entire page.
  */
-static master_slave_conn_t *find_peripheral(addr_t addr)
+static bool conn_covers_page(master_slave_conn_t *conn, uint8_t page)
 {
-    for (int i = 0; i < bus_context.connections_size; ++i){ 
-        master_slave_conn_t *conn = bus_context.connections[i];
-        if ((conn->start_addr <= addr) && (addr <= conn->end_addr))
-        {
-            return conn;
+    addr_t page_start = (addr_t) (page << BUS_PAGE_SHIFT);
+    addr_t page_end = (addr_t) (page_start + BUS_PAGE_SIZE - 1);
+
+    return (conn->start_addr <= page_start) && (page_end <= conn->end_addr);
+}
+
+/**
+ *  Compiles a single page of the dispatch table.
+ */
+static void compile_page(gb_instance_t *gb, uint8_t page)
+{
+    bus_setup_t *bus = &gb->bus_setup;
+    bus_page_t *entry = &gb->bus.pages[page];
+    addr_t page_start = (addr_t) (page << BUS_PAGE_SHIFT);
+    addr_t page_end = (addr_t) (page_start + BUS_PAGE_SIZE - 1);
+    master_slave_conn_t *owner = NULL;
+    unsigned owners = 0;
+
+    for (unsigned i = 0; i < bus->connections_size; ++i){
+        master_slave_conn_t *conn = bus->connections[i];
+        if (conn->start_addr <= page_end && page_start <= conn->end_addr){
+            owner = conn;
+            owners++;
+        }
+    }
+
+    /* Shared tables are kept once allocated, a page never changes owners */
+    master_slave_conn_t **shared = entry->shared;
+    bool watched = entry->watched;
+    *entry = (bus_page_t) { .watched = watched };
+
+    if (owners == 1 && conn_covers_page(owner, page)){
+        uint16_t offset = page_start - owner->start_addr;
+        entry->conn = owner;
+        entry->read_mem = owner->direct_read ? &owner->direct_read[offset] : NULL;
+        entry->write_mem = (owner->direct_write && !watched) ? &owner->direct_write[offset] : NULL;
+        return;
+    }
+
+    if (owners == 0) return;
+
+    /* Partially mapped or shared page, build the per-byte table */
+    if (shared == NULL){
+        if (bus->shared_pages_size == BUS_MAX_SHARED_PAGES){
+            emu_die(STATUS_FULL_CONTAINER, "Too many shared bus pages.");
         }
+        shared = bus->shared_pages[bus->shared_pages_size++];
     }
 
-    /* Should never happen */
-    return NULL;
+    for (unsigned offset = 0; offset < BUS_PAGE_SIZE; ++offset){
+        addr_t addr = (addr_t) (page_start + offset);
+        shared[offset] = NULL;
+        for (unsigned i = 0; i < bus->connections_size; ++i){
+            master_slave_conn_t *conn = bus->connections[i];
+            if (conn->start_addr <= addr && addr <= conn->end_addr){
+                shared[offset] = conn;
+                break;
+            }
+        }
+    }
+    entry->shared = shared;
+}
+
+error_code_t bus_connect(gb_instance_t *gb, master_slave_conn_t *conn)
+{
+    bus_setup_t *bus = &gb->bus_setup;
+
+    assert(conn != NULL);
+    assert(conn->start_addr <= conn->end_addr);
+
+    if (bus->connections_size == MAX_DEVICE_NUMBER){
+        return STATUS_FULL_CONTAINER;
+    }
+
+    /* Reject overlapping ranges, the page table assumes a single owner per address */
+    for (unsigned i = 0; i < bus->connections_size; ++i){
+        master_slave_conn_t *other = bus->connections[i];
+        if (conn->start_addr <= other->end_addr && other->start_addr <= conn->end_addr){
+            return STATUS_BUS_CONFLICT;
+        }
+    }
+
+    bus->connections[bus->connections_size++] = conn;
+    return STATUS_OK;
+}
+
+void bus_init(gb_instance_t *gb)
+{
+    for (unsigned page = 0; page < BUS_PAGE_COUNT; ++page){
+        compile_page(gb, (uint8_t) page);
+    }
+}
+
+void bus_update_connection(gb_instance_t *gb, master_slave_conn_t *conn)
+{
+    for (unsigned page = BUS_PAGE_OF(conn->start_addr); page <= BUS_PAGE_OF(conn->end_addr); ++page){
+        compile_page(gb, (uint8_t) page);
+    }
+}
+
+const uint8_t *bus_get_page_mem(gb_instance_t *gb, addr_t addr)
+{
+    return gb->bus.pages[BUS_PAGE_OF(addr)].read_mem;
+}
+
+const uint8_t *bus_get_read_window(gb_instance_t *gb, addr_t addr, addr_t *start, addr_t *end)
+{
+    bus_page_t *entry = &gb->bus.pages[BUS_PAGE_OF(addr)];
+
+    if (entry->read_mem == NULL) return NULL;
+
+    *start = entry->conn->start_addr;
+    *end = entry->conn->end_addr;
+    return entry->conn->direct_read;
+}
+
+void bus_set_write_watcher(gb_instance_t *gb, bus_write_watcher_t watcher)
+{
+    gb->bus_setup.write_watcher = watcher;
+}
+
+void bus_watch_page(gb_instance_t *gb, uint8_t page)
+{
+    gb->bus.pages[page].watched = true;
+    compile_page(gb, page);
+}
+
+void bus_unwatch_page(gb_instance_t *gb, uint8_t page)
+{
+    gb->bus.pages[page].watched = false;
+    compile_page(gb, page);
 }
 
 /*
     Read data from bus.
     Returns:
-        - error status
-        - `read_result (uint8_t)`:  Read result from bus 
+        - `read_result (uint8_t)`:  Read result from bus
 */
-int bus_read(addr_t addr, uint8_t *read_result)
+uint8_t bus_read(gb_instance_t *gb, addr_t addr)
 {
-    error_code_t error_code;
-    master_slave_conn_t *periph_conn = find_peripheral(addr);
-    
-    /* SEGFAULT */
-    if (periph_conn == NULL){
-        return -1;
+    bus_page_t *entry = &gb->bus.pages[BUS_PAGE_OF(addr)];
+    master_slave_conn_t *conn = entry->conn;
+    uint8_t read_result = BUS_OPEN_BUS_VALUE;
+
+    /* Fast path, plain memory */
+    if (entry->read_mem != NULL){
+        return entry->read_mem[BUS_PAGE_OFFSET(addr)];
+    }
+
+    if (entry->shared != NULL){
+        conn = entry->shared[BUS_PAGE_OFFSET(addr)];
+        if (conn != NULL && conn->direct_read != NULL){
+            return conn->direct_read[addr - conn->start_addr];
+        }
     }
 
-    return msconn_master_read(periph_conn, addr, read_result);
+    /* Unmapped */
+    if (conn == NULL){
+        return read_result;
+    }
+
+    conn->slave_read(conn->slave_context, addr, &read_result);
+    return read_result;
 }
 
 /*
@@ -45,13 +182,34 @@ int bus_read(addr_t addr, uint8_t *read_result)
     Returns:
         - error status
 */
-int bus_write(addr_t addr, uint8_t value)
+error_code_t bus_write(gb_instance_t *gb, addr_t addr, uint8_t value)
 {
-    master_slave_conn_t *periph_conn = find_peripheral(addr);
+    bus_page_t *entry = &gb->bus.pages[BUS_PAGE_OF(addr)];
+    master_slave_conn_t *conn = entry->conn;
+
+    /* Fast path, plain memory */
+    if (entry->write_mem != NULL){
+        entry->write_mem[BUS_PAGE_OFFSET(addr)] = value;
+        return STATUS_OK;
+    }
+
+    if (entry->watched && gb->bus_setup.write_watcher != NULL){
+        gb->bus_setup.write_watcher(gb, addr);
+    }
+
+    if (entry->shared != NULL){
+        conn = entry->shared[BUS_PAGE_OFFSET(addr)];
+    }
+
     /* SEGFAULT */
-    if (periph_conn == NULL){
-        return -1;
+    if (conn == NULL){
+        return STATUS_SEG_FAULT;
+    }
+
+    if (conn->direct_write != NULL){
+        conn->direct_write[addr - conn->start_addr] = value;
+        return STATUS_OK;
     }
 
-    return msconn_master_write(periph_conn, addr, value);
-}
\ No newline at end of file
+    return conn->slave_write(conn->slave_context, addr, value);
+}
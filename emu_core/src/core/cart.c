@@ -1,6 +1,179 @@
-#include <machdep/cart.h>
+#include <core/cartridge/cart.h>
+#include <gb_instance.h>
+#include <core/memorymap.h>
+#include <core/bus.h>
+#include <emu_error.h>
 #include <string.h>
 
+#define ROM_BANK_SIZE           (ROM_BANK_00_END - ROM_BANK_00_BASE + 1)
+
+/* MBC1 register ranges: lower 5 bits of the ROM bank, upper 2 bits, banking mode */
+#define MBC1_ROM_BANK_BASE      0x2000
+#define MBC1_ROM_BANK_END       0x3FFF
+#define MBC1_ROM_BANK_MASK      0x1F
+#define MBC1_UPPER_BANK_BASE    0x4000
+#define MBC1_UPPER_BANK_END     0x5FFF
+#define MBC1_UPPER_BANK_MASK    0x03
+#define MBC1_UPPER_BANK_SHIFT   5
+#define MBC1_MODE_BASE          0x6000
+#define MBC1_MODE_END           0x7FFF
+#define MBC1_MODE_MASK          0x01
+
+/* Cartridge types (header 0x147) with an MBC1 */
+#define CART_TYPE_MBC1          0x01
+#define CART_TYPE_MBC1_RAM_BATT 0x03
+
+
+const char *OLD_LICENSEE_NAMES[0x100] = {     
+    [0x00] = "None",     
+    [0x01] = "Nintendo",     
+    [0x08] = "Capcom",     
+    [0x09] = "HOT-B",     
+    [0x0A] = "Jaleco",     
+    [0x0B] = "Coconuts Japan",     
+    [0x0C] = "Elite Systems",     
+    [0x13] = "EA (Electronic Arts)",     
+    [0x18] = "Hudson Soft",     
+    [0x19] = "ITC Entertainment",     
+    [0x1A] = "Yanoman",     
+    [0x1D] = "Japan Clary",     
+    [0x1F] = "Virgin Games Ltd.",     
+    [0x24] = "PCM Complete",     
+    [0x25] = "San-X",     
+    [0x28] = "Kemco",     
+    [0x29] = "SETA Corporation",     
+    [0x30] = "Infogrames",     
+    [0x31] = "Nintendo",     
+    [0x32] = "Bandai",     
+    [0x33] = "Indicates that the New licensee code should be used instead.",     
+    [0x34] = "Konami",     
+    [0x35] = "HectorSoft",     
+    [0x38] = "Capcom",     
+    [0x39] = "Banpresto",     
+    [0x3C] = "Entertainment Interactive (stub)",     
+    [0x3E] = "Gremlin",     
+    [0x41] = "Ubi Soft",     
+    [0x42] = "Atlus",     
+    [0x44] = "Malibu Interactive",     
+    [0x46] = "Angel",     
+    [0x47] = "Spectrum HoloByte",     
+    [0x49] = "Irem",     
+    [0x4A] = "Virgin Games Ltd.",     
+    [0x4D] = "Malibu Interactive",     
+    [0x4F] = "U.S. Gold",     
+    [0x50] = "Absolute",     
+    [0x51] = "Acclaim Entertainment",     
+    [0x52] = "Activision",     
+    [0x53] = "Sammy USA Corporation",     
+    [0x54] = "GameTek",     
+    [0x55] = "Park Place",     
+    [0x56] = "LJN",     
+    [0x57] = "Matchbox",     
+    [0x59] = "Milton Bradley Company",     
+    [0x5A] = "Mindscape",     
+    [0x5B] = "Romstar",     
+    [0x5C] = "Naxat Soft",     
+    [0x5D] = "Tradewest",     
+    [0x60] = "Titus Interactive",     
+    [0x61] = "Virgin Games Ltd.",     
+    [0x67] = "Ocean Software",     
+    [0x69] = "EA (Electronic Arts)",     
+    [0x6E] = "Elite Systems",     
+    [0x6F] = "Electro Brain",     
+    [0x70] = "Infogrames",     
+    [0x71] = "Interplay Entertainment",     
+    [0x72] = "Broderbund",     
+    [0x73] = "Sculptured Software",     
+    [0x75] = "The Sales Curve Limited",     
+    [0x78] = "THQ",     
+    [0x79] = "Accolade",     
+    [0x7A] = "Triffix Entertainment",     
+    [0x7C] = "MicroProse",     
+    [0x7F] = "Kemco",     
+    [0x80] = "Misawa Entertainment",     
+    [0x83] = "LOZC G.",     
+    [0x86] = "Tokuma Shoten",     
+    [0x8B] = "Bullet-Proof Software",     
+    [0x8C] = "Vic Tokai Corp.",     
+    [0x8E] = "Ape Inc.",     
+    [0x8F] = "I’Max",     
+    [0x91] = "Chunsoft Co.",     
+    [0x92] = "Video System",     
+    [0x93] = "Tsubaraya Productions",     
+    [0x95] = "Varie",     
+    [0x96] = "Yonezawa/S’Pal",     
+    [0x97] = "Kemco",     
+    [0x99] = "Arc",     
+    [0x9A] = "Nihon Bussan",     
+    [0x9B] = "Tecmo",     
+    [0x9C] = "Imagineer",     
+    [0x9D] = "Banpresto",     
+    [0x9F] = "Nova",     
+    [0xA1] = "Hori Electric",     
+    [0xA2] = "Bandai",     
+    [0xA4] = "Konami",     
+    [0xA6] = "Kawada",     
+    [0xA7] = "Takara",     
+    [0xA9] = "Technos Japan",     
+    [0xAA] = "Broderbund",     
+    [0xAC] = "Toei Animation",     
+    [0xAD] = "Toho",     
+    [0xAF] = "Namco",     
+    [0xB0] = "Acclaim Entertainment",     
+    [0xB1] = "ASCII Corporation or Nexsoft",     
+    [0xB2] = "Bandai",     
+    [0xB4] = "Square Enix",     
+    [0xB6] = "HAL Laboratory",     
+    [0xB7] = "SNK",     
+    [0xB9] = "Pony Canyon",     
+    [0xBA] = "Culture Brain",     
+    [0xBB] = "Sunsoft",     
+    [0xBD] = "Sony Imagesoft",     
+    [0xBF] = "Sammy Corporation",     
+    [0xC0] = "Taito",     
+    [0xC2] = "Kemco",     
+    [0xC3] = "Square",     
+    [0xC4] = "Tokuma Shoten",     
+    [0xC5] = "Data East",     
+    [0xC6] = "Tonkin House",     
+    [0xC8] = "Koei",     
+    [0xC9] = "UFL",     
+    [0xCA] = "Ultra Games",     
+    [0xCB] = "VAP, Inc.",     
+    [0xCC] = "Use Corporation",     
+    [0xCD] = "Meldac",     
+    [0xCE] = "Pony Canyon",     
+    [0xCF] = "Angel",     
+    [0xD0] = "Taito",     
+    [0xD1] = "SOFEL (Software Engineering Lab)",     
+    [0xD2] = "Quest",     
+    [0xD3] = "Sigma Enterprises",     
+    [0xD4] = "ASK Kodansha Co.",     
+    [0xD6] = "Naxat Soft",     
+    [0xD7] = "Copya System",     
+    [0xD9] = "Banpresto",     
+    [0xDA] = "Tomy",     
+    [0xDB] = "LJN",     
+    [0xDD] = "Nippon Computer Systems",     
+    [0xDE] = "Human Ent.",     
+    [0xDF] = "Altron",     
+    [0xE0] = "Jaleco",     
+    [0xE1] = "Towa Chiki",     
+    [0xE2] = "Yutaka",     
+    [0xE3] = "Varie",     
+    [0xE5] = "Epoch",     
+    [0xE7] = "Athena",     
+    [0xE8] = "Asmik Ace Entertainment",     
+    [0xE9] = "Natsume",     
+    [0xEA] = "King Records",     
+    [0xEB] = "Atlus",     
+    [0xEC] = "Epic/Sony Records",     
+    [0xEE] = "IGS",     
+    [0xF0] = "A Wave",     
+    [0xF3] = "Extreme Entertainment",     
+    [0xFF] = "LJN" 
+};
+
 void read_rom_meta(cart_data_t *rom_data, const uint8_t *raw_buffer, size_t rom_size)
 {
     memcpy((void *) rom_data->metadata.nintendo_logo, &raw_buffer[0x104], 0x30);
@@ -23,6 +196,162 @@ void read_rom_meta(cart_data_t *rom_data, const uint8_t *raw_buffer, size_t rom_
     // metadata->global_checksum = 
 }
 
+/**
+ *  Maps `rom0_bank` into 0x0000 - 0x3FFF and `rom_bank` into 0x4000 - 0x7FFF.
+ */
+static void switch_rom_banks(gb_instance_t *gb, uint16_t rom0_bank, uint16_t rom_bank)
+{
+    cart_context_t *cart_ctx = &gb->cart;
+
+    rom0_bank %= cart_ctx->rom_bank_count;
+    rom_bank %= cart_ctx->rom_bank_count;
+    if (rom0_bank == cart_ctx->rom0_bank && rom_bank == cart_ctx->rom_bank) return;
+
+    if (rom0_bank != cart_ctx->rom0_bank){
+        cart_ctx->rom0_bank = rom0_bank;
+        cart_ctx->rom0_ms_conn.direct_read = &cart_ctx->cart_data.rom_data[rom0_bank * ROM_BANK_SIZE];
+        bus_update_connection(gb, &cart_ctx->rom0_ms_conn);
+    }
+
+    if (rom_bank != cart_ctx->rom_bank){
+        cart_ctx->rom_bank = rom_bank;
+        cart_ctx->romx_ms_conn.direct_read = &cart_ctx->cart_data.rom_data[rom_bank * ROM_BANK_SIZE];
+        bus_update_connection(gb, &cart_ctx->romx_ms_conn);
+    }
+
+    if (cart_ctx->bank_switch_hook != NULL){
+        cart_ctx->bank_switch_hook(gb, rom_bank);
+    }
+}
+
+/**
+ *  Maps the banks selected by the MBC1 registers. The upper bits also
+ *  select the bank at 0x0000 - 0x3FFF in mode 1 (carts of 1 MiB and more).
+ */
+static void mbc1_update_banks(gb_instance_t *gb)
+{
+    cart_context_t *cart_ctx = &gb->cart;
+    uint16_t upper = (uint16_t) (cart_ctx->mbc1_upper_bank << MBC1_UPPER_BANK_SHIFT);
+
+    /* Bank 0 can't be selected in the lower bits, it maps to bank 1 instead */
+    uint16_t lower = cart_ctx->mbc1_lower_bank ? cart_ctx->mbc1_lower_bank : 1;
+
+    switch_rom_banks(gb, cart_ctx->mbc1_mode ? upper : 0, upper | lower);
+}
+
+/**
+ *  Writes into ROM space are MBC control writes. Only MBC1 is emulated,
+ *  and only its ROM banking: there is no external RAM, so RAM enable is
+ *  ignored and mode 1 only changes the ROM bank at 0x0000 - 0x3FFF.
+ */
+static error_code_t rom_write(void *context, addr_t addr, uint8_t value)
+{
+    gb_instance_t *gb = (gb_instance_t *) context;
+    cart_context_t *cart_ctx = &gb->cart;
+    uint8_t cart_type = cart_ctx->cart_data.metadata.cart_type;
+
+    if (cart_type < CART_TYPE_MBC1 || cart_type > CART_TYPE_MBC1_RAM_BATT){
+        return STATUS_OK;
+    }
 
+    if (MBC1_ROM_BANK_BASE <= addr && addr <= MBC1_ROM_BANK_END){
+        cart_ctx->mbc1_lower_bank = value & MBC1_ROM_BANK_MASK;
+    } else if (MBC1_UPPER_BANK_BASE <= addr && addr <= MBC1_UPPER_BANK_END){
+        cart_ctx->mbc1_upper_bank = value & MBC1_UPPER_BANK_MASK;
+    } else if (MBC1_MODE_BASE <= addr && addr <= MBC1_MODE_END){
+        cart_ctx->mbc1_mode = value & MBC1_MODE_MASK;
+    } else return STATUS_OK;
 
+    mbc1_update_banks(gb);
+    return STATUS_OK;
+}
+
+void cart_init(gb_instance_t *gb, uint8_t *raw_buffer, size_t rom_size)
+{
+    assert(raw_buffer != NULL);
+    assert(rom_size > ROM_BANKS_END);
+
+    read_rom_meta(&gb->cart.cart_data, raw_buffer, rom_size);
+    gb->cart.cart_data.rom_data = raw_buffer;
+    gb->cart.cart_data.rom_size = rom_size;
+    gb->cart.rom0_bank = 0;
+    gb->cart.rom_bank = 1;
+    gb->cart.mbc1_lower_bank = 0;
+    gb->cart.mbc1_upper_bank = 0;
+    gb->cart.mbc1_mode = 0;
+    gb->cart.rom_bank_count = (uint16_t) (rom_size / ROM_BANK_SIZE);
+
+    /* ROM is read directly by the bus, writes go to the MBC */
+    gb->cart.rom0_ms_conn = (master_slave_conn_t) {
+        .start_addr = (addr_t) ROM_BANK_00_BASE,
+        .end_addr = (addr_t) ROM_BANK_00_END,
+        .slave_context = (void *) gb,
+        .slave_write = rom_write,
+        .direct_read = raw_buffer
+    };
+
+    gb->cart.romx_ms_conn = (master_slave_conn_t) {
+        .start_addr = (addr_t) ROM_BANKS_BASE,
+        .end_addr = (addr_t) ROM_BANKS_END,
+        .slave_context = (void *) gb,
+        .slave_write = rom_write,
+        .direct_read = &raw_buffer[ROM_BANK_SIZE]
+    };
+}
 
+master_slave_conn_t *cart_get_rom0_ms_connection(gb_instance_t *gb)
+{
+    master_slave_conn_t *res = &(gb->cart.rom0_ms_conn);
+    assert(res->direct_read != NULL);
+    assert(res->slave_write != NULL);
+
+    return res;
+}
+
+master_slave_conn_t *cart_get_romx_ms_connection(gb_instance_t *gb)
+{
+    master_slave_conn_t *res = &(gb->cart.romx_ms_conn);
+    assert(res->direct_read != NULL);
+    assert(res->slave_write != NULL);
+
+    return res;
+}
+
+const cart_meta_t *cart_get_metadata(gb_instance_t *gb)
+{
+    return &gb->cart.cart_data.metadata;
+}
+
+uint16_t cart_get_rom_bank(gb_instance_t *gb)
+{
+    return gb->cart.rom_bank;
+}
+
+uint16_t cart_get_bank_at(gb_instance_t *gb, addr_t addr)
+{
+    if (addr <= ROM_BANK_00_END) return gb->cart.rom0_bank;
+    if (addr <= ROM_BANKS_END) return gb->cart.rom_bank;
+    return 0;
+}
+
+void cart_save_state(gb_instance_t *gb, cart_state_t *state)
+{
+    *state = (cart_state_t) {
+        .mbc1_lower_bank = gb->cart.mbc1_lower_bank,
+        .mbc1_upper_bank = gb->cart.mbc1_upper_bank,
+        .mbc1_mode = gb->cart.mbc1_mode,
+    };
+}
+
+void cart_load_state(gb_instance_t *gb, const cart_state_t *state)
+{
+    gb->cart.mbc1_lower_bank = state->mbc1_lower_bank & MBC1_ROM_BANK_MASK;
+    gb->cart.mbc1_upper_bank = state->mbc1_upper_bank & MBC1_UPPER_BANK_MASK;
+    gb->cart.mbc1_mode = state->mbc1_mode & MBC1_MODE_MASK;
+    mbc1_update_banks(gb);
+}
+
+void cart_set_bank_switch_hook(gb_instance_t *gb, cart_bank_switch_hook_t hook)
+{
+    gb->cart.bank_switch_hook = hook;
+}
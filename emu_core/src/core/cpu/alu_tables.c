@@ -0,0 +1,104 @@
+#include <core/alu_tables.h>
+
+#if CPU_ALU_TABLES
+
+/*
+    One expansion macro per hex digit, since a macro can't expand itself.
+    Each one calls X(args..., digit) for the 16 hex digits, the digits are
+    pasted into literals (0x##hi##lo) by the entry macros.
+*/
+#define ALU_HEX_0(X, ...)   X(__VA_ARGS__, 0) X(__VA_ARGS__, 1) X(__VA_ARGS__, 2) X(__VA_ARGS__, 3) \
+                            X(__VA_ARGS__, 4) X(__VA_ARGS__, 5) X(__VA_ARGS__, 6) X(__VA_ARGS__, 7) \
+                            X(__VA_ARGS__, 8) X(__VA_ARGS__, 9) X(__VA_ARGS__, A) X(__VA_ARGS__, B) \
+                            X(__VA_ARGS__, C) X(__VA_ARGS__, D) X(__VA_ARGS__, E) X(__VA_ARGS__, F)
+#define ALU_HEX_1(X, ...)   X(__VA_ARGS__, 0) X(__VA_ARGS__, 1) X(__VA_ARGS__, 2) X(__VA_ARGS__, 3) \
+                            X(__VA_ARGS__, 4) X(__VA_ARGS__, 5) X(__VA_ARGS__, 6) X(__VA_ARGS__, 7) \
+                            X(__VA_ARGS__, 8) X(__VA_ARGS__, 9) X(__VA_ARGS__, A) X(__VA_ARGS__, B) \
+                            X(__VA_ARGS__, C) X(__VA_ARGS__, D) X(__VA_ARGS__, E) X(__VA_ARGS__, F)
+#define ALU_HEX_2(X, ...)   X(__VA_ARGS__, 0) X(__VA_ARGS__, 1) X(__VA_ARGS__, 2) X(__VA_ARGS__, 3) \
+                            X(__VA_ARGS__, 4) X(__VA_ARGS__, 5) X(__VA_ARGS__, 6) X(__VA_ARGS__, 7) \
+                            X(__VA_ARGS__, 8) X(__VA_ARGS__, 9) X(__VA_ARGS__, A) X(__VA_ARGS__, B) \
+                            X(__VA_ARGS__, C) X(__VA_ARGS__, D) X(__VA_ARGS__, E) X(__VA_ARGS__, F)
+#define ALU_HEX_3(X, ...)   X(__VA_ARGS__, 0) X(__VA_ARGS__, 1) X(__VA_ARGS__, 2) X(__VA_ARGS__, 3) \
+                            X(__VA_ARGS__, 4) X(__VA_ARGS__, 5) X(__VA_ARGS__, 6) X(__VA_ARGS__, 7) \
+                            X(__VA_ARGS__, 8) X(__VA_ARGS__, 9) X(__VA_ARGS__, A) X(__VA_ARGS__, B) \
+                            X(__VA_ARGS__, C) X(__VA_ARGS__, D) X(__VA_ARGS__, E) X(__VA_ARGS__, F)
+
+/* 256 entries M(..., hi, lo), for every byte 0xhilo */
+#define ALU_BYTE_LO(M, ...) ALU_HEX_1(M, __VA_ARGS__)
+#define ALU_BYTES(M, ...)   ALU_HEX_0(ALU_BYTE_LO, M, __VA_ARGS__)
+
+/*
+    DAA, from the flags of the previous ADD/SUB. N, H, C are bits 2, 1, 0
+    of `nhc`. After a subtraction only the flags pick the adjustment.
+*/
+#define ALU_DAA_SUB(nhc)            (((nhc) >> 2) & 1)
+#define ALU_DAA_ADJ(nhc, a) \
+    (ALU_DAA_SUB(nhc) \
+        ? ((((nhc) & 2) ? 0x06 : 0) + (((nhc) & 1) ? 0x60 : 0)) \
+        : ((((nhc) & 2) || ((a) & 0xF) > 0x9) ? 0x06 : 0) + ((((nhc) & 1) || (a) > 0x99) ? 0x60 : 0))
+#define ALU_DAA_RESULT(nhc, a) \
+    (((a) + (ALU_DAA_SUB(nhc) ? -ALU_DAA_ADJ(nhc, a) : ALU_DAA_ADJ(nhc, a))) & 0xFF)
+#define ALU_DAA_FLAGS(nhc, a) \
+    (((ALU_DAA_RESULT(nhc, a) == 0) ? ALU_FLAG_Z : 0) | (ALU_DAA_SUB(nhc) ? ALU_FLAG_N : 0) \
+        | ((ALU_DAA_ADJ(nhc, a) >= 0x60) ? ALU_FLAG_C : 0))
+#define ALU_DAA_ENTRY(nhc, hi, lo) \
+    (uint16_t) (ALU_DAA_RESULT(nhc, 0x##hi##lo) | (ALU_DAA_FLAGS(nhc, 0x##hi##lo) << 8)),
+
+const uint16_t alu_daa_table[8][256] = {
+    { ALU_BYTES(ALU_DAA_ENTRY, 0) },
+    { ALU_BYTES(ALU_DAA_ENTRY, 1) },
+    { ALU_BYTES(ALU_DAA_ENTRY, 2) },
+    { ALU_BYTES(ALU_DAA_ENTRY, 3) },
+    { ALU_BYTES(ALU_DAA_ENTRY, 4) },
+    { ALU_BYTES(ALU_DAA_ENTRY, 5) },
+    { ALU_BYTES(ALU_DAA_ENTRY, 6) },
+    { ALU_BYTES(ALU_DAA_ENTRY, 7) },
+};
+
+#if CPU_ALU_TABLES == CPU_ALU_TABLES_FULL
+
+/*
+    `sum` is the full result, `half` the result of the low nibbles (both
+    signed for subtractions, negative on borrow). Kept short, the full
+    tables expand to 128K entries.
+*/
+#define ALU_ADD_FLAGS(sum, half) \
+    (uint8_t) (((((sum) & 0xFF) == 0) << 7) | (((half) > 0xF) << 5) | (((sum) > 0xFF) << 4))
+#define ALU_SUB_FLAGS(sum, half) \
+    (uint8_t) (ALU_FLAG_N | ((((sum) & 0xFF) == 0) << 7) | (((half) < 0) << 5) | (((sum) < 0) << 4))
+
+#define ALU_ADD_ENTRY(c, ah, al, bh, bl) \
+    ALU_ADD_FLAGS(0x##ah##al + 0x##bh##bl + c, 0x##al + 0x##bl + c),
+#define ALU_SUB_ENTRY(c, ah, al, bh, bl) \
+    ALU_SUB_FLAGS(0x##ah##al - 0x##bh##bl - c, 0x##al - 0x##bl - c),
+
+/* 64K entries M(c, ah, al, bh, bl), for every (a, b) */
+#define ALU_PAIRS_BL(M, c, ah, al, bh)  ALU_HEX_3(M, c, ah, al, bh)
+#define ALU_PAIRS_BH(M, c, ah, al)      ALU_HEX_2(ALU_PAIRS_BL, M, c, ah, al)
+#define ALU_PAIRS_AL(M, c, ah)          ALU_HEX_1(ALU_PAIRS_BH, M, c, ah)
+#define ALU_PAIRS(M, c)                 ALU_HEX_0(ALU_PAIRS_AL, M, c)
+
+const uint8_t alu_add_flag_table[2][256 * 256] = {
+    { ALU_PAIRS(ALU_ADD_ENTRY, 0) },
+    { ALU_PAIRS(ALU_ADD_ENTRY, 1) },
+};
+
+const uint8_t alu_sub_flag_table[2][256 * 256] = {
+    { ALU_PAIRS(ALU_SUB_ENTRY, 0) },
+    { ALU_PAIRS(ALU_SUB_ENTRY, 1) },
+};
+
+#else
+
+#define ALU_ZC_ENTRY(carry, hi, lo) \
+    (uint8_t) (((0x##hi##lo == 0) ? ALU_FLAG_Z : 0) | ((carry) ? ALU_FLAG_C : 0)),
+
+const uint8_t alu_zc_flag_table[512] = {
+    ALU_BYTES(ALU_ZC_ENTRY, 0)
+    ALU_BYTES(ALU_ZC_ENTRY, 1)
+};
+
+#endif // CPU_ALU_TABLES == CPU_ALU_TABLES_FULL
+
+#endif // CPU_ALU_TABLES
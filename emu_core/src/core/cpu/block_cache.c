@@ -0,0 +1,362 @@
+#include <core/block_cache.h>
+
+#if CPU_BLOCK_CACHE_ENABLED
+
+#include <gb_instance.h>
+#include <core/bus.h>
+#include <core/cartridge/cart.h>
+#include <string.h>
+
+#define BLOCK_CACHE_MASK        (BLOCK_CACHE_ENTRIES - 1)
+
+/**
+ *  Checks if the instruction has to be the last one of a block,
+ *  i.e. it may change control flow or interrupt state.
+ */
+static bool ends_block(uint8_t opcode)
+{
+    /* Checked against the generic table, specialized handlers all differ */
+    INSTR_FUNC func = optable[opcode];
+
+    return func == instr_jr_imm8
+        || func == instr_jr_cond_imm8
+        || func == instr_jp_imm16
+        || func == instr_jp_cond
+        || func == instr_jp_hl
+        || func == instr_call_imm16
+        || func == instr_call_cond_imm16
+        || func == instr_ret
+        || func == instr_ret_cond
+        || func == instr_reti
+        || func == instr_rst_tgt3
+        || func == instr_halt
+        || func == instr_stop
+        || func == instr_di
+        || func == instr_ei
+        || func == instr_unimplemented;
+}
+
+/* Register bits for idle loop detection */
+#define IDLE_REG_B      (1u << 0)
+#define IDLE_REG_C      (1u << 1)
+#define IDLE_REG_D      (1u << 2)
+#define IDLE_REG_E      (1u << 3)
+#define IDLE_REG_H      (1u << 4)
+#define IDLE_REG_L      (1u << 5)
+#define IDLE_REG_A      (1u << 6)
+#define IDLE_REG_F      (1u << 7)
+
+/* Registers read by r8 operands, (HL) reads through H and L */
+static const uint8_t idle_r8_bits[8] = {
+    IDLE_REG_B, IDLE_REG_C, IDLE_REG_D, IDLE_REG_E,
+    IDLE_REG_H, IDLE_REG_L, IDLE_REG_H | IDLE_REG_L, IDLE_REG_A
+};
+
+/**
+ *  Registers read and written by an instruction allowed in an idle loop.
+ *  Returns false for anything else, in particular anything writing memory.
+ */
+static bool idle_instr_effects(const decoded_instr_t *instr, uint8_t *reads, uint8_t *writes)
+{
+    uint8_t opcode = instr->opcode;
+    uint8_t src = opcode & 0x7;
+    uint8_t dst = (opcode >> 3) & 0x7;
+
+    *reads = 0;
+    *writes = 0;
+
+    switch (opcode){
+        case 0x00:                                          /* NOP */
+            return true;
+        case 0x0A:                                          /* LD A, (BC) */
+            *reads = IDLE_REG_B | IDLE_REG_C; *writes = IDLE_REG_A;
+            return true;
+        case 0x1A:                                          /* LD A, (DE) */
+            *reads = IDLE_REG_D | IDLE_REG_E; *writes = IDLE_REG_A;
+            return true;
+        case 0xF0: case 0xFA:                               /* LDH A, (a8) / LD A, (a16) */
+            *writes = IDLE_REG_A;
+            return true;
+        case 0xF2:                                          /* LDH A, (C) */
+            *reads = IDLE_REG_C; *writes = IDLE_REG_A;
+            return true;
+        case 0xE6: case 0xEE: case 0xF6: case 0xFE:         /* AND/XOR/OR/CP imm8 */
+            *reads = IDLE_REG_A;
+            *writes = IDLE_REG_F | ((opcode == 0xFE) ? 0 : IDLE_REG_A);
+            return true;
+        case 0x18: case 0xC3:                               /* JR / JP */
+            return true;
+        case 0x20: case 0x28: case 0x30: case 0x38:         /* JR cc */
+        case 0xC2: case 0xCA: case 0xD2: case 0xDA:         /* JP cc */
+            *reads = IDLE_REG_F;
+            return true;
+        case 0xCB:
+            /* BIT only, it keeps C but that doesn't change between iterations */
+            if ((instr->operands[0] & 0xC0) != 0x40) return false;
+            *reads = idle_r8_bits[instr->operands[0] & 0x7];
+            *writes = IDLE_REG_F;
+            return true;
+        default:
+            break;
+    }
+
+    if (0x40 <= opcode && opcode <= 0x7F && opcode != 0x76){
+        /* LD r8, r8, but not into (HL) */
+        if (dst == 0x6) return false;
+        *reads = idle_r8_bits[src];
+        *writes = idle_r8_bits[dst];
+        return true;
+    }
+
+    if (0xA0 <= opcode && opcode <= 0xBF){
+        /* AND/XOR/OR/CP r8, no carry in. CP (7) leaves A alone */
+        *reads = IDLE_REG_A | idle_r8_bits[src];
+        *writes = IDLE_REG_F | ((dst == 7) ? 0 : IDLE_REG_A);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ *  Checks whether the block is an idle loop: it jumps back to its own start,
+ *  writes no memory, and every register it reads is either written earlier
+ *  in the same iteration or never written. Each iteration then leaves the
+ *  CPU in the same state as long as the memory it reads doesn't change.
+ */
+static bool is_idle_loop(const decoded_block_t *block)
+{
+    uint8_t live_in = 0;
+    uint8_t written = 0;
+    addr_t pc = block->start_pc;
+    const decoded_instr_t *last = &block->instrs[block->instr_count - 1];
+
+    for (unsigned i = 0; i < block->instr_count; ++i){
+        uint8_t reads, writes;
+        if (!idle_instr_effects(&block->instrs[i], &reads, &writes)) return false;
+
+        live_in |= reads & ~written;
+        written |= writes;
+        pc += block->instrs[i].length;
+    }
+
+    /* Must end in a jump back to the start */
+    addr_t target;
+    switch (last->opcode){
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+            target = (addr_t) (pc + (int8_t) last->operands[0]);
+            break;
+        case 0xC3: case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+            target = (addr_t) (last->operands[0] | (last->operands[1] << 8));
+            break;
+        default:
+            return false;
+    }
+
+    return target == block->start_pc && (live_in & written) == 0;
+}
+
+/**
+ *  ROM bank the address belongs to, 0 for everything outside ROM.
+ */
+static uint16_t bank_of(gb_instance_t *gb, addr_t pc)
+{
+    return cart_get_bank_at(gb, pc);
+}
+
+static decoded_block_t *slot_of(block_cache_t *cache, uint16_t rom_bank, addr_t pc)
+{
+    return &cache->blocks[(pc ^ (rom_bank * 0x9E37u)) & BLOCK_CACHE_MASK];
+}
+
+/**
+ *  Decodes the block starting at `pc` into `block`.
+ *  Returns false if not a single instruction could be decoded.
+ */
+static bool decode_block(decoded_block_t *block, const uint8_t *page_mem, uint16_t rom_bank, addr_t pc)
+{
+    unsigned offset = BUS_PAGE_OFFSET(pc);
+
+    block->valid = false;
+    block->rom_bank = rom_bank;
+    block->start_pc = pc;
+    block->instr_count = 0;
+    block->cycles = 0;
+    block->idle_loop = false;
+
+    while (block->instr_count < BLOCK_MAX_INSTRS){
+        uint8_t opcode = page_mem[offset];
+        uint8_t length = opcode_lengths[opcode];
+        decoded_instr_t *instr = &block->instrs[block->instr_count];
+
+        /* Don't let blocks straddle pages */
+        if (offset + length > BUS_PAGE_SIZE) break;
+
+        instr->func = CPU_OPTABLE[opcode];
+        instr->opcode = opcode;
+        instr->length = length;
+        instr->operands[0] = (length > 1) ? page_mem[offset + 1] : 0;
+        instr->operands[1] = (length > 2) ? page_mem[offset + 2] : 0;
+
+        block->cycles += (optable[opcode] == instr_cb_prefix) ?
+                            prefix_opcode_cycles[instr->operands[0]] : opcode_cycles[opcode];
+        block->instr_count++;
+        offset += length;
+
+        if (ends_block(opcode) || offset == BUS_PAGE_SIZE) break;
+    }
+
+    block->valid = (block->instr_count > 0);
+    block->idle_loop = block->valid && is_idle_loop(block);
+    return block->valid;
+}
+
+/**
+ *  Other page mapping the same memory: echo RAM and the start of WRAM
+ *  alias each other. Returns `page` itself if there's none.
+ */
+static uint8_t alias_page(uint8_t page)
+{
+    if (page >= BUS_PAGE_OF(ECHO_RAM_BASE) && page <= BUS_PAGE_OF(ECHO_RAM_END)){
+        return (uint8_t) (page - BUS_PAGE_OF(ECHO_RAM_BASE - WRAM1_BASE));
+    }
+    if (page >= BUS_PAGE_OF(WRAM1_BASE) && page <= BUS_PAGE_OF(ECHO_RAM_END - (ECHO_RAM_BASE - WRAM1_BASE))){
+        return (uint8_t) (page + BUS_PAGE_OF(ECHO_RAM_BASE - WRAM1_BASE));
+    }
+    return page;
+}
+
+static void watch_page(gb_instance_t *gb, uint8_t page)
+{
+    if (gb->block_cache.watched_pages[page]) return;
+
+    gb->block_cache.watched_pages[page] = true;
+    bus_watch_page(gb, page);
+}
+
+static void unwatch_page(gb_instance_t *gb, uint8_t page)
+{
+    if (!gb->block_cache.watched_pages[page]) return;
+
+    gb->block_cache.watched_pages[page] = false;
+    bus_unwatch_page(gb, page);
+}
+
+/**
+ *  Bus watcher, called before a write to a page holding decoded code.
+ */
+static void on_code_write(gb_instance_t *gb, addr_t addr)
+{
+    block_cache_invalidate_page(gb, BUS_PAGE_OF(addr));
+}
+
+void block_cache_init(gb_instance_t *gb)
+{
+    block_cache_t *cache = &gb->block_cache;
+
+    for (unsigned page = 0; page < BUS_PAGE_COUNT; ++page){
+        if (cache->watched_pages[page]){
+            bus_unwatch_page(gb, (uint8_t) page);
+        }
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    bus_set_write_watcher(gb, on_code_write);
+}
+
+decoded_block_t *block_cache_lookup(gb_instance_t *gb, addr_t pc)
+{
+    block_cache_t *cache = &gb->block_cache;
+    uint16_t rom_bank = bank_of(gb, pc);
+    decoded_block_t *block = slot_of(cache, rom_bank, pc);
+
+    if (block->valid && block->start_pc == pc && block->rom_bank == rom_bank){
+        return block;
+    }
+
+    /* Only plain memory can be decoded ahead of time */
+    const uint8_t *page_mem = bus_get_page_mem(gb, pc);
+    if (page_mem == NULL) return NULL;
+
+    if (!decode_block(block, page_mem, rom_bank, pc)) return NULL;
+
+    /* Code outside ROM can be overwritten, through its alias as well */
+    if (pc > ROM_BANKS_END){
+        uint8_t page = BUS_PAGE_OF(pc);
+        watch_page(gb, page);
+        watch_page(gb, alias_page(page));
+    }
+
+    return block;
+}
+
+void block_cache_run(gb_instance_t *gb, decoded_block_t *block)
+{
+    cpu_context_t *context = &gb->cpu;
+    uint32_t epoch = gb->block_cache.epoch;
+    addr_t pc = block->start_pc;
+
+    for (unsigned i = 0; i < block->instr_count; ++i){
+        decoded_instr_t *instr = &block->instrs[i];
+
+        /* Handlers expect PC past the opcode, and read immediates through `imm_ptr` */
+        context->pc = (addr_t) (pc + 1);
+        context->imm_ptr = instr->operands;
+        instr->func(context, instr->opcode);
+        pc += instr->length;
+
+        /* Block was invalidated by the instruction, re-fetch from the bus */
+        if (gb->block_cache.epoch != epoch) break;
+
+        /* An event got scheduled earlier, or an interrupt became serviceable */
+        if (context->cycles >= context->deadline) break;
+    }
+
+    context->imm_ptr = NULL;
+}
+
+void block_cache_invalidate_page(gb_instance_t *gb, uint8_t page)
+{
+    block_cache_t *cache = &gb->block_cache;
+    uint8_t alias = alias_page(page);
+
+    for (unsigned i = 0; i < BLOCK_CACHE_ENTRIES; ++i){
+        decoded_block_t *block = &cache->blocks[i];
+        uint8_t block_page = BUS_PAGE_OF(block->start_pc);
+        if (block->valid && (block_page == page || block_page == alias)){
+            block->valid = false;
+        }
+    }
+
+    unwatch_page(gb, page);
+    unwatch_page(gb, alias);
+
+    cache->epoch++;
+}
+
+void block_cache_flush(gb_instance_t *gb)
+{
+    block_cache_t *cache = &gb->block_cache;
+
+    for (unsigned i = 0; i < BLOCK_CACHE_ENTRIES; ++i){
+        cache->blocks[i].valid = false;
+    }
+
+    for (unsigned page = 0; page < BUS_PAGE_COUNT; ++page){
+        unwatch_page(gb, (uint8_t) page);
+    }
+
+    cache->epoch++;
+}
+
+void block_cache_on_bank_switch(gb_instance_t *gb, uint16_t rom_bank)
+{
+    /*
+        Blocks are keyed by bank and never straddle the bank boundary, so
+        they stay valid. Only a block running from the old bank has to stop.
+    */
+    (void) rom_bank;
+    gb->block_cache.epoch++;
+}
+
+#endif // CPU_BLOCK_CACHE_ENABLED
@@ -1,61 +1,398 @@
 
 #include <core/cpu.h>
+#include <gb_instance.h>
 #include <core/bus.h>
 #include <core/interrupt.h>
+#include <core/cpu_instrs.h>
+#include <core/block_cache.h>
+#include <core/profiler.h>
+#include <core/tracer.h>
+#include <schedule.h>
 
-/* Note that this is dynamically generated */
-#include <optable.h>
-
-/* 
-    Singleton object for CPU.
-*/
-static cpu_context_t cpu_context;
+#if CPU_PAIR_PROFILE
+#include <stdio.h>
+#include <string.h>
+#endif
 
 /**
  *  Fetch instruction in memory.
  */
-inline static uint8_t cpu_fetch()
+inline static uint8_t cpu_fetch(gb_instance_t *gb)
 {
     // Access memory, increment pc by 1
-    return bus_read(++cpu_context.pc);
+    return cpu_fetch_pc(&gb->cpu);
+}
+
+uint8_t cpu_fetch_refill(cpu_context_t *context, addr_t pc)
+{
+    addr_t start, end;
+    const uint8_t *mem = bus_get_read_window(CPU_INSTANCE(context), pc, &start, &end);
+
+    /* Not plain memory (I/O, shared page), every fetch goes through the bus */
+    if (mem == NULL){
+        context->fetch.size = 0;
+        return bus_read(CPU_INSTANCE(context), pc);
+    }
+
+    context->fetch = (cpu_fetch_window_t) {
+        .mem = mem,
+        .start = start,
+        .size = (uint32_t) (end - start) + 1
+    };
+    return mem[pc - start];
 }
 
-void cpu_init()
+void cpu_init(gb_instance_t *gb)
 {
     /* Initialize PC */
-    cpu_context.pc = 0x0;
-    cpu_context.cycles = 0x0;
+    gb->cpu.pc = 0x0;
+    gb->cpu.cycles = 0x0;
+    gb->cpu.deadline = 0;
+    gb->cpu.instr_mcycles = 0;
+    gb->cpu.imm_ptr = NULL;
+    gb->cpu.fetch.size = 0;
+    gb->cpu.sleep_state = CPU_SLEEP_NONE;
+    gb->cpu.halt_bug = 0;
+    gb->cpu.lazy_flags.op = CPU_FLAG_OP_NONE;
+
+    gb->idle_loop = (cpu_idle_loop_t) { .enabled = CPU_IDLE_LOOP_SKIP };
+    gb->cpu.ime = 0;
+    gb->cpu.ei_delay = 0;
+    interrupt_set_ime(gb, 0);
+
+#if CPU_BLOCK_CACHE_ENABLED
+    block_cache_init(gb);
+#endif
+
+#if CPU_PROFILER
+    profiler_init(gb);
+#endif
+
+#if CPU_PAIR_PROFILE
+    memset(gb->pair_profile.counts, 0, sizeof(gb->pair_profile.counts));
+    gb->pair_profile.prev_opcode = -1;
+#endif
+}
+
+/**
+ *  Checks if a pending interrupt ends the current HALT/STOP.
+ */
+static bool cpu_wake_pending(gb_instance_t *gb)
+{
+    uint8_t pending = interrupt_get_pending(gb);
+
+    if (gb->cpu.sleep_state == CPU_SLEEP_STOP){
+        return (pending & INTERRUPT_REG_JOYPAD_BITMASK) != 0;
+    }
+    return pending != 0;
+}
+
+#if CPU_CYCLE_ACCURATE
+void cpu_mcycle(cpu_context_t *context)
+{
+    context->cycles++;
+    context->instr_mcycles++;
+
+    while (schedule_next_timestamp(CPU_INSTANCE(context)) <= context->cycles){
+        execute_next_event(CPU_INSTANCE(context));
+    }
+}
+
+void cpu_finish_instr(cpu_context_t *context, m_cycle_t cycles)
+{
+    while (context->instr_mcycles < cycles){
+        cpu_mcycle(context);
+    }
+    context->instr_mcycles = 0;
 }
+#endif
 
-void cpu_tick()
+m_cycle_t cpu_get_cycles(gb_instance_t *gb)
+{
+    return gb->cpu.cycles;
+}
+
+cpu_context_t *cpu_get_context(gb_instance_t *gb)
+{
+    return &gb->cpu;
+}
+
+void cpu_save_state(gb_instance_t *gb, cpu_state_t *state)
+{
+    cpu_flags_sync(&gb->cpu);
+
+    *state = (cpu_state_t) {
+        .cycles = gb->cpu.cycles,
+        .af = gb->cpu.af.full,
+        .bc = gb->cpu.bc.full,
+        .de = gb->cpu.de.full,
+        .hl = gb->cpu.hl.full,
+        .sp = gb->cpu.sp,
+        .pc = gb->cpu.pc,
+        .ime = gb->cpu.ime,
+        .ei_delay = gb->cpu.ei_delay,
+        .sleep_state = gb->cpu.sleep_state,
+        .halt_bug = gb->cpu.halt_bug,
+    };
+}
+
+void cpu_load_state(gb_instance_t *gb, const cpu_state_t *state)
+{
+    gb->cpu.cycles = state->cycles;
+    gb->cpu.af.full = state->af & 0xFFF0;
+    gb->cpu.bc.full = state->bc;
+    gb->cpu.de.full = state->de;
+    gb->cpu.hl.full = state->hl;
+    gb->cpu.sp = state->sp;
+    gb->cpu.pc = state->pc;
+    gb->cpu.ime = state->ime;
+    gb->cpu.ei_delay = state->ei_delay;
+    gb->cpu.sleep_state = state->sleep_state;
+    gb->cpu.halt_bug = state->halt_bug;
+
+    gb->cpu.lazy_flags.op = CPU_FLAG_OP_NONE;
+    gb->cpu.instr_mcycles = 0;
+    gb->cpu.imm_ptr = NULL;
+    gb->cpu.fetch.size = 0;
+    gb->idle_loop.loop_cycles = 0;
+    interrupt_set_ime(gb, state->ime);
+
+#if CPU_BLOCK_CACHE_ENABLED
+    block_cache_flush(gb);
+#endif
+}
+
+void cpu_set_idle_loop_skip(gb_instance_t *gb, bool enabled)
+{
+    gb->idle_loop.enabled = enabled;
+    gb->idle_loop.loop_cycles = 0;
+}
+
+m_cycle_t cpu_get_idle_skipped_cycles(gb_instance_t *gb)
+{
+    return gb->idle_loop.skipped_cycles;
+}
+
+void cpu_on_bank_switch(gb_instance_t *gb, uint16_t rom_bank)
+{
+    /* The window may point into the old bank */
+    gb->cpu.fetch.size = 0;
+
+#if CPU_BLOCK_CACHE_ENABLED
+    block_cache_on_bank_switch(gb, rom_bank);
+#else
+    (void) rom_bank;
+#endif
+}
+
+/**
+ *  Services the top priority interrupt. Only called when the
+ *  serviceable word is set, so there always is one.
+ */
+static void cpu_service_interrupt(gb_instance_t *gb)
 {
-    /* TODO: Make CPU cycle accurate (have state machines) */
+    /*
+        5 M-cycles: two internal ones, the two pushes of PC and the jump.
+        The accurate core ticks each as it happens, so events land between
+        them; the default one adds all five at the end.
+    */
     interrupt_type_t i_type;
-    i_type = interrupt_get_top(cpu_context.ime);
+    i_type = interrupt_get_top(gb);
+
+    interrupt_clear_flag(gb, i_type);
+    gb->cpu.ime = 0;
+    interrupt_set_ime(gb, 0);
+    gb->cpu.sleep_state = CPU_SLEEP_NONE;
+    addr_t i_vector = interrupt_get_vector_addr(i_type);
+
+    /* Two NOPS */
+    CPU_INTERNAL(&gb->cpu);
+    CPU_INTERNAL(&gb->cpu);
+
+    /* LD [SP] PC (Two M-Cycles) */
+    CPU_WRITE(&gb->cpu, --gb->cpu.sp, (uint8_t) (gb->cpu.pc >> 0x8));
+    CPU_WRITE(&gb->cpu, --gb->cpu.sp, (uint8_t) gb->cpu.pc);
+
+    gb->cpu.pc = i_vector;
+    CPU_ADD_CYCLES(&gb->cpu, 5);
+
+#if CPU_PAIR_PROFILE
+    gb->pair_profile.prev_opcode = -1;
+#endif
+    PROFILER_CALL(gb, i_vector);
+}
 
-    /* Before executing any instructions, need to check for interrupts */
-    if (i_type != INTERRUPT_TYPE_NONE){
-        interrupt_clear_flag(i_type);
-        cpu_context.ime = 0;
-        addr_t i_vector = interrupt_get_vector_addr(i_type);
+/**
+ *  Skips whole iterations of the idle loop the CPU is spinning in,
+ *  up to `deadline`. Keeps the loop in phase, as if it had been run.
+ */
+static void cpu_skip_idle_loop(gb_instance_t *gb, m_cycle_t deadline)
+{
+    m_cycle_t loop_cycles = gb->idle_loop.loop_cycles;
+    gb->idle_loop.loop_cycles = 0;
 
-        /* Two NOPS */
+    if (gb->cpu.cycles >= deadline) return;
 
-        /* LD [SP] PC (Two M-Cycles) */
-        bus_write(--cpu_context.sp, (uint8_t) (cpu_context.pc >> 0x8));
-        bus_write(--cpu_context.sp, (uint8_t) cpu_context.pc);
+    m_cycle_t skipped = (deadline - gb->cpu.cycles) / loop_cycles * loop_cycles;
+    gb->cpu.cycles += skipped;
+    gb->idle_loop.skipped_cycles += skipped;
+}
 
-        cpu_context.pc = i_vector;
-        cpu_context.cycles += 5;
-    
+/**
+ *  Executes a run of instructions without going past `deadline`
+ *  by more than a single instruction.
+ */
+static void cpu_execute(gb_instance_t *gb, m_cycle_t deadline)
+{
+    gb->cpu.deadline = deadline;
+
+#if CPU_PAIR_PROFILE || CPU_PROFILER || CPU_TRACER
+    /* One instruction at a time, to see every one of them */
+#if CPU_TRACER
+    tracer_on_instr(gb);
+#endif
+
+    addr_t pc = gb->cpu.pc;
+    m_cycle_t start_cycles = gb->cpu.cycles;
+    uint8_t opcode = cpu_fetch(gb);
+
+#if CPU_PAIR_PROFILE
+    if (gb->pair_profile.prev_opcode >= 0){
+        gb->pair_profile.counts[(gb->pair_profile.prev_opcode << 8) | opcode]++;
+    }
+    gb->pair_profile.prev_opcode = opcode;
+#endif
+
+#if CPU_PROFILER
+    /* Peeked before running, the instruction may move PC */
+    uint8_t cb_opcode = (opcode == 0xCB) ? cpu_peek_pc(&gb->cpu) : 0;
+    profiler_on_instr_start(gb);
+#endif
+
+    CPU_OPTABLE[opcode](&gb->cpu, opcode);
+
+#if CPU_PROFILER
+    profiler_on_instr(gb, pc, opcode, cb_opcode, gb->cpu.cycles - start_cycles);
+#else
+    (void) pc;
+    (void) start_cycles;
+#endif
+#else
+
+#if CPU_BLOCK_CACHE_ENABLED
+    /* Run a whole pre-decoded block when it fits before the deadline */
+    decoded_block_t *block = block_cache_lookup(gb, gb->cpu.pc);
+    if (block != NULL && gb->cpu.cycles + block->cycles <= deadline){
+        m_cycle_t start_cycles = gb->cpu.cycles;
+        block_cache_run(gb, block);
+
+        /* Branched back into an idle loop, it will spin until the next event */
+        if (gb->idle_loop.enabled && block->idle_loop && gb->cpu.pc == block->start_pc){
+            gb->idle_loop.loop_cycles = gb->cpu.cycles - start_cycles;
+        }
         return;
     }
-    
-    
-    uint8_t opcode = cpu_fetch();
-    INSTR_FUNC op_func = optable[opcode];
+#endif
+
+#if CPU_THREADED_DISPATCH
+    cpu_run_batch(&gb->cpu);
+#else
+    uint8_t opcode = cpu_fetch(gb);
+    INSTR_FUNC op_func = CPU_OPTABLE[opcode];
 
     /* Call the op func */
-    op_func(&cpu_context, opcode);
+    op_func(&gb->cpu, opcode);
+#endif
+#endif // CPU_PAIR_PROFILE || CPU_PROFILER || CPU_TRACER
 }
 
+/**
+ *  Runs the instruction after a HALT that hit the HALT bug: its opcode
+ *  is fetched without moving PC, so the same byte is read again as the
+ *  next opcode or immediate. Always one instruction, on every build.
+ */
+static void cpu_execute_halt_bug(gb_instance_t *gb)
+{
+    gb->cpu.halt_bug = 0;
+
+    uint8_t opcode = cpu_fetch(gb);
+    gb->cpu.pc--;
+
+#if CPU_PAIR_PROFILE
+    gb->pair_profile.prev_opcode = -1;
+#endif
+    CPU_OPTABLE[opcode](&gb->cpu, opcode);
+}
+
+m_cycle_t cpu_run(gb_instance_t *gb, m_cycle_t budget)
+{
+    m_cycle_t start_cycles = gb->cpu.cycles;
+    m_cycle_t deadline = start_cycles + budget;
+
+    while (gb->cpu.cycles < deadline){
+        /* Events can be scheduled while running (e.g. by I/O writes), look every time */
+        uint64_t next_event = schedule_next_timestamp(gb);
+        m_cycle_t slice_end = (next_event < deadline) ? next_event : deadline;
+
+        if (gb->cpu.cycles >= slice_end) break;
+
+        /* EI takes effect after the next instruction */
+        if (gb->cpu.ei_delay){
+            gb->cpu.ei_delay = 0;
+            cpu_execute(gb, gb->cpu.cycles + 1);
+            continue;
+        }
+
+        if (gb->cpu.halt_bug){
+            cpu_execute_halt_bug(gb);
+            continue;
+        }
+
+        if (gb->interrupt.serviceable){
+            cpu_service_interrupt(gb);
+            continue;
+        }
+
+        /* Sleeping, only an interrupt gets the CPU going again */
+        if (gb->cpu.sleep_state != CPU_SLEEP_NONE){
+            if (!cpu_wake_pending(gb)){
+                gb->cpu.cycles = slice_end;
+                continue;
+            }
+            gb->cpu.sleep_state = CPU_SLEEP_NONE;
+        }
+
+        if (gb->idle_loop.loop_cycles != 0){
+            cpu_skip_idle_loop(gb, slice_end);
+            if (gb->cpu.cycles >= slice_end) continue;
+        }
+
+        cpu_execute(gb, slice_end);
+    }
+
+    /* Whatever the CPU was spinning in, it has to be checked again next time */
+    gb->idle_loop.loop_cycles = 0;
+
+    return gb->cpu.cycles - start_cycles;
+}
+
+void cpu_tick(gb_instance_t *gb)
+{
+    cpu_run(gb, 1);
+}
+
+#if CPU_PAIR_PROFILE
+bool cpu_pair_profile_write(gb_instance_t *gb, const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    for (unsigned pair = 0; pair < 256 * 256; ++pair){
+        if (gb->pair_profile.counts[pair] != 0){
+            fprintf(file, "%02x %02x %u\n", pair >> 8, pair & 0xFF, (unsigned) gb->pair_profile.counts[pair]);
+        }
+    }
+
+    return fclose(file) == 0;
+}
+#endif
@@ -1,15 +1,19 @@
 #include <cpu_instrs.h>
 #include <bus.h>
+#include <interrupt.h>
+#include <profiler.h>
+#include <alu_tables.h>
 #include <optable.h>
+#include <platform/error_handling.h>
 
 /* ALU OP FLAGS */
 #define ALU_ADD         0x0
 #define ALU_ADDC        0x1
 #define ALU_SUB         0x2
 #define ALU_SUBC        0x3
-#define ALU_OR          0x4
-#define ALU_AND         0x5
-#define ALU_XOR         0x6
+#define ALU_AND         0x4
+#define ALU_XOR         0x5
+#define ALU_OR          0x6
 #define ALU_CP          0x7
 
 /* Status flags */
@@ -30,7 +34,7 @@
 /* Set individual status */
 
 #define CPU_STATUS_SETBIT(status_reg, status_code, value) \
- ( (value) ? ((status_reg) & ~(status_code)) : ((status_reg) | (status_code)))
+ ( (value) ? ((status_reg) | (status_code)) : ((status_reg) & ~(status_code)))
 
 // Carry (Addition) calculations
 #define CHECK_CARRY8(a, b)         (((uint16_t)(a) + (uint16_t)(b)) > 0xFF)
@@ -91,6 +95,8 @@
 #define R16STK_HL       0x2
 #define R16STK_AF       0x3
 
+static uint8_t read_status(cpu_context_t *context);
+
 /**
  *  Reads from register or memory
  */
@@ -112,7 +118,7 @@ static uint8_t read_reg8(cpu_context_t *context, uint8_t r8_code)
         /* Memory read instruction from HL */
         case R8_HL_MEM:
             addr_t addr = (addr_t) context->hl.full;
-            reg_val = bus_read(addr); 
+            reg_val = CPU_READ(context, addr); 
             break;
 
         default:
@@ -141,7 +147,7 @@ static void write_reg8(cpu_context_t *context, uint8_t r8_code, uint8_t val)
         /* Memory read instruction from HL */
         case R8_HL_MEM:
             addr_t addr = (addr_t) context->hl.full;
-            return bus_write(addr, val); 
+            CPU_WRITE(context, addr, val); 
             break;
 
         default:
@@ -163,7 +169,7 @@ static uint16_t read_reg16(cpu_context_t *context, uint8_t r16_code)
         case R16_BC: return context->bc.full; break;
         case R16_DE: return context->de.full; break;
         case R16_HL: return context->hl.full; break;
-        case R16_AF: return context->af.full; break;
+        case R16_AF: read_status(context); return context->af.full; break;
         case R16_SP: return context->sp     ; break;
         case R16_PC: return context->pc     ; break;
         
@@ -184,7 +190,7 @@ static void write_reg16(cpu_context_t *context, uint8_t r16_code, uint16_t val)
         case R16_BC: context->bc.full = val; break;
         case R16_DE: context->de.full = val; break;
         case R16_HL: context->hl.full = val; break;
-        case R16_AF: context->af.full = val; break;
+        case R16_AF: context->af.full = val; context->lazy_flags.op = CPU_FLAG_OP_NONE; break;
         case R16_SP: context->sp      = val; break;
         case R16_PC: context->pc      = val; break;
         
@@ -202,10 +208,10 @@ static void write_reg16mem(cpu_context_t *context, uint8_t r16mem_code, uint8_t
 {
     switch(r16mem_code)
     {
-        case R16MEM_BC: bus_write(context->bc.full, wrdata); break;
-        case R16MEM_DE: bus_write(context->de.full, wrdata); break;
-        case R16MEM_HLI: bus_write(context->hl.full++, wrdata); break;
-        case R16MEM_HLD: bus_write(context->hl.full--, wrdata); break;
+        case R16MEM_BC: CPU_WRITE(context, context->bc.full, wrdata); break;
+        case R16MEM_DE: CPU_WRITE(context, context->de.full, wrdata); break;
+        case R16MEM_HLI: CPU_WRITE(context, context->hl.full++, wrdata); break;
+        case R16MEM_HLD: CPU_WRITE(context, context->hl.full--, wrdata); break;
 
         default:
             /* UH-OH, invalid value! */
@@ -223,10 +229,10 @@ static uint8_t read_reg16mem(cpu_context_t *context, uint8_t r16mem_code)
 {
     switch(r16mem_code)
     {
-        case R16MEM_BC: return bus_read(context->bc.full); break;
-        case R16MEM_DE: return bus_read(context->de.full); break;
-        case R16MEM_HLI: return bus_read(context->hl.full++); break;
-        case R16MEM_HLD: return bus_read(context->hl.full--); break;
+        case R16MEM_BC: return CPU_READ(context, context->bc.full); break;
+        case R16MEM_DE: return CPU_READ(context, context->de.full); break;
+        case R16MEM_HLI: return CPU_READ(context, context->hl.full++); break;
+        case R16MEM_HLD: return CPU_READ(context, context->hl.full--); break;
 
         default:
             /* UH-OH, invalid value! */
@@ -241,93 +247,190 @@ static uint8_t read_reg16mem(cpu_context_t *context, uint8_t r16mem_code)
 
 
 /**
- *  Add SP to a signed value.
- *  Writes to SP, and modifies status bits.
+ *  Records a flag-producing operation, F is computed later on demand.
  */
-static void signed_add_sp(cpu_context_t *context, int8_t imm8)
+static inline void defer_flags(cpu_context_t *context, uint8_t op, 
+                               uint8_t a, uint8_t b, uint8_t carry, uint16_t result)
 {
-    uint8_t abs_val;
-    uint8_t status = read_status(context);
+    context->lazy_flags = (cpu_lazy_flags_t) {
+        .op = op,
+        .a = a,
+        .b = b,
+        .carry = carry,
+        .result = result
+    };
+}
 
-    if (imm8 >= 0) {
-        abs_val = (uint8_t) imm8;
-        status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, CHECK_CARRY8(context->sp, abs_val));
-        status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_H, CHECK_HALF_CARRY8(context->sp, abs_val));
-        context->sp += abs_val;
-    } else {
-        abs_val = (uint8_t) (-imm8);
-        status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, CHECK_BORROW8(context->sp, abs_val));
-        status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_H, CHECK_HALF_BORROW8(context->sp, abs_val));
-        context->sp -= abs_val;
+/**
+ *  Computes F from the last recorded operation.
+ */
+static uint8_t compute_flags(const cpu_lazy_flags_t *lazy)
+{
+    uint8_t flags = 0x0;
+    uint8_t a = lazy->a;
+    uint8_t b = lazy->b;
+
+#if CPU_ALU_TABLES
+    /* ADD/ADC and SUB/SBC/CP: one lookup for all four flags */
+    if (lazy->op == CPU_FLAG_OP_ADD) return alu_add_flags(a, b, lazy->carry);
+    if (lazy->op == CPU_FLAG_OP_SUB) return alu_sub_flags(a, b, lazy->carry);
+#endif
+
+    if ((lazy->result & 0xff) == 0) flags |= CPU_STATUS_MASK_Z;
+
+    switch (lazy->op)
+    {
+        case CPU_FLAG_OP_ADD:
+            if (((a & 0xF) + (b & 0xF) + lazy->carry) > 0xF)    flags |= CPU_STATUS_MASK_H;
+            if (lazy->result > 0xFF)                            flags |= CPU_STATUS_MASK_C;
+            break;
+
+        case CPU_FLAG_OP_SUB:
+            flags |= CPU_STATUS_MASK_N;
+            if ((a & 0xF) < ((b & 0xF) + lazy->carry))          flags |= CPU_STATUS_MASK_H;
+            if (a < (uint16_t) b + lazy->carry)                 flags |= CPU_STATUS_MASK_C;
+            break;
+
+        case CPU_FLAG_OP_AND:
+            flags |= CPU_STATUS_MASK_H;
+            break;
+
+        case CPU_FLAG_OP_OR:
+            break;
+
+        /* INC/DEC leave C untouched, it is kept in `carry` */
+        case CPU_FLAG_OP_INC:
+            if ((a & 0xF) == 0xF)                               flags |= CPU_STATUS_MASK_H;
+            if (lazy->carry)                                    flags |= CPU_STATUS_MASK_C;
+            break;
+
+        case CPU_FLAG_OP_DEC:
+            flags |= CPU_STATUS_MASK_N;
+            if ((a & 0xF) == 0x0)                               flags |= CPU_STATUS_MASK_H;
+            if (lazy->carry)                                    flags |= CPU_STATUS_MASK_C;
+            break;
+
+        case CPU_FLAG_OP_SHIFT:
+            if (lazy->carry)                                    flags |= CPU_STATUS_MASK_C;
+            break;
+
+        default:
+            break;
     }
 
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_Z, 0);
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_H, 0);
+    return flags;
 }
 
+/**
+ *  Reads F, materializing any pending flags.
+ */
 static uint8_t read_status(cpu_context_t *context)
 { 
+    if (context->lazy_flags.op != CPU_FLAG_OP_NONE){
+        context->af.lo = compute_flags(&context->lazy_flags);
+        context->lazy_flags.op = CPU_FLAG_OP_NONE;
+    }
+
     return context->af.lo; 
 }
 
 static void set_status(cpu_context_t *context, uint8_t flags)
 {
     context->af.lo = flags;
+    context->lazy_flags.op = CPU_FLAG_OP_NONE;
+}
+
+/**
+ *  Reads only the carry flag, without materializing the rest of F.
+ */
+static uint8_t read_carry(cpu_context_t *context)
+{
+    const cpu_lazy_flags_t *lazy = &context->lazy_flags;
+
+    switch (lazy->op)
+    {
+        case CPU_FLAG_OP_NONE:  return CPU_STATUS_C_TEST(context->af.lo);
+        case CPU_FLAG_OP_ADD:   return lazy->result > 0xFF;
+        case CPU_FLAG_OP_SUB:   return lazy->a < (uint16_t) lazy->b + lazy->carry;
+        case CPU_FLAG_OP_AND:
+        case CPU_FLAG_OP_OR:    return 0;
+        default:                return lazy->carry;
+    }
+}
+
+void cpu_flags_sync(cpu_context_t *context)
+{
+    read_status(context);
 }
 
 /**
- *  Manages 8-bit ALU operations
+ *  Adds a signed value to SP, returns the sum without writing SP.
+ *  H and C come from the unsigned add of the offset byte to the
+ *  low byte of SP, Z and N are cleared.
+ */
+static uint16_t signed_add_sp(cpu_context_t *context, int8_t imm8)
+{
+    uint8_t offset = (uint8_t) imm8;
+    uint8_t status = 0;
+
+    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, CHECK_CARRY8(context->sp & 0xFF, offset));
+    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_H, CHECK_HALF_CARRY8(context->sp, offset));
+    set_status(context, status);
+
+    return (uint16_t) (context->sp + imm8);
+}
+
+/**
+ *  Manages 8-bit ALU operations.
+ *  Flags are not computed here, only recorded for later.
  */
 static void alu_op8(cpu_context_t *context, 
                     uint8_t alu8_opcode, uint8_t operand)
 {    
-    uint16_t accumulator = context->af.hi;
-    uint16_t wide_operand = operand;
-    uint8_t prev_flags = read_status(context);
-    uint8_t flags = 0x0;
+    uint8_t accumulator = context->af.hi;
+    uint8_t carry;
+    uint16_t result;
     
     /* Now, operate on the values */
     switch (alu8_opcode)
     {
-        /* Single cycle registers to load */
         case ALU_ADD    :
         case ALU_ADDC   : 
-            wide_operand += (alu8_opcode == ALU_ADDC) ? CPU_STATUS_C_TEST(prev_flags) : 0;
-            if (CHECK_CARRY8(accumulator, wide_operand))       flags |= CPU_STATUS_MASK_C;
-            if (CHECK_HALF_CARRY8(accumulator, wide_operand))  flags |= CPU_STATUS_MASK_H;
-            accumulator += wide_operand; 
+            /* ADC is the only op here needing the previous flags */
+            carry = (alu8_opcode == ALU_ADDC) ? read_carry(context) : 0;
+            result = (uint16_t) accumulator + operand + carry;
+            defer_flags(context, CPU_FLAG_OP_ADD, accumulator, operand, carry, result);
             break;
 
         case ALU_SUB    :
         case ALU_SUBC   :
         case ALU_CP     : 
-            wide_operand -= (alu8_opcode == ALU_SUBC) ? CPU_STATUS_C_TEST(prev_flags) : 0;
-            if (CHECK_BORROW8(accumulator, wide_operand))       flags |= CPU_STATUS_MASK_C;
-            if (CHECK_HALF_BORROW8(accumulator, wide_operand))  flags |= CPU_STATUS_MASK_H;
-            flags |= CPU_STATUS_MASK_N;
-            accumulator -= wide_operand; break;
+            carry = (alu8_opcode == ALU_SUBC) ? read_carry(context) : 0;
+            result = (uint16_t) (accumulator - operand - carry);
+            defer_flags(context, CPU_FLAG_OP_SUB, accumulator, operand, carry, result);
+            break;
             
         case ALU_AND    :             
-            accumulator &= wide_operand;
-            flags |= CPU_STATUS_MASK_H; 
+            result = accumulator & operand;
+            defer_flags(context, CPU_FLAG_OP_AND, accumulator, operand, 0, result);
             break;
 
-        case ALU_OR     : accumulator |= wide_operand; break;
-        case ALU_XOR    : accumulator ^= wide_operand; break;
+        case ALU_OR     : 
+            result = accumulator | operand;
+            defer_flags(context, CPU_FLAG_OP_OR, accumulator, operand, 0, result);
+            break;
 
-        default:
+        case ALU_XOR    : 
+            result = accumulator ^ operand;
+            defer_flags(context, CPU_FLAG_OP_OR, accumulator, operand, 0, result);
             break;
-    }
 
-    /* 
-        Common case:
-        -  Z flag is set when result (accumulator) is zero. 
-    */
-    if ((accumulator & 0xff) == 0) flags |= CPU_STATUS_MASK_Z;
-    set_status(context, flags);
+        default:
+            return;
+    }
 
     if (alu8_opcode != ALU_CP)  
-        context->af.hi = (uint8_t) (accumulator & 0xff);
+        context->af.hi = (uint8_t) (result & 0xff);
 
     return;
 }
@@ -358,25 +461,16 @@ static bool is_branch_taken(cpu_context_t *context, uint8_t condition)
 */
 static void rr_r8(cpu_context_t *context, uint8_t r8_code)
 {
-    uint8_t new_val;
-    uint8_t prev_status = read_status(context);
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t lsb = r8_val & 0x1;
-    uint8_t prev_carry = CPU_STATUS_C_TEST(prev_status);
+    uint8_t prev_carry = read_carry(context);
     
     /* Previous carry becomes MSB */
-    new_val = (r8_val >> 1) | (prev_carry << 7);
+    uint8_t new_val = (r8_val >> 1) | (prev_carry << 7);
 
-    /* Set carry to be previous LSB */
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, lsb);
-
-    /* Set zero flag */
-    /* Weird behaviour, need to zero out the Z flag if register is A*/
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_Z, (new_val == 0));
- 
+    /* Carry becomes the previous LSB */
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, lsb, new_val);
     write_reg8(context, r8_code, new_val);
-    set_status(context, status);    
 }
 
 /*
@@ -385,24 +479,15 @@ static void rr_r8(cpu_context_t *context, uint8_t r8_code)
 */
 static void rl_r8(cpu_context_t *context, uint8_t r8_code)
 {
-    uint8_t new_val;
-    uint8_t prev_status = read_status(context);
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t msb = r8_val >> 7;
-    uint8_t prev_carry = CPU_STATUS_C_TEST(prev_status);
+    uint8_t prev_carry = read_carry(context);
     
     /* Prev carry becomes the LSB */
-    new_val = (r8_val << 1) | (prev_carry);
+    uint8_t new_val = (r8_val << 1) | (prev_carry);
     
-    /* Set MSB to be carry */
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, msb);
-
-    /* Set Z flag if zero */
-    /* Weird behaviour, need to zero out the Z flag if register is A*/
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_Z, (new_val == 0));
-
-    set_status(context, status);
+    /* Carry becomes the previous MSB */
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, msb, new_val);
     write_reg8(context, r8_code, new_val);
 }
 
@@ -413,15 +498,12 @@ static void rl_r8(cpu_context_t *context, uint8_t r8_code)
 */
 static void rlc_r8(cpu_context_t *context, uint8_t r8_code)
 {
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t msb = r8_val >> 7;
     uint8_t result = (r8_val << 1) | msb;
 
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_Z, (result == 0));
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, msb);
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, msb, result);
     write_reg8(context, r8_code, result);
-    set_status(context, status);
 }
 
 /*
@@ -430,25 +512,28 @@ static void rlc_r8(cpu_context_t *context, uint8_t r8_code)
 */
 static void rrc_r8(cpu_context_t *context, uint8_t r8_code)
 {
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t lsb = r8_val & 0x1;
     uint8_t result = (r8_val >> 1) | (lsb << 7);
 
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_Z, (result == 0));
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, lsb);
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, lsb, result);
     write_reg8(context, r8_code, result);
-    set_status(context, status);
 }
 
-static uint16_t read_imm16(cpu_context_t *context){
-    uint8_t lo = bus_read(context->pc++);
-    uint8_t hi = bus_read(context->pc++);
-    return (hi << 8) | lo;
+static uint8_t read_imm8(cpu_context_t *context){
+    /* Operand already decoded by the block cache */
+    if (context->imm_ptr != NULL){
+        context->pc++;
+        return *context->imm_ptr++;
+    }
+
+    return cpu_fetch_pc(context);
 }
 
-static uint8_t read_imm8(cpu_context_t *context){
-    return bus_read(context->pc++);
+static uint16_t read_imm16(cpu_context_t *context){
+    uint8_t lo = read_imm8(context);
+    uint8_t hi = read_imm8(context);
+    return (hi << 8) | lo;
 }
 
 void instr_nop(cpu_context_t *context, uint8_t opcode)
@@ -456,7 +541,7 @@ void instr_nop(cpu_context_t *context, uint8_t opcode)
     (void) opcode;
     
     /* Do nothing, only increment cycle count */
-    context->cycles += 1; 
+    CPU_ADD_CYCLES(context, 1); 
 }
 
 void instr_ld_r16_imm16     (cpu_context_t *context, uint8_t opcode)
@@ -466,7 +551,7 @@ void instr_ld_r16_imm16     (cpu_context_t *context, uint8_t opcode)
     uint8_t r16code = (opcode >> 4) & 0x3;
 
     write_reg16(context, r16code, imm16);
-    context->cycles += 4;
+    CPU_ADD_CYCLES(context, 3);
 }
 
 void instr_ld_r16mem_a      (cpu_context_t *context, uint8_t opcode)
@@ -475,7 +560,7 @@ void instr_ld_r16mem_a      (cpu_context_t *context, uint8_t opcode)
     uint8_t wrdata = read_reg8(context, R8_A);
     write_reg16mem(context, r16mem_code, wrdata);
     
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_ld_a_r16mem      (cpu_context_t *context, uint8_t opcode)
@@ -483,7 +568,7 @@ void instr_ld_a_r16mem      (cpu_context_t *context, uint8_t opcode)
     uint8_t r16mem_code = (opcode >> 4) & 0x3;
     uint8_t rdata = read_reg16mem(context, r16mem_code);
     write_reg8(context, R8_A, rdata);
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_ld_imm16mem_sp   (cpu_context_t *context, uint8_t opcode)
@@ -492,9 +577,9 @@ void instr_ld_imm16mem_sp   (cpu_context_t *context, uint8_t opcode)
     uint16_t sp = read_reg16(context, R16_SP);
 
     /* Store low half */
-    bus_write(addr, sp & 0xff);
-    bus_write(addr+1, sp >> 8);
-    context->cycles += 5;
+    CPU_WRITE(context, addr, sp & 0xff);
+    CPU_WRITE(context, addr+1, sp >> 8);
+    CPU_ADD_CYCLES(context, 5);
 }
 
 void instr_add_hl_r16       (cpu_context_t *context, uint8_t opcode)
@@ -511,8 +596,9 @@ void instr_add_hl_r16       (cpu_context_t *context, uint8_t opcode)
     status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_N, 0);
     status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_H, CHECK_HALF_CARRY16(hl_val, r16_val));
     status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, CHECK_CARRY16(hl_val, r16_val));
+    set_status(context, status);
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_inc_r16          (cpu_context_t *context, uint8_t opcode)
@@ -520,7 +606,7 @@ void instr_inc_r16          (cpu_context_t *context, uint8_t opcode)
     uint8_t reg16_code = (opcode >> 4) & 0x3;
     uint16_t old_val = read_reg16(context, reg16_code);
     write_reg16(context, reg16_code, (uint16_t) (old_val+1));    
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_dec_r16          (cpu_context_t *context, uint8_t opcode)
@@ -528,7 +614,43 @@ void instr_dec_r16          (cpu_context_t *context, uint8_t opcode)
     uint8_t reg16_code = (opcode >> 4) & 0x3;
     uint16_t old_val = read_reg16(context, reg16_code);
     write_reg16(context, reg16_code, (uint16_t) (old_val-1));    
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
+}
+
+void instr_inc_r8           (cpu_context_t *context, uint8_t opcode)
+{
+    uint8_t r8_code = (opcode >> 3) & 0x7;
+    uint8_t old_val = read_reg8(context, r8_code);
+    uint8_t new_val = old_val + 1;
+
+    /* C is preserved */
+    defer_flags(context, CPU_FLAG_OP_INC, old_val, 1, read_carry(context), new_val);
+    write_reg8(context, r8_code, new_val);
+
+    if (r8_code == R8_HL_MEM) {
+        CPU_ADD_CYCLES(context, 3);
+        return;
+    }
+
+    CPU_ADD_CYCLES(context, 1);
+}
+
+void instr_dec_r8           (cpu_context_t *context, uint8_t opcode)
+{
+    uint8_t r8_code = (opcode >> 3) & 0x7;
+    uint8_t old_val = read_reg8(context, r8_code);
+    uint8_t new_val = old_val - 1;
+
+    /* C is preserved */
+    defer_flags(context, CPU_FLAG_OP_DEC, old_val, 1, read_carry(context), new_val);
+    write_reg8(context, r8_code, new_val);
+
+    if (r8_code == R8_HL_MEM) {
+        CPU_ADD_CYCLES(context, 3);
+        return;
+    }
+
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_ld_r8_imm8       (cpu_context_t *context, uint8_t opcode)
@@ -539,62 +661,67 @@ void instr_ld_r8_imm8       (cpu_context_t *context, uint8_t opcode)
     write_reg8(context, dest_num, imm8);
     
     if (dest_num == R8_HL_MEM) {
-        context->cycles += 3;
+        CPU_ADD_CYCLES(context, 3);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_rlca             (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;
-    uint8_t status = read_status(context);
     rlc_r8(context, R8_A);
 
-    /* Weird behaviour: zero flag is set regardless */
-    set_status(context, status & (~CPU_STATUS_MASK_Z));
-    context->cycles += 1;
+    /* Unlike the CB version, Z is always cleared, only C survives */
+    set_status(context, read_carry(context) ? CPU_STATUS_MASK_C : 0);
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_rrca             (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;
-    uint8_t status = read_status(context);
     rrc_r8(context, R8_A);
 
-    /* Weird behaviour: zero flag is set regardless */
-    set_status(context, status & (~CPU_STATUS_MASK_Z));
-    context->cycles += 1;
+    /* Unlike the CB version, Z is always cleared, only C survives */
+    set_status(context, read_carry(context) ? CPU_STATUS_MASK_C : 0);
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_rla              (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;
-    uint8_t status = read_status(context);
     rl_r8(context, R8_A);
 
-    /* Weird behaviour: zero flag is set regardless */
-    set_status(context, status & (~CPU_STATUS_MASK_Z));
-    context->cycles += 1;
+    /* Unlike the CB version, Z is always cleared, only C survives */
+    set_status(context, read_carry(context) ? CPU_STATUS_MASK_C : 0);
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_rra              (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;
-    uint8_t status = read_status(context);
     rr_r8(context, R8_A);
 
-    /* Weird behaviour: zero flag is set regardless */
-    set_status(context, status & (~CPU_STATUS_MASK_Z));
-    context->cycles += 1;
+    /* Unlike the CB version, Z is always cleared, only C survives */
+    set_status(context, read_carry(context) ? CPU_STATUS_MASK_C : 0);
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_daa              (cpu_context_t *context, uint8_t opcode)
 {
+    (void) opcode;
+
     uint8_t status = read_status(context);
-    uint8_t new_status = status;
     uint8_t old_a_val = read_reg8(context, R8_A);
+
+#if CPU_ALU_TABLES
+    uint16_t entry = alu_daa_table[ALU_DAA_NHC(status)][old_a_val];
+
+    write_reg8(context, R8_A, (uint8_t) entry);
+    set_status(context, (uint8_t) (entry >> 8));
+#else
+    uint8_t new_status = status;
     uint16_t new_a_val = (uint16_t) old_a_val;
     uint8_t adjustment = 0;
 
@@ -605,19 +732,21 @@ void instr_daa              (cpu_context_t *context, uint8_t opcode)
         new_a_val -= adjustment;
     
     } else {
-        adjustment += ((CPU_STATUS_H_TEST(status) || (old_a_val & 0xfu > 0x9u)) ? 0x6u : 0)
+        adjustment += ((CPU_STATUS_H_TEST(status) || ((old_a_val & 0xfu) > 0x9u)) ? 0x6u : 0)
                         + ((CPU_STATUS_C_TEST(status) || (old_a_val > 0x99u))? 0x60u : 0);
     
         new_a_val += adjustment;
     } 
 
     write_reg8(context, R8_A, (uint8_t) (new_a_val & 0xffu));
-    new_status = CPU_STATUS_SETBIT(new_status, CPU_STATUS_MASK_Z, new_a_val == 0);
+    new_status = CPU_STATUS_SETBIT(new_status, CPU_STATUS_MASK_Z, (new_a_val & 0xffu) == 0);
     new_status = CPU_STATUS_SETBIT(new_status, CPU_STATUS_MASK_H, 0x0u);
-    new_status = CPU_STATUS_SETBIT(new_status, CPU_STATUS_MASK_C, new_a_val > 0xffu);
+    /* C is set by the 0x60 adjustment and never cleared */
+    new_status = CPU_STATUS_SETBIT(new_status, CPU_STATUS_MASK_C, (adjustment & 0x60u) != 0);
     
     set_status(context, new_status);
-    context->cycles += 1;
+#endif
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_cpl              (cpu_context_t *context, uint8_t opcode)
@@ -625,8 +754,10 @@ void instr_cpl              (cpu_context_t *context, uint8_t opcode)
     (void) opcode;
 
     context->af.hi = ~context->af.hi;
-    set_status(context, CPU_STATUS_MASK_N | CPU_STATUS_MASK_H);
-    context->cycles += 1;
+    /* Preserve the Z and C flags */
+    set_status(context, (read_status(context) & (CPU_STATUS_MASK_Z | CPU_STATUS_MASK_C))
+                        | CPU_STATUS_MASK_N | CPU_STATUS_MASK_H);
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_scf              (cpu_context_t *context, uint8_t opcode)
@@ -639,7 +770,7 @@ void instr_scf              (cpu_context_t *context, uint8_t opcode)
     /* Preserve the Z flag, set C flag */
     status |= (prev_status & CPU_STATUS_MASK_Z) | CPU_STATUS_MASK_C; 
     set_status(context, status);
-    context->cycles += 1;
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_ccf              (cpu_context_t *context, uint8_t opcode)
@@ -650,7 +781,7 @@ void instr_ccf              (cpu_context_t *context, uint8_t opcode)
     /* Preserve the Z flag, complement C flag */
     status |= (prev_status & CPU_STATUS_MASK_Z) | (~prev_status & CPU_STATUS_MASK_C); 
     set_status(context, status);
-    context->cycles += 1;
+    CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_jr_imm8          (cpu_context_t *context, uint8_t opcode)
@@ -668,7 +799,7 @@ void instr_jr_imm8          (cpu_context_t *context, uint8_t opcode)
         context->pc -= abs_val;
     }
 
-    context->cycles += 3;
+    CPU_ADD_CYCLES(context, 3);
 }
 
 void instr_jr_cond_imm8     (cpu_context_t *context, uint8_t opcode)
@@ -678,7 +809,7 @@ void instr_jr_cond_imm8     (cpu_context_t *context, uint8_t opcode)
     uint16_t new_addr;
 
     if (!is_branch_taken(context, condition)) {
-        context->cycles += 2;
+        CPU_ADD_CYCLES(context, 2);
         return;
     }
 
@@ -691,11 +822,20 @@ void instr_jr_cond_imm8     (cpu_context_t *context, uint8_t opcode)
         context->pc -= abs_val;
     }
 
-    context->cycles += 3;
+    CPU_ADD_CYCLES(context, 3);
 }
 
 
-void instr_stop             (cpu_context_t *context, uint8_t opcode);
+void instr_stop             (cpu_context_t *context, uint8_t opcode)
+{
+    (void) opcode;
+
+    /* STOP is followed by a padding byte, skipped without a bus cycle */
+    if (context->imm_ptr != NULL) context->imm_ptr++;
+    context->pc++;
+    context->sleep_state = CPU_SLEEP_STOP;
+    CPU_ADD_CYCLES(context, 1);
+}
 
 
 void instr_ld_r8_r8         (cpu_context_t *context, uint8_t opcode)
@@ -706,15 +846,25 @@ void instr_ld_r8_r8         (cpu_context_t *context, uint8_t opcode)
     uint8_t reg_val = read_reg8(context, src_num);
     write_reg8(context, dest_num, reg_val);
 
-    if (dest_num == R8_HL_MEM) {
-        context->cycles += 2;
+    if (dest_num == R8_HL_MEM || src_num == R8_HL_MEM) {
+        CPU_ADD_CYCLES(context, 2);
         return;
     }
 
-    context->cycles += 1;
+    CPU_ADD_CYCLES(context, 1);
+}
+
+void instr_halt             (cpu_context_t *context, uint8_t opcode)
+{
+    (void) opcode;
+
+    /* HALT bug: doesn't sleep, the byte after HALT is fetched twice (see `cpu_run`) */
+    if (!context->ime && interrupt_get_pending(CPU_INSTANCE(context)) != 0){
+        context->halt_bug = 1;
+    } else context->sleep_state = CPU_SLEEP_HALT;
+    CPU_ADD_CYCLES(context, 1);
 }
 
-void instr_halt             (cpu_context_t *context, uint8_t opcode);
 void instr_alu_op_r8        (cpu_context_t *context, uint8_t opcode)
 {
     uint8_t reg8 = opcode & 0x7;
@@ -726,8 +876,8 @@ void instr_alu_op_r8        (cpu_context_t *context, uint8_t opcode)
     /* Set accumulator to the proper values */
     alu_op8(context, alu_opcode, reg_val);
     if (reg8 == R8_HL_MEM){
-        context->cycles += 2;
-    } else context->cycles += 1;
+        CPU_ADD_CYCLES(context, 2);
+    } else CPU_ADD_CYCLES(context, 1);
 }
 
 void instr_alu_op_imm8      (cpu_context_t *context, uint8_t opcode)
@@ -737,7 +887,7 @@ void instr_alu_op_imm8      (cpu_context_t *context, uint8_t opcode)
     alu_op8(context, alu_opcode, imm8);
 
     /* Regardless of OP, this always takes two cycles */
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_ret_cond         (cpu_context_t *context, uint8_t opcode)
@@ -745,17 +895,21 @@ void instr_ret_cond         (cpu_context_t *context, uint8_t opcode)
     uint8_t reg_high, reg_low;
     uint8_t condition = (opcode >> 3) & 0x3;
 
+    /* Condition is checked on its own M-cycle */
+    CPU_INTERNAL(context);
+
     /* Condition not met */
     if (!is_branch_taken(context, condition)) {
-        context->cycles += 2;
+        CPU_ADD_CYCLES(context, 2);
         return;
     }
 
-    reg_low = bus_read(context->sp++);
-    reg_high = bus_read(context->sp++);
+    reg_low = CPU_READ(context, context->sp++);
+    reg_high = CPU_READ(context, context->sp++);
 
     context->pc = REGFULL(reg_high, reg_low);
-    context->cycles += 5;
+    CPU_ADD_CYCLES(context, 5);
+    PROFILER_RET(CPU_INSTANCE(context));
 }
 
 void instr_ret              (cpu_context_t *context, uint8_t opcode)
@@ -765,14 +919,21 @@ void instr_ret              (cpu_context_t *context, uint8_t opcode)
     /* Equivalent to POP PC */
     uint8_t reg_high, reg_low;
 
-    reg_low = bus_read(context->sp++);
-    reg_high = bus_read(context->sp++);
+    reg_low = CPU_READ(context, context->sp++);
+    reg_high = CPU_READ(context, context->sp++);
 
     context->pc = REGFULL(reg_high, reg_low);
-    context->cycles += 4;
+    CPU_ADD_CYCLES(context, 4);
+    PROFILER_RET(CPU_INSTANCE(context));
 }
 
-void instr_reti             (cpu_context_t *context, uint8_t opcode);
+void instr_reti             (cpu_context_t *context, uint8_t opcode)
+{
+    /* No delay, unlike EI */
+    instr_ret(context, opcode);
+    context->ime = 1;
+    interrupt_set_ime(CPU_INSTANCE(context), 1);
+}
 
 
 void instr_jp_cond          (cpu_context_t *context, uint8_t opcode)
@@ -782,12 +943,12 @@ void instr_jp_cond          (cpu_context_t *context, uint8_t opcode)
     uint8_t condition = (opcode >> 3) & 0x3;
     
     if (!is_branch_taken(context, condition)) {
-        context->cycles += 3;
+        CPU_ADD_CYCLES(context, 3);
         return;
     }
 
     context->pc = address;
-    context->cycles += 4;
+    CPU_ADD_CYCLES(context, 4);
 }
 
 void instr_jp_imm16         (cpu_context_t *context, uint8_t opcode)
@@ -796,7 +957,7 @@ void instr_jp_imm16         (cpu_context_t *context, uint8_t opcode)
     
     addr_t address = read_imm16(context);
     context->pc = address;
-    context->cycles += 4;
+    CPU_ADD_CYCLES(context, 4);
 }
 
 
@@ -805,7 +966,7 @@ void instr_jp_hl            (cpu_context_t *context, uint8_t opcode)
     (void) opcode;
 
     context->pc = context->hl.full;
-    context->cycles += 1;
+    CPU_ADD_CYCLES(context, 1);
 }
 
 
@@ -814,30 +975,46 @@ void instr_call_cond_imm16  (cpu_context_t *context, uint8_t opcode){
     uint8_t condition = (opcode >> 3) & 3;
 
     if (!is_branch_taken(context, condition)) {
-        context->cycles += 3;
+        CPU_ADD_CYCLES(context, 3);
         return;
     }
     
     /* Push PC on stack */
-    bus_write(--context->sp, REGHIGH(context->pc));
-    bus_write(--context->sp, REGLOW(context->pc));
+    CPU_INTERNAL(context);
+    CPU_WRITE(context, --context->sp, REGHIGH(context->pc));
+    CPU_WRITE(context, --context->sp, REGLOW(context->pc));
 
     context->pc = label;
-    context->cycles += 6;
+    CPU_ADD_CYCLES(context, 6);
+    PROFILER_CALL(CPU_INSTANCE(context), label);
 }
 
 void instr_call_imm16       (cpu_context_t *context, uint8_t opcode){
     addr_t label = read_imm16(context);
 
     /* Push PC to stack */
-    bus_write(--context->sp, REGHIGH(context->pc));
-    bus_write(--context->sp, REGLOW(context->pc));
+    CPU_INTERNAL(context);
+    CPU_WRITE(context, --context->sp, REGHIGH(context->pc));
+    CPU_WRITE(context, --context->sp, REGLOW(context->pc));
 
     context->pc = label;
-    context->cycles += 6;
+    CPU_ADD_CYCLES(context, 6);
+    PROFILER_CALL(CPU_INSTANCE(context), label);
 }
 
-void instr_rst_tgt3         (cpu_context_t *context, uint8_t opcode);
+void instr_rst_tgt3         (cpu_context_t *context, uint8_t opcode)
+{
+    /* Target is encoded in bits 3-5, times 8 */
+    addr_t target = opcode & 0x38;
+
+    CPU_INTERNAL(context);
+    CPU_WRITE(context, --context->sp, REGHIGH(context->pc));
+    CPU_WRITE(context, --context->sp, REGLOW(context->pc));
+
+    context->pc = target;
+    CPU_ADD_CYCLES(context, 4);
+    PROFILER_CALL(CPU_INSTANCE(context), target);
+}
 
 
 void instr_pop_r16stk       (cpu_context_t *context, uint8_t opcode)
@@ -846,21 +1023,25 @@ void instr_pop_r16stk       (cpu_context_t *context, uint8_t opcode)
     uint8_t reg_high, reg_low;
     uint16_t full_val;
 
-    reg_low = bus_read(context->sp++);
-    reg_high = bus_read(context->sp++);
+    reg_low = CPU_READ(context, context->sp++);
+    reg_high = CPU_READ(context, context->sp++);
 
     switch (r16stk)
     {
         case R16STK_BC: context->bc.full = REGFULL(reg_high, reg_low); break;
         case R16STK_DE: context->de.full = REGFULL(reg_high, reg_low); break;
         case R16STK_HL: context->hl.full = REGFULL(reg_high, reg_low); break;
-        case R16STK_AF: context->af.full = REGFULL(reg_high, reg_low); break;
+        case R16STK_AF: 
+            /* The low nibble of F doesn't exist and always reads 0 */
+            context->af.full = REGFULL(reg_high, reg_low & 0xF0); 
+            context->lazy_flags.op = CPU_FLAG_OP_NONE;
+            break;
     
         default:
             break;
     }
 
-    context->cycles += 3;
+    CPU_ADD_CYCLES(context, 3);
 }
 
 
@@ -873,7 +1054,7 @@ void instr_push_r16stk      (cpu_context_t *context, uint8_t opcode)
         case R16STK_BC: reg_data = context->bc.full; break;
         case R16STK_DE: reg_data = context->de.full; break;
         case R16STK_HL: reg_data = context->hl.full; break;
-        case R16STK_AF: reg_data = context->af.full; break;
+        case R16STK_AF: read_status(context); reg_data = context->af.full; break;
         
         default:
             break;
@@ -885,26 +1066,27 @@ void instr_push_r16stk      (cpu_context_t *context, uint8_t opcode)
     */
 
     /* Write HIGH part */
-    bus_write(--context->sp, REGHIGH(reg_data));
-    bus_write(--context->sp, REGLOW(reg_data));
-    context->cycles += 4;
+    CPU_INTERNAL(context);
+    CPU_WRITE(context, --context->sp, REGHIGH(reg_data));
+    CPU_WRITE(context, --context->sp, REGLOW(reg_data));
+    CPU_ADD_CYCLES(context, 4);
 }
 
 void instr_cb_prefix        (cpu_context_t *context, uint8_t opcode)
 {
     assert(opcode == 0xcbu);
     uint8_t next_opcode = read_imm8(context);
-    INSTR_FUNC opfunc = prefix_optable[next_opcode];
+    INSTR_FUNC opfunc = CPU_PREFIX_OPTABLE[next_opcode];
 
-    opfunc(context, opcode);
+    opfunc(context, next_opcode);
 }
 
 void instr_ldh_cmem_a       (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;  
     addr_t addr = 0xFF00 + read_reg8(context, R8_C);
-    bus_write(addr, read_reg8(context, R8_A));
-    context->cycles += 2;
+    CPU_WRITE(context, addr, read_reg8(context, R8_A));
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_ldh_imm8mem_a    (cpu_context_t *context, uint8_t opcode)
@@ -912,24 +1094,24 @@ void instr_ldh_imm8mem_a    (cpu_context_t *context, uint8_t opcode)
     (void) opcode;  
     uint8_t imm8 = read_imm8(context);
     addr_t addr = 0xFF00 + imm8;
-    bus_write(addr, read_reg8(context, R8_A));
-    context->cycles += 3;
+    CPU_WRITE(context, addr, read_reg8(context, R8_A));
+    CPU_ADD_CYCLES(context, 3);
 }
 
 void instr_ld_imm16mem_a    (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;
     uint16_t imm16 = read_imm16(context);
-    bus_write((addr_t) imm16, read_reg8(context, R8_A));
-    context->cycles += 4;
+    CPU_WRITE(context, (addr_t) imm16, read_reg8(context, R8_A));
+    CPU_ADD_CYCLES(context, 4);
 }
 
 void instr_ldh_a_cmem       (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;  
     addr_t addr = 0xFF00 + read_reg8(context, R8_C);
-    write_reg8(context, R8_A, bus_read(addr));
-    context->cycles += 2;
+    write_reg8(context, R8_A, CPU_READ(context, addr));
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_ldh_a_imm8mem    (cpu_context_t *context, uint8_t opcode)
@@ -937,46 +1119,61 @@ void instr_ldh_a_imm8mem    (cpu_context_t *context, uint8_t opcode)
     (void) opcode;
     uint8_t imm8 = read_imm8(context);
     addr_t addr = 0xFF00 + imm8;
-    write_reg8(context, R8_A, bus_read(addr));
-    context->cycles += 3;
+    write_reg8(context, R8_A, CPU_READ(context, addr));
+    CPU_ADD_CYCLES(context, 3);
 }
 
 void instr_ld_a_imm16mem    (cpu_context_t *context, uint8_t opcode)
 {
     (void) opcode;
     uint16_t imm16 = read_imm16(context);
-    write_reg8(context, R8_A, bus_read((addr_t) imm16));
-    context->cycles += 4;
+    write_reg8(context, R8_A, CPU_READ(context, (addr_t) imm16));
+    CPU_ADD_CYCLES(context, 4);
 }
 
 void instr_add_sp_imm8      (cpu_context_t *context, uint8_t opcode)
 {
     int8_t imm8 = (int8_t) read_imm8(context);
-    signed_add_sp(context, imm8);
-    context->cycles += 4;
+    context->sp = signed_add_sp(context, imm8);
+    CPU_ADD_CYCLES(context, 4);
 }
 
 
 void instr_ld_hl_sp_imm8    (cpu_context_t *context, uint8_t opcode)
 {
     int8_t imm8 = (int8_t) read_imm8(context);
-    signed_add_sp(context, imm8);
-    context->hl.full = context->sp;
-    context->cycles += 3;
+    context->hl.full = signed_add_sp(context, imm8);
+    CPU_ADD_CYCLES(context, 3);
 }
 
 void instr_ld_sp_hl         (cpu_context_t *context, uint8_t opcode)
 {   
     (void) opcode;
     write_reg16(context, R16_SP, read_reg16(context, R16_HL));
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_di               (cpu_context_t *context, uint8_t opcode)
 {
-     
+    (void) opcode;
+    context->ime = 0;
+    context->ei_delay = 0;
+    interrupt_set_ime(CPU_INSTANCE(context), 0);
+    CPU_ADD_CYCLES(context, 1);
+}
+
+void instr_ei               (cpu_context_t *context, uint8_t opcode)
+{
+    (void) opcode;
+
+    /* Already enabled, EI doesn't delay anything */
+    if (!context->ime){
+        context->ei_delay = 1;
+    }
+    context->ime = 1;
+    interrupt_set_ime(CPU_INSTANCE(context), 1);
+    CPU_ADD_CYCLES(context, 1);
 }
-void instr_ei               (cpu_context_t *context, uint8_t opcode);
 
 /**
  * ============================================================
@@ -990,11 +1187,11 @@ void instr_rlc_r8     (cpu_context_t *context, uint8_t opcode)
     rlc_r8(context, r8_code);
 
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_rrc_r8     (cpu_context_t *context, uint8_t opcode)
@@ -1003,11 +1200,11 @@ void instr_rrc_r8     (cpu_context_t *context, uint8_t opcode)
     rrc_r8(context, r8_code);
 
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_rl_r8      (cpu_context_t *context, uint8_t opcode)
@@ -1016,11 +1213,11 @@ void instr_rl_r8      (cpu_context_t *context, uint8_t opcode)
     rl_r8(context, r8_code);
 
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_rr_r8      (cpu_context_t *context, uint8_t opcode)
@@ -1029,42 +1226,34 @@ void instr_rr_r8      (cpu_context_t *context, uint8_t opcode)
     rr_r8(context, r8_code);
 
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_sla_r8     (cpu_context_t *context, uint8_t opcode)
 {
     uint8_t r8_code = opcode & 0x7;
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t res = r8_val << 1;
 
     write_reg8(context, r8_code, res);
 
-    status = CPU_STATUS_SETBIT(status, 
-                        CPU_STATUS_MASK_Z, (res == 0));
-    
     /* Set carry if MSB is 1*/
-    status = CPU_STATUS_SETBIT(status, 
-                        CPU_STATUS_MASK_C, (r8_val >> 7));
-
-    set_status(context, status);
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, (r8_val >> 7), res);
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_sra_r8     (cpu_context_t *context, uint8_t opcode)
 {
     uint8_t r8_code = opcode & 0x7;
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t sign_mask = r8_val & 0x80;
 
@@ -1073,94 +1262,74 @@ void instr_sra_r8     (cpu_context_t *context, uint8_t opcode)
     
     write_reg8(context, r8_code, res);
 
-    status = CPU_STATUS_SETBIT(status, 
-                        CPU_STATUS_MASK_Z, (res == 0));
-    
     /* Set carry if LSB is 1*/
-    status = CPU_STATUS_SETBIT(status, 
-                        CPU_STATUS_MASK_C, (r8_val & 0x1));
-
-    set_status(context, status);
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, (r8_val & 0x1), res);
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_swap_r8    (cpu_context_t *context, uint8_t opcode)
 {
     uint8_t r8_code = opcode & 0x7;
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t r8_swapped = 
     //    hi -> lo            lo -> hi
         (r8_val >> 4) | ((r8_val & 0xF) << 4);
 
     write_reg8(context, r8_code, r8_swapped);
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, 0, r8_swapped);
+
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    status = CPU_STATUS_SETBIT(status, 
-                        CPU_STATUS_MASK_Z, (r8_swapped == 0)); 
-    set_status(context, status);
-
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_srl_r8     (cpu_context_t *context, uint8_t opcode)
 {
     uint8_t r8_code = opcode & 0x7;
-    uint8_t status = 0x0;
     uint8_t r8_val = read_reg8(context, r8_code);
     uint8_t res = r8_val >> 1;
 
     write_reg8(context, r8_code, res);
 
-    status = CPU_STATUS_SETBIT(status, 
-                        CPU_STATUS_MASK_Z, (res == 0));
-    
     /* Set carry if LSB is 1*/
-    status = CPU_STATUS_SETBIT(status, 
-                        CPU_STATUS_MASK_C, (r8_val & 0x1));
-
-    set_status(context, status);
+    defer_flags(context, CPU_FLAG_OP_SHIFT, r8_val, 0, (r8_val & 0x1), res);
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
+        CPU_ADD_CYCLES(context, 4);
         return;
     }
 
-    context->cycles += 2;
+    CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_bit_b3_r8  (cpu_context_t *context, uint8_t opcode)
 {
     uint8_t reg_val;
-    uint8_t status = read_status(context);
+    uint8_t status = 0x0;
     uint8_t r8_code = opcode & 0x7;
     uint8_t bit_select = (opcode >> 3) & 0x7;
     uint8_t bit_set;
-    uint8_t select_mask;
-    uint8_t res;
 
     reg_val = read_reg8(context, r8_code);
-    select_mask = 0x1 << bit_select;
     bit_set = (reg_val >> bit_select) & 0x1;
-    res = bit_set ? 
-            (reg_val | select_mask) : (reg_val & ~select_mask);
     
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_Z, (res == 0));
-    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_N, 0);
+    /* Z is set when the bit is clear, C is left untouched */
+    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_Z, !bit_set);
     status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_H, 1);
+    status = CPU_STATUS_SETBIT(status, CPU_STATUS_MASK_C, read_carry(context));
 
     set_status(context, status);
     
     if (r8_code == R8_HL_MEM){
-        context->cycles += 3;
-    } else context->cycles += 2;
+        CPU_ADD_CYCLES(context, 3);
+    } else CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_res_b3_r8  (cpu_context_t *context, uint8_t opcode)
@@ -1175,8 +1344,8 @@ void instr_res_b3_r8  (cpu_context_t *context, uint8_t opcode)
     write_reg8(context, r8_code, reg_val & (~mask));
     
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
-    } else context->cycles += 2;
+        CPU_ADD_CYCLES(context, 4);
+    } else CPU_ADD_CYCLES(context, 2);
 }
 
 void instr_set_b3_r8  (cpu_context_t *context, uint8_t opcode)
@@ -1191,6 +1360,20 @@ void instr_set_b3_r8  (cpu_context_t *context, uint8_t opcode)
     write_reg8(context, r8_code, reg_val | mask);
     
     if (r8_code == R8_HL_MEM){
-        context->cycles += 4;
-    } else context->cycles += 2;
-}
\ No newline at end of file
+        CPU_ADD_CYCLES(context, 4);
+    } else CPU_ADD_CYCLES(context, 2);
+}
+
+void instr_unimplemented    (cpu_context_t *context, uint8_t opcode)
+{
+    (void) context;
+    (void) opcode;
+    emu_die(STATUS_ILLEGAL_INSTRUCTION, "Illegal or unimplemented opcode.");
+}
+
+/*
+    Generated specialized handlers and threaded interpreter, included last
+    so the handlers above can be inlined into them.
+*/
+#include <spec_handlers.h>
+#include <dispatch.h>
@@ -0,0 +1,279 @@
+#include <core/profiler.h>
+
+#if CPU_PROFILER
+
+#include <gb_instance.h>
+#include <core/cartridge/cart.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILER_PC_MASK            (PROFILER_PC_ENTRIES - 1)
+#define PROFILER_NO_NODE            (-1)
+#define PROFILER_ROOT_NODE          0
+
+/* (bank, address) packed into one key */
+#define PROFILER_KEY(bank, addr)    (((uint32_t) (bank) << 16) | (addr))
+#define PROFILER_KEY_BANK(key)      ((uint16_t) ((key) >> 16))
+#define PROFILER_KEY_ADDR(key)      ((addr_t) ((key) & 0xFFFF))
+
+/**
+ *  Key of an address, with the ROM bank mapped at the time.
+ */
+static uint32_t key_of(gb_instance_t *gb, addr_t addr)
+{
+    uint16_t bank = cart_get_bank_at(gb, addr);
+    return PROFILER_KEY(bank, addr);
+}
+
+static void reset_call_tree(profiler_t *profiler)
+{
+    profiler->nodes[PROFILER_ROOT_NODE] = (profiler_node_t) {
+        .key = 0,
+        .parent = PROFILER_NO_NODE,
+        .first_child = PROFILER_NO_NODE,
+        .next_sibling = PROFILER_NO_NODE,
+    };
+    profiler->nodes_size = 1;
+    profiler->current_node = PROFILER_ROOT_NODE;
+    profiler->instr_node = PROFILER_ROOT_NODE;
+    profiler->depth = 0;
+    profiler->untracked_depth = 0;
+}
+
+void profiler_init(gb_instance_t *gb)
+{
+    profiler_t *profiler = &gb->profiler;
+
+    memset(profiler->opcodes, 0, sizeof(profiler->opcodes));
+    memset(profiler->pcs, 0, sizeof(profiler->pcs));
+    profiler->dropped_pcs = 0;
+    reset_call_tree(profiler);
+}
+
+void profiler_on_instr_start(gb_instance_t *gb)
+{
+    gb->profiler.instr_node = gb->profiler.current_node;
+}
+
+void profiler_on_instr(gb_instance_t *gb, addr_t pc, uint8_t opcode, uint8_t cb_opcode, m_cycle_t cycles)
+{
+    profiler_t *profiler = &gb->profiler;
+    unsigned op_index = (opcode == 0xCB) ? 256u + cb_opcode : opcode;
+    profiler->opcodes[op_index].count++;
+    profiler->opcodes[op_index].cycles += cycles;
+
+    profiler->nodes[profiler->instr_node].cycles += cycles;
+
+    /* Linear probing */
+    uint32_t key = key_of(gb, pc);
+    uint32_t slot = (key * 0x9E3779B1u) >> 16;
+    for (unsigned probe = 0; probe < PROFILER_PC_ENTRIES; ++probe){
+        profiler_pc_entry_t *entry = &profiler->pcs[(slot + probe) & PROFILER_PC_MASK];
+
+        if (entry->key == 0){
+            entry->key = key + 1;
+        }
+        if (entry->key == key + 1){
+            entry->counter.count++;
+            entry->counter.cycles += cycles;
+            return;
+        }
+    }
+    profiler->dropped_pcs++;
+}
+
+void profiler_on_call(gb_instance_t *gb, addr_t target)
+{
+    profiler_t *profiler = &gb->profiler;
+    uint32_t key = key_of(gb, target);
+    profiler_node_t *current = &profiler->nodes[profiler->current_node];
+
+    if (profiler->untracked_depth > 0 || profiler->depth == PROFILER_MAX_DEPTH){
+        profiler->untracked_depth++;
+        return;
+    }
+
+    /* Same routine called from the same stack before */
+    int child = current->first_child;
+    while (child != PROFILER_NO_NODE && profiler->nodes[child].key != key){
+        child = profiler->nodes[child].next_sibling;
+    }
+
+    if (child == PROFILER_NO_NODE){
+        if (profiler->nodes_size == PROFILER_MAX_NODES){
+            profiler->untracked_depth++;
+            return;
+        }
+
+        child = (int) profiler->nodes_size++;
+        profiler->nodes[child] = (profiler_node_t) {
+            .key = key,
+            .parent = profiler->current_node,
+            .first_child = PROFILER_NO_NODE,
+            .next_sibling = current->first_child,
+        };
+        current->first_child = child;
+    }
+
+    profiler->current_node = child;
+    profiler->depth++;
+}
+
+void profiler_on_ret(gb_instance_t *gb)
+{
+    profiler_t *profiler = &gb->profiler;
+
+    if (profiler->untracked_depth > 0){
+        profiler->untracked_depth--;
+        return;
+    }
+
+    if (profiler->current_node == PROFILER_ROOT_NODE) return;
+
+    profiler->current_node = profiler->nodes[profiler->current_node].parent;
+    profiler->depth--;
+}
+
+unsigned profiler_get_call_depth(gb_instance_t *gb)
+{
+    return gb->profiler.depth + gb->profiler.untracked_depth;
+}
+
+static int compare_symbols(const void *a, const void *b)
+{
+    uint32_t key_a = ((const profiler_symbol_t *) a)->key;
+    uint32_t key_b = ((const profiler_symbol_t *) b)->key;
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+bool profiler_load_sym(gb_instance_t *gb, const char *path)
+{
+    profiler_t *profiler = &gb->profiler;
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL && profiler->symbols_size < PROFILER_MAX_SYMBOLS){
+        unsigned bank, addr;
+        char name[PROFILER_SYMBOL_LEN];
+
+        /* `;` starts a comment */
+        if (sscanf(line, "%x:%x %63s", &bank, &addr, name) != 3 || name[0] == ';') continue;
+
+        profiler_symbol_t *symbol = &profiler->symbols[profiler->symbols_size++];
+        symbol->key = PROFILER_KEY(bank, addr);
+        strcpy(symbol->name, name);
+    }
+    fclose(file);
+
+    qsort(profiler->symbols, profiler->symbols_size, sizeof(profiler_symbol_t), compare_symbols);
+    return true;
+}
+
+/**
+ *  Writes `Label+offset` for the closest symbol at or before `key` in
+ *  the same bank, or `BB:AAAA` when there is none.
+ */
+static void format_location(const profiler_t *profiler, uint32_t key, char *buf, size_t size)
+{
+    const profiler_symbol_t *found = NULL;
+    unsigned lo = 0, hi = profiler->symbols_size;
+
+    /* Last symbol with symbol->key <= key */
+    while (lo < hi){
+        unsigned mid = (lo + hi) / 2;
+        if (profiler->symbols[mid].key <= key) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo > 0 && PROFILER_KEY_BANK(profiler->symbols[lo - 1].key) == PROFILER_KEY_BANK(key)){
+        found = &profiler->symbols[lo - 1];
+    }
+
+    if (found == NULL){
+        snprintf(buf, size, "%02X:%04X", PROFILER_KEY_BANK(key), PROFILER_KEY_ADDR(key));
+    } else if (found->key == key){
+        snprintf(buf, size, "%s", found->name);
+    } else {
+        snprintf(buf, size, "%s+0x%X", found->name, key - found->key);
+    }
+}
+
+/* Hottest first */
+static int compare_pc_entries(const void *a, const void *b)
+{
+    uint64_t cycles_a = (*(const profiler_pc_entry_t * const *) a)->counter.cycles;
+    uint64_t cycles_b = (*(const profiler_pc_entry_t * const *) b)->counter.cycles;
+    return (cycles_a < cycles_b) - (cycles_a > cycles_b);
+}
+
+bool profiler_write_report(gb_instance_t *gb, const char *path)
+{
+    profiler_t *profiler = &gb->profiler;
+
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "# opcode count cycles\n");
+    for (unsigned i = 0; i < 512; ++i){
+        if (profiler->opcodes[i].count == 0) continue;
+        fprintf(file, "%s%02X %llu %llu\n", (i >= 256) ? "CB " : "", i & 0xFF,
+                (unsigned long long) profiler->opcodes[i].count,
+                (unsigned long long) profiler->opcodes[i].cycles);
+    }
+
+    unsigned used = 0;
+    for (uint32_t i = 0; i < PROFILER_PC_ENTRIES; ++i){
+        if (profiler->pcs[i].key != 0) profiler->pc_order[used++] = &profiler->pcs[i];
+    }
+    qsort(profiler->pc_order, used, sizeof(profiler->pc_order[0]), compare_pc_entries);
+
+    fprintf(file, "\n# bank:pc location count cycles (%llu dropped)\n",
+            (unsigned long long) profiler->dropped_pcs);
+    for (unsigned i = 0; i < used; ++i){
+        const profiler_pc_entry_t *entry = profiler->pc_order[i];
+        uint32_t key = entry->key - 1;
+        char location[PROFILER_SYMBOL_LEN + 16];
+
+        format_location(profiler, key, location, sizeof(location));
+        fprintf(file, "%02X:%04X %s %llu %llu\n", PROFILER_KEY_BANK(key), PROFILER_KEY_ADDR(key), location,
+                (unsigned long long) entry->counter.count,
+                (unsigned long long) entry->counter.cycles);
+    }
+
+    return fclose(file) == 0;
+}
+
+bool profiler_write_folded(gb_instance_t *gb, const char *path)
+{
+    const profiler_t *profiler = &gb->profiler;
+
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    for (unsigned i = 0; i < profiler->nodes_size; ++i){
+        const profiler_node_t *node = &profiler->nodes[i];
+        int stack[PROFILER_MAX_DEPTH + 1];
+        unsigned depth = 0;
+
+        if (node->cycles == 0) continue;
+
+        for (int n = (int) i; n != PROFILER_NO_NODE; n = profiler->nodes[n].parent){
+            stack[depth++] = n;
+        }
+
+        /* Root first */
+        fprintf(file, "root");
+        for (unsigned d = depth - 1; d-- > 0;){
+            char location[PROFILER_SYMBOL_LEN + 16];
+            format_location(profiler, profiler->nodes[stack[d]].key, location, sizeof(location));
+            fprintf(file, ";%s", location);
+        }
+        fprintf(file, " %llu\n", (unsigned long long) node->cycles);
+    }
+
+    return fclose(file) == 0;
+}
+
+#endif // CPU_PROFILER
@@ -0,0 +1,230 @@
+#include <core/tracer.h>
+
+#if CPU_TRACER
+
+#include <gb_instance.h>
+#include <core/cpu.h>
+#include <core/bus.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACER_RING_MASK            (TRACER_RING_SIZE - 1)
+
+/* Writer sleep when the ring is empty */
+#define TRACER_WRITER_IDLE_NS       1000000
+
+/**
+ *  Copies `size` bytes into the ring, waiting for the writer if it's full.
+ */
+static void ring_push(tracer_t *tracer, const uint8_t *data, uint32_t size)
+{
+    uint32_t head = atomic_load_explicit(&tracer->head, memory_order_relaxed);
+
+    while (TRACER_RING_SIZE - (head - atomic_load_explicit(&tracer->tail, memory_order_acquire)) < size){
+        sched_yield();
+    }
+
+    uint32_t offset = head & TRACER_RING_MASK;
+    uint32_t first = TRACER_RING_SIZE - offset;
+    if (first > size) first = size;
+
+    memcpy(&tracer->ring[offset], data, first);
+    memcpy(tracer->ring, data + first, size - first);
+
+    atomic_store_explicit(&tracer->head, head + size, memory_order_release);
+}
+
+static void *writer_main(void *arg)
+{
+    tracer_t *tracer = (tracer_t *) arg;
+    uint32_t tail = atomic_load_explicit(&tracer->tail, memory_order_relaxed);
+
+    while (true){
+        /* Stopping is read first, so the head read after it has every record */
+        bool stopping = atomic_load_explicit(&tracer->stopping, memory_order_acquire);
+        uint32_t head = atomic_load_explicit(&tracer->head, memory_order_acquire);
+
+        if (head == tail){
+            if (stopping) break;
+
+            struct timespec idle = { .tv_sec = 0, .tv_nsec = TRACER_WRITER_IDLE_NS };
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        /* Up to the end of the ring, the wrapped part goes next round */
+        uint32_t offset = tail & TRACER_RING_MASK;
+        uint32_t size = head - tail;
+        if (size > TRACER_RING_SIZE - offset) size = TRACER_RING_SIZE - offset;
+
+        if (!tracer->write_error && fwrite(&tracer->ring[offset], 1, size, tracer->file) != size){
+            tracer->write_error = true;
+        }
+
+        tail += size;
+        atomic_store_explicit(&tracer->tail, tail, memory_order_release);
+    }
+
+    return NULL;
+}
+
+/**
+ *  Pushes the record of the last instruction to the ring.
+ */
+static void commit_record(tracer_t *tracer)
+{
+    if (!tracer->has_record) return;
+
+    if (tracer->access_count > 0){
+        tracer->header[1] |= TRACER_REC_ACCESSES;
+        tracer->accesses[0] = (uint8_t) tracer->access_count;
+        ring_push(tracer, tracer->header, tracer->header_size);
+        ring_push(tracer, tracer->accesses, 1 + tracer->access_count * TRACER_ACCESS_SIZE);
+    } else {
+        ring_push(tracer, tracer->header, tracer->header_size);
+    }
+
+    tracer->has_record = false;
+}
+
+bool tracer_start(gb_instance_t *gb, const char *path)
+{
+    tracer_t *tracer = &gb->tracer;
+
+    if (tracer->started) return false;
+
+    tracer->file = fopen(path, "wb");
+    if (tracer->file == NULL) return false;
+
+    static const uint8_t file_header[] = { 'G', 'B', 'T', 'R', TRACER_VERSION };
+    if (fwrite(file_header, 1, sizeof(file_header), tracer->file) != sizeof(file_header)){
+        fclose(tracer->file);
+        return false;
+    }
+
+    atomic_store(&tracer->head, 0);
+    atomic_store(&tracer->tail, 0);
+    atomic_store(&tracer->stopping, false);
+    tracer->write_error = false;
+    tracer->has_record = false;
+    tracer->has_prev = false;
+    tracer->dropped_accesses = 0;
+    memset(tracer->shadow, 0, sizeof(tracer->shadow));
+
+    if (pthread_create(&tracer->writer, NULL, writer_main, tracer) != 0){
+        fclose(tracer->file);
+        return false;
+    }
+
+    tracer->started = true;
+    return true;
+}
+
+bool tracer_stop(gb_instance_t *gb)
+{
+    tracer_t *tracer = &gb->tracer;
+
+    if (!tracer->started) return false;
+
+    commit_record(tracer);
+    atomic_store_explicit(&tracer->stopping, true, memory_order_release);
+    pthread_join(tracer->writer, NULL);
+    tracer->started = false;
+
+    bool ok = !tracer->write_error;
+    return (fclose(tracer->file) == 0) && ok;
+}
+
+void tracer_on_instr(gb_instance_t *gb)
+{
+    tracer_t *tracer = &gb->tracer;
+    cpu_context_t *context = &gb->cpu;
+
+    if (!tracer->started) return;
+
+    commit_record(tracer);
+    cpu_flags_sync(context);
+
+    const uint8_t regs[8] = {
+        context->af.hi, context->af.lo,
+        context->bc.hi, context->bc.lo,
+        context->de.hi, context->de.lo,
+        context->hl.hi, context->hl.lo,
+    };
+    uint8_t *out = &tracer->header[2];
+    uint8_t regs_mask = 0;
+    uint8_t flags = 0;
+
+    for (unsigned i = 0; i < 8; ++i){
+        if (!tracer->has_prev || regs[i] != tracer->regs[i]){
+            regs_mask |= (uint8_t) (1u << i);
+            *out++ = regs[i];
+        }
+    }
+    memcpy(tracer->regs, regs, sizeof(regs));
+
+    if (!tracer->has_prev || context->sp != tracer->sp){
+        flags |= TRACER_REC_SP;
+        *out++ = (uint8_t) context->sp;
+        *out++ = (uint8_t) (context->sp >> 8);
+    }
+    tracer->sp = context->sp;
+
+    /* Mostly a few bytes forward, taken jumps are the exception */
+    int pc_delta = (int) context->pc - (int) tracer->pc;
+    if (!tracer->has_prev || pc_delta < INT8_MIN || pc_delta > INT8_MAX){
+        flags |= TRACER_REC_PC_FULL;
+        *out++ = (uint8_t) context->pc;
+        *out++ = (uint8_t) (context->pc >> 8);
+    } else if (pc_delta != 0){
+        flags |= TRACER_REC_PC_DELTA;
+        *out++ = (uint8_t) (int8_t) pc_delta;
+    }
+    tracer->pc = context->pc;
+
+    /* Code runs from the same addresses over and over, only changes are logged */
+    for (unsigned i = 0; i < 4; ++i){
+        addr_t addr = (addr_t) (context->pc + i);
+        uint8_t value = bus_read(gb, addr);
+
+        if (!tracer->has_prev || value != tracer->shadow[addr]){
+            flags |= (uint8_t) (1u << (TRACER_REC_PCMEM_SHIFT + i));
+            *out++ = value;
+            tracer->shadow[addr] = value;
+        }
+    }
+
+    tracer->header[0] = regs_mask;
+    tracer->header[1] = flags;
+    tracer->header_size = (unsigned) (out - tracer->header);
+    tracer->access_count = 0;
+    tracer->has_record = true;
+    tracer->has_prev = true;
+}
+
+void tracer_on_access(gb_instance_t *gb, addr_t addr, uint8_t value, uint8_t kind)
+{
+    tracer_t *tracer = &gb->tracer;
+
+    if (!tracer->has_record) return;
+
+    if (tracer->access_count == TRACER_MAX_ACCESSES){
+        tracer->dropped_accesses++;
+        return;
+    }
+
+    uint8_t *out = &tracer->accesses[1 + tracer->access_count * TRACER_ACCESS_SIZE];
+    out[0] = kind;
+    out[1] = (uint8_t) addr;
+    out[2] = (uint8_t) (addr >> 8);
+    out[3] = value;
+    tracer->access_count++;
+}
+
+uint64_t tracer_get_dropped_accesses(gb_instance_t *gb)
+{
+    return gb->tracer.dropped_accesses;
+}
+
+#endif // CPU_TRACER
@@ -1,15 +1,30 @@
 #include <core/interrupt.h>
+#include <gb_instance.h>
 #include <master_slave.h>
 #include <emu_error.h>
 
-typedef struct interrupt_context {
-    uint8_t ie_reg;
-    uint8_t if_reg;
-    master_slave_conn_t interrupt_ie_ms_conn;
-    master_slave_conn_t interrupt_if_ms_conn;
-} interrupt_context_t;
+static const addr_t interrupt_vector_addrs[INTERRUPT_TYPE_COUNT] = {
+    [INTERRUPT_TYPE_VBLANK]         = 0x40,
+    [INTERRUPT_TYPE_STAT]           = 0x48,
+    [INTERRUPT_TYPE_TIMER]          = 0x50,
+    [INTERRUPT_TYPE_SERIAL]         = 0x58,
+    [INTERRUPT_TYPE_JOYPAD]         = 0x60,
+    [INTERRUPT_TYPE_UNKNOWN]        = 0x0,
+    [INTERRUPT_TYPE_NONE]           = 0x0
+};
 
-static interrupt_context_t interrupt_context;
+/**
+ *  Recomputes the pending words, after any change of IE, IF or IME.
+ *  A serviceable interrupt ends the running batch or block.
+ */
+static inline void update_pending(gb_instance_t *gb)
+{
+    interrupt_context_t *int_ctx = &gb->interrupt;
+
+    int_ctx->pending = int_ctx->ie_reg & int_ctx->if_reg & INTERRUPT_REG_ALL_BITMASK;
+    int_ctx->serviceable = int_ctx->ime ? int_ctx->pending : 0;
+    if (int_ctx->serviceable) gb->cpu.deadline = 0;
+}
 
 /**  
  *  Function callbacks for interrupt register bus connections.
@@ -19,16 +34,17 @@ static error_code_t ie_read(void *context, addr_t addr, uint8_t *read_val)
     assert(addr == 0xFFFF);
     assert(read_val != NULL);
 
-    interrupt_context_t *int_ctx = (interrupt_context_t *) context;
-    *read_val = int_ctx->ie_reg;  
+    gb_instance_t *gb = (gb_instance_t *) context;
+    *read_val = gb->interrupt.ie_reg;
     return STATUS_OK;
 }
 
 static error_code_t ie_write(void *context, addr_t addr, uint8_t value)
 {
     assert(addr == 0xFFFF);
-    interrupt_context_t *int_ctx = (interrupt_context_t *) context;
-    int_ctx->ie_reg = value;  
+    gb_instance_t *gb = (gb_instance_t *) context;
+    gb->interrupt.ie_reg = value;
+    update_pending(gb);
     return STATUS_OK;
 }
 
@@ -38,16 +54,17 @@ static error_code_t if_read(void *context, addr_t addr, uint8_t *read_val)
     assert(addr == 0xFF0F);
     assert(read_val != NULL);
 
-    interrupt_context_t *int_ctx = (interrupt_context_t *) context;
-    *read_val = int_ctx->if_reg;  
+    gb_instance_t *gb = (gb_instance_t *) context;
+    *read_val = gb->interrupt.if_reg;
     return STATUS_OK;
 }
 
 static error_code_t if_write(void *context, addr_t addr, uint8_t value)
 {
     assert(addr == 0xFF0F);
-    interrupt_context_t *int_ctx = (interrupt_context_t *) context;
-    int_ctx->if_reg = value;  
+    gb_instance_t *gb = (gb_instance_t *) context;
+    gb->interrupt.if_reg = value;
+    update_pending(gb);
     return STATUS_OK;
 }
 
@@ -55,95 +72,94 @@ static error_code_t if_write(void *context, addr_t addr, uint8_t value)
 /**
  *  Initializes the interrupt module.
  */
-void interrupt_init() {
+void interrupt_init(gb_instance_t *gb) {
     /* Enable all interrupts initially */
-    interrupt_context.ie_reg = 0b00011111u;
+    gb->interrupt.ie_reg = 0b00011111u;
 
     /* IF is still 0, since this is reserved for device. */
-    interrupt_context.if_reg = 0x0u;
-    interrupt_context.interrupt_ie_ms_conn = (master_slave_conn_t) {
+    gb->interrupt.if_reg = 0x0u;
+    gb->interrupt.ime = 0;
+    update_pending(gb);
+    gb->interrupt.interrupt_ie_ms_conn = (master_slave_conn_t) {
         .start_addr = (addr_t) 0xFFFFu, 
         .end_addr = (addr_t) 0xFFFFu,   
-        .slave_context = (void *) &interrupt_context,
+        .slave_context = (void *) gb,
         .slave_read = ie_read,
         .slave_write = ie_write
     };
 
-    interrupt_context.interrupt_if_ms_conn = (master_slave_conn_t) {
+    gb->interrupt.interrupt_if_ms_conn = (master_slave_conn_t) {
         .start_addr = (addr_t) 0xFF0Fu, 
         .end_addr = (addr_t) 0xFF0Fu,   
-        .slave_context = (void *) &interrupt_context,
+        .slave_context = (void *) gb,
         .slave_read = if_read,
         .slave_write = if_write
     };
 }
 
-void interrupt_set_flag(interrupt_type_t interrupt_type)
+void interrupt_set_flag(gb_instance_t *gb, interrupt_type_t interrupt_type)
 {
-    switch (interrupt_type)
-    {
-        case INTERRUPT_TYPE_VBLANK:
-            interrupt_context.if_reg |= INTERRUPT_REG_VBLANK_BITMASK;
-            break;
-
-        case INTERRUPT_TYPE_JOYPAD:
-            interrupt_context.if_reg |= INTERRUPT_REG_JOYPAD_BITMASK;
-            break;
-
-        case INTERRUPT_TYPE_TIMER:
-            interrupt_context.if_reg |= INTERRUPT_REG_TIMER_BITMASK;
-            break;
-        
-        case INTERRUPT_TYPE_SERIAL:
-            interrupt_context.if_reg |= INTERRUPT_REG_SERIAL_BITMASK;
-            break;
-        
-        default:
-            break;
-    }    
+    /* UNKNOWN/NONE have no flag */
+    if (interrupt_type >= INTERRUPT_TYPE_UNKNOWN) return;
+
+    gb->interrupt.if_reg |= (uint8_t) (1u << interrupt_type);
+    update_pending(gb);
 }
 
-void interrupt_clear_flag(interrupt_type_t interrupt_type)
+void interrupt_clear_flag(gb_instance_t *gb, interrupt_type_t interrupt_type)
 {
-    switch (interrupt_type)
-    {
-        case INTERRUPT_TYPE_VBLANK:
-            interrupt_context.if_reg &= ~INTERRUPT_REG_VBLANK_BITMASK;
-            break;
-
-        case INTERRUPT_TYPE_JOYPAD:
-            interrupt_context.if_reg &= ~INTERRUPT_REG_JOYPAD_BITMASK;
-            break;
-
-        case INTERRUPT_TYPE_TIMER:
-            interrupt_context.if_reg &= ~INTERRUPT_REG_TIMER_BITMASK;
-            break;
-        
-        case INTERRUPT_TYPE_SERIAL:
-            interrupt_context.if_reg &= ~INTERRUPT_REG_SERIAL_BITMASK;
-            break;
-        
-        default:
-            break;
-    }    
+    if (interrupt_type >= INTERRUPT_TYPE_UNKNOWN) return;
+
+    gb->interrupt.if_reg &= (uint8_t) ~(1u << interrupt_type);
+    update_pending(gb);
 }
 
 /**
  *  Get the top priority interrupt to service.
  *  The top priority interrupt is the enabled interrupt that has
- *  the lowest bit position
+ *  the lowest bit position. NONE while IME is cleared.
  */
-interrupt_type_t interrupt_get_top(uint8_t ime)
+interrupt_type_t interrupt_get_top(gb_instance_t *gb)
+{
+    uint8_t interrupt_vals = gb->interrupt.serviceable;
+
+    if (interrupt_vals == 0) return INTERRUPT_TYPE_NONE;
+
+    /* Bit position is the interrupt type, lowest bit first */
+#if defined(__GNUC__)
+    return (interrupt_type_t) __builtin_ctz(interrupt_vals);
+#else
+    unsigned type = 0;
+    while (!(interrupt_vals & 1u)){
+        interrupt_vals >>= 1;
+        type++;
+    }
+    return (interrupt_type_t) type;
+#endif
+}
+
+void interrupt_save_state(gb_instance_t *gb, interrupt_state_t *state)
+{
+    state->ie_reg = gb->interrupt.ie_reg;
+    state->if_reg = gb->interrupt.if_reg;
+}
+
+void interrupt_load_state(gb_instance_t *gb, const interrupt_state_t *state)
+{
+    gb->interrupt.ie_reg = state->ie_reg;
+    gb->interrupt.if_reg = state->if_reg;
+    update_pending(gb);
+}
+
+void interrupt_set_ime(gb_instance_t *gb, uint8_t ime)
+{
+    gb->interrupt.ime = ime;
+    update_pending(gb);
+}
+
+uint8_t interrupt_get_pending(gb_instance_t *gb)
 {
-    uint8_t interrupt_vals = ime ? (interrupt_context.ie_reg & interrupt_context.if_reg) : 0;
-    
-    /* Eat bits one by one, in the bit order */
-    if (interrupt_vals & INTERRUPT_REG_VBLANK_BITMASK) return INTERRUPT_TYPE_VBLANK;
-    if (interrupt_vals & INTERRUPT_REG_TIMER_BITMASK) return INTERRUPT_TYPE_TIMER;
-    if (interrupt_vals & INTERRUPT_REG_SERIAL_BITMASK) return INTERRUPT_TYPE_SERIAL;
-    if (interrupt_vals & INTERRUPT_REG_JOYPAD_BITMASK) return INTERRUPT_TYPE_JOYPAD;
-    
-    return INTERRUPT_TYPE_NONE;
+    return gb->interrupt.pending;
 }
 
 /**
@@ -155,9 +171,9 @@ addr_t interrupt_get_vector_addr(interrupt_type_t interrupt_type)
     return interrupt_vector_addrs[interrupt_type];
 }
 
-master_slave_conn_t *interrupt_get_ie_ms_connection()
+master_slave_conn_t *interrupt_get_ie_ms_connection(gb_instance_t *gb)
 {
-    master_slave_conn_t *res = &(interrupt_context.interrupt_ie_ms_conn);
+    master_slave_conn_t *res = &(gb->interrupt.interrupt_ie_ms_conn);
     assert(res->slave_context != NULL);
     assert(res->slave_read != NULL);
     assert(res->slave_write != NULL);
@@ -165,9 +181,9 @@ master_slave_conn_t *interrupt_get_ie_ms_connection()
     return res;
 }
 
-master_slave_conn_t *interrupt_get_if_ms_connection()
+master_slave_conn_t *interrupt_get_if_ms_connection(gb_instance_t *gb)
 {
-    master_slave_conn_t *res = &(interrupt_context.interrupt_if_ms_conn);
+    master_slave_conn_t *res = &(gb->interrupt.interrupt_if_ms_conn);
     assert(res->slave_context != NULL);
     assert(res->slave_read != NULL);
     assert(res->slave_write != NULL);
@@ -0,0 +1,78 @@
+#include <core/memory.h>
+#include <gb_instance.h>
+#include <emu_error.h>
+#include <string.h>
+
+/**
+ *  Initializes the internal memory module.
+ */
+void memory_init(gb_instance_t *gb)
+{
+    memory_context_t *memory_ctx = &gb->memory;
+
+    memory_ctx->ms_conns[MEMORY_REGION_WRAM] = (master_slave_conn_t) {
+        .start_addr = (addr_t) WRAM1_BASE,
+        .end_addr = (addr_t) WRAM2_END,
+        .direct_read = memory_ctx->wram,
+        .direct_write = memory_ctx->wram
+    };
+
+    /* Echo RAM mirrors the start of WRAM */
+    memory_ctx->ms_conns[MEMORY_REGION_ECHO] = (master_slave_conn_t) {
+        .start_addr = (addr_t) ECHO_RAM_BASE,
+        .end_addr = (addr_t) ECHO_RAM_END,
+        .direct_read = memory_ctx->wram,
+        .direct_write = memory_ctx->wram
+    };
+
+    memory_ctx->ms_conns[MEMORY_REGION_VRAM] = (master_slave_conn_t) {
+        .start_addr = (addr_t) VRAM_BASE,
+        .end_addr = (addr_t) VRAM_END,
+        .direct_read = memory_ctx->vram,
+        .direct_write = memory_ctx->vram
+    };
+
+    memory_ctx->ms_conns[MEMORY_REGION_OAM] = (master_slave_conn_t) {
+        .start_addr = (addr_t) OAM_BASE,
+        .end_addr = (addr_t) OAM_END,
+        .direct_read = memory_ctx->oam,
+        .direct_write = memory_ctx->oam
+    };
+
+    memory_ctx->ms_conns[MEMORY_REGION_HRAM] = (master_slave_conn_t) {
+        .start_addr = (addr_t) HIGH_RAM_BASE,
+        .end_addr = (addr_t) HIGH_RAM_END,
+        .direct_read = memory_ctx->hram,
+        .direct_write = memory_ctx->hram
+    };
+}
+
+void memory_save_state(gb_instance_t *gb, memory_state_t *state)
+{
+    const memory_context_t *memory_ctx = &gb->memory;
+
+    memcpy(state->wram, memory_ctx->wram, WRAM_SIZE);
+    memcpy(state->vram, memory_ctx->vram, VRAM_SIZE);
+    memcpy(state->oam, memory_ctx->oam, OAM_SIZE);
+    memcpy(state->hram, memory_ctx->hram, HRAM_SIZE);
+}
+
+void memory_load_state(gb_instance_t *gb, const memory_state_t *state)
+{
+    memory_context_t *memory_ctx = &gb->memory;
+
+    memcpy(memory_ctx->wram, state->wram, WRAM_SIZE);
+    memcpy(memory_ctx->vram, state->vram, VRAM_SIZE);
+    memcpy(memory_ctx->oam, state->oam, OAM_SIZE);
+    memcpy(memory_ctx->hram, state->hram, HRAM_SIZE);
+}
+
+master_slave_conn_t *memory_get_ms_connection(gb_instance_t *gb, memory_region_t region)
+{
+    assert(region < MEMORY_REGION_COUNT);
+    master_slave_conn_t *res = &(gb->memory.ms_conns[region]);
+    assert(res->direct_read != NULL);
+    assert(res->direct_write != NULL);
+
+    return res;
+}
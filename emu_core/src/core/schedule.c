@@ -1,27 +1,47 @@
-
 #include <schedule.h>
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+#include <gb_instance.h>
+
+/**
+ *  Comparator of the event heap. Later events are "smaller",
+ *  which turns the max-heap into a min-heap on timestamps.
+ */
+static bool event_later(device_event_t e1, device_event_t e2)
+{
+    return e1.timestamp > e2.timestamp;
+}
+
+void schedule_init(gb_instance_t *gb)
+{
+    /* Points into the instance, see `gb_instance.h` about copies */
+    gb->schedule.queue = device_event_t_spqueue_create(MAX_DEVICE_NUMBER, gb->schedule.events, event_later);
+}
+
+error_code_t execute_next_event(gb_instance_t *gb)
+{
+    if (device_event_t_spqueue_is_empty(&gb->schedule.queue)){
+        return STATUS_EMPTY_CONTAINER;
+    }
+
+    device_event_t event = device_event_t_spqueue_pop(&gb->schedule.queue);
+    return event.exec_event(gb);
+}
+
+void schedule_next_event(gb_instance_t *gb, device_event_t event)
+{
+    assert(event.exec_event != NULL);
+    device_event_t_spqueue_push(&gb->schedule.queue, event);
+
+    /* Scheduled by an instruction, the running batch or block stops before it */
+    if (event.timestamp < gb->cpu.deadline){
+        gb->cpu.deadline = event.timestamp;
+    }
+}
+
+uint64_t schedule_next_timestamp(gb_instance_t *gb)
+{
+    if (device_event_t_spqueue_is_empty(&gb->schedule.queue)){
+        return SCHEDULE_NO_EVENT;
+    }
+
+    return device_event_t_spqueue_front(&gb->schedule.queue).timestamp;
+}
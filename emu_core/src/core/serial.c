@@ -0,0 +1,148 @@
+#include <core/serial.h>
+#include <gb_instance.h>
+#include <core/interrupt.h>
+#include <core/cpu.h>
+#include <schedule.h>
+#include <emu_error.h>
+
+/* Unused SC bits read as 1 */
+#define SERIAL_SC_UNUSED_BITS       0x7E
+
+static error_code_t serial_transfer_done(gb_instance_t *gb);
+
+/**
+ *  Schedules the end of the transfer in flight, unless an event is already
+ *  queued: that one fires first and moves on to `transfer_end`. Toggling SC
+ *  can then never fill the event queue.
+ */
+static void serial_schedule_end(gb_instance_t *gb)
+{
+    serial_context_t *serial_ctx = &gb->serial;
+    if (serial_ctx->event_pending) return;
+
+    serial_ctx->event_pending = true;
+    schedule_next_event(gb, (device_event_t) {
+        .timestamp = serial_ctx->transfer_end,
+        .exec_event = serial_transfer_done
+    });
+}
+
+/**
+ *  End of a transfer: the byte is out, 0xFF came in from the empty link.
+ */
+static error_code_t serial_transfer_done(gb_instance_t *gb)
+{
+    serial_context_t *serial_ctx = &gb->serial;
+    serial_ctx->event_pending = false;
+
+    /* The transfer was stopped since */
+    if (serial_ctx->transfer_end == 0) return STATUS_OK;
+
+    /* Stopped and restarted since: the event moves to the new end */
+    if (cpu_get_cycles(gb) < serial_ctx->transfer_end){
+        serial_schedule_end(gb);
+        return STATUS_OK;
+    }
+
+    if (serial_ctx->output_hook != NULL){
+        serial_ctx->output_hook(gb, serial_ctx->sb);
+    }
+
+    serial_ctx->sb = 0xFF;
+    serial_ctx->sc &= (uint8_t) ~SERIAL_SC_TRANSFER;
+    serial_ctx->transfer_end = 0;
+    interrupt_set_flag(gb, INTERRUPT_TYPE_SERIAL);
+    return STATUS_OK;
+}
+
+static error_code_t serial_read(void *context, addr_t addr, uint8_t *read_val)
+{
+    assert(addr == SERIAL_SB_ADDR || addr == SERIAL_SC_ADDR);
+    assert(read_val != NULL);
+
+    serial_context_t *serial_ctx = &((gb_instance_t *) context)->serial;
+    *read_val = (addr == SERIAL_SB_ADDR) ? serial_ctx->sb : (serial_ctx->sc | SERIAL_SC_UNUSED_BITS);
+    return STATUS_OK;
+}
+
+static error_code_t serial_write(void *context, addr_t addr, uint8_t value)
+{
+    assert(addr == SERIAL_SB_ADDR || addr == SERIAL_SC_ADDR);
+    gb_instance_t *gb = (gb_instance_t *) context;
+    serial_context_t *serial_ctx = &gb->serial;
+
+    if (addr == SERIAL_SB_ADDR){
+        serial_ctx->sb = value;
+        return STATUS_OK;
+    }
+
+    bool was_transferring = serial_ctx->sc & SERIAL_SC_TRANSFER;
+    serial_ctx->sc = value & (SERIAL_SC_TRANSFER | SERIAL_SC_INTERNAL_CLOCK);
+
+    /* Stopped, its pending event is now stale */
+    if (!(serial_ctx->sc & SERIAL_SC_TRANSFER)){
+        serial_ctx->transfer_end = 0;
+    }
+
+    /* With an external clock nothing ever clocks the bits in */
+    if (!was_transferring && (value & SERIAL_SC_TRANSFER) && (value & SERIAL_SC_INTERNAL_CLOCK)){
+        serial_ctx->transfer_end = cpu_get_cycles(gb) + SERIAL_TRANSFER_CYCLES;
+        serial_schedule_end(gb);
+    }
+    return STATUS_OK;
+}
+
+/**
+ *  Initializes the serial module.
+ */
+void serial_init(gb_instance_t *gb)
+{
+    gb->serial.sb = 0x00;
+    gb->serial.sc = 0x00;
+    gb->serial.transfer_end = 0;
+    gb->serial.event_pending = false;
+    gb->serial.serial_ms_conn = (master_slave_conn_t) {
+        .start_addr = (addr_t) SERIAL_SB_ADDR,
+        .end_addr = (addr_t) SERIAL_SC_ADDR,
+        .slave_context = (void *) gb,
+        .slave_read = serial_read,
+        .slave_write = serial_write
+    };
+}
+
+void serial_save_state(gb_instance_t *gb, serial_state_t *state)
+{
+    *state = (serial_state_t) {
+        .transfer_end = gb->serial.transfer_end,
+        .sb = gb->serial.sb,
+        .sc = gb->serial.sc,
+    };
+}
+
+void serial_load_state(gb_instance_t *gb, const serial_state_t *state)
+{
+    gb->serial.sb = state->sb;
+    gb->serial.sc = state->sc;
+    gb->serial.transfer_end = state->transfer_end;
+
+    /* The queue was emptied, along with the event of the saving instance */
+    gb->serial.event_pending = false;
+    if (state->transfer_end != 0){
+        serial_schedule_end(gb);
+    }
+}
+
+void serial_set_output_hook(gb_instance_t *gb, serial_output_hook_t hook)
+{
+    gb->serial.output_hook = hook;
+}
+
+master_slave_conn_t *serial_get_ms_connection(gb_instance_t *gb)
+{
+    master_slave_conn_t *res = &(gb->serial.serial_ms_conn);
+    assert(res->slave_context != NULL);
+    assert(res->slave_read != NULL);
+    assert(res->slave_write != NULL);
+
+    return res;
+}
@@ -1,45 +1,231 @@
 #include <common.h>
+#include <emulator.h>
+#include <gb_instance.h>
+#include <rewind.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/memory.h>
+#include <core/interrupt.h>
+#include <core/serial.h>
+#include <core/cartridge/cart.h>
+#include <schedule.h>
+#include <platform/error_handling.h>
+#include <stdlib.h>
+#include <string.h>
 
-typedef struct emulator_context
-{
-    uint64_t
-} emulator_context_t;
 
 
 
+/* Logo in the cartridge header, and where the boot ROM draws it */
+#define BOOT_LOGO_ADDR              0x0104
+#define BOOT_LOGO_SIZE              48
+#define BOOT_LOGO_TILES_ADDR        0x8010
+#define BOOT_TRADEMARK_TILE_ADDR    0x8190
+#define BOOT_LOGO_MAP_ROW0          0x9904
+#define BOOT_LOGO_MAP_ROW1          0x9924
+#define BOOT_TRADEMARK_MAP_ADDR     0x9910
+#define BOOT_LOGO_MAP_WIDTH         12
+
+/* (R) tile of the boot ROM, one bit plane */
+static const uint8_t boot_trademark_tile[8] = {
+    0x3C, 0x42, 0xB9, 0xA5, 0xB9, 0xA5, 0x42, 0x3C
+};
+
+gb_instance_t *emulator_create()
+{
+    /* aligned_alloc wants a multiple of the alignment */
+    size_t size = (sizeof(gb_instance_t) + GB_CACHE_LINE_SIZE - 1) / GB_CACHE_LINE_SIZE * GB_CACHE_LINE_SIZE;
+    gb_instance_t *gb = aligned_alloc(GB_CACHE_LINE_SIZE, size);
+
+    if (gb != NULL) memset(gb, 0, size);
+    return gb;
+}
 
-static uint64_t global_tick;
+void emulator_destroy(gb_instance_t *gb)
+{
+    if (gb == NULL) return;
+    free(gb);
+}
 
 /**
  *  Initializes the emulator
  */
-static void emulator_init()
+void emulator_init(gb_instance_t *gb, uint8_t *rom, size_t rom_size)
 {   
-    global_tick = 0;
+    gb->global_tick = 0;
+    schedule_init(gb);
 
     /* Initialize devices tick and state */
+    cart_init(gb, rom, rom_size);
+    memory_init(gb);
+    interrupt_init(gb);
+    serial_init(gb);
+
+    /* Hook every device to the bus, then build the dispatch table */
+    master_slave_conn_t *bus_conns[] = {
+        cart_get_rom0_ms_connection(gb),
+        cart_get_romx_ms_connection(gb),
+        memory_get_ms_connection(gb, MEMORY_REGION_VRAM),
+        memory_get_ms_connection(gb, MEMORY_REGION_WRAM),
+        memory_get_ms_connection(gb, MEMORY_REGION_ECHO),
+        memory_get_ms_connection(gb, MEMORY_REGION_OAM),
+        memory_get_ms_connection(gb, MEMORY_REGION_HRAM),
+        interrupt_get_if_ms_connection(gb),
+        interrupt_get_ie_ms_connection(gb),
+        serial_get_ms_connection(gb),
+    };
+
+    for (unsigned i = 0; i < sizeof(bus_conns) / sizeof(bus_conns[0]); ++i){
+        if (bus_connect(gb, bus_conns[i]) != STATUS_OK){
+            emu_die(STATUS_BUS_CONFLICT, "Overlapping bus connections.");
+        }
+    }
+    bus_init(gb);
+
+    cpu_init(gb);
+    cart_set_bank_switch_hook(gb, cpu_on_bank_switch);
+
+#if REWIND_ENABLED
+    rewind_init(gb, REWIND_INTERVAL_FRAMES);
+#endif
+
+#if EMULATOR_FAST_BOOT
+    emulator_fast_boot(gb);
+#endif
+}
+
+/**
+ *  Doubles every bit of a nibble, as the boot ROM scales the logo up.
+ */
+static uint8_t boot_scale_nibble(uint8_t nibble)
+{
+    uint8_t res = 0;
+    for (unsigned bit = 0; bit < 4; ++bit){
+        if (nibble & (1u << bit)) res |= 3u << (2 * bit);
+    }
+    return res;
+}
+
+/**
+ *  Draws the logo as the boot ROM does: each nibble of the header logo is
+ *  one row of 8 pixels, drawn twice, in the first bit plane of tiles 1-24.
+ *  Tile 25 is the (R), then the map holds tiles 1-12 over 13-24.
+ */
+static void boot_draw_logo(gb_instance_t *gb)
+{
+    addr_t tile_addr = BOOT_LOGO_TILES_ADDR;
+
+    for (addr_t i = 0; i < BOOT_LOGO_SIZE; ++i){
+        uint8_t logo = bus_read(gb, BOOT_LOGO_ADDR + i);
+        uint8_t rows[2] = { boot_scale_nibble(logo >> 4), boot_scale_nibble(logo & 0xF) };
+
+        for (unsigned row = 0; row < 4; ++row, tile_addr += 2){
+            bus_write(gb, tile_addr, rows[row / 2]);
+        }
+    }
+
+    for (unsigned row = 0; row < sizeof(boot_trademark_tile); ++row){
+        bus_write(gb, BOOT_TRADEMARK_TILE_ADDR + 2 * row, boot_trademark_tile[row]);
+    }
+
+    for (unsigned i = 0; i < BOOT_LOGO_MAP_WIDTH; ++i){
+        bus_write(gb, BOOT_LOGO_MAP_ROW0 + i, (uint8_t) (1 + i));
+        bus_write(gb, BOOT_LOGO_MAP_ROW1 + i, (uint8_t) (1 + BOOT_LOGO_MAP_WIDTH + i));
+    }
+    bus_write(gb, BOOT_TRADEMARK_MAP_ADDR, 2 * BOOT_LOGO_MAP_WIDTH + 1);
+}
+
+void emulator_fast_boot(gb_instance_t *gb)
+{
+    /* H and C are left over from the header checksum loop */
+    uint8_t flags = (cart_get_metadata(gb)->header_checksum == 0) ? 0x80 : 0xB0;
+
+    cpu_load_state(gb, &(cpu_state_t) {
+        .cycles = cpu_get_cycles(gb),
+        .af = (uint16_t) (0x0100 | flags),
+        .bc = 0x0013,
+        .de = 0x00D8,
+        .hl = 0x014D,
+        .sp = 0xFFFE,
+        .pc = 0x0100,
+    });
+
+    /* VBlank requested, nothing enabled */
+    interrupt_load_state(gb, &(interrupt_state_t) {
+        .ie_reg = 0x00,
+        .if_reg = 0xE1
+    });
+
+    boot_draw_logo(gb);
+}
+
+
+m_cycle_t emulator_run(gb_instance_t *gb, m_cycle_t cycles)
+{
+    uint64_t end_tick = gb->global_tick + cycles;
+
+    while (gb->global_tick < end_tick){
+        /* Execute every event that is due */
+        while (schedule_next_timestamp(gb) <= gb->global_tick){
+            execute_next_event(gb);
+        }
+
+        /* Stops at the next event by itself */
+        gb->global_tick += cpu_run(gb, end_tick - gb->global_tick);
+    }
+
+    return cycles + (gb->global_tick - end_tick);
 }
 
+m_cycle_t emulator_run_frame(gb_instance_t *gb)
+{
+    m_cycle_t cycles = emulator_run(gb, EMULATOR_FRAME_CYCLES);
+
+#if REWIND_ENABLED
+    rewind_on_frame(gb);
+#endif
+    return cycles;
+}
+
+void emulator_save_state(gb_instance_t *gb, emulator_state_t *state)
+{
+    state->global_tick = gb->global_tick;
+    cpu_save_state(gb, &state->cpu);
+    interrupt_save_state(gb, &state->interrupt);
+    serial_save_state(gb, &state->serial);
+    cart_save_state(gb, &state->cart);
+    memory_save_state(gb, &state->memory);
+}
+
+void emulator_load_state(gb_instance_t *gb, const emulator_state_t *state)
+{
+    gb->global_tick = state->global_tick;
+
+    /* Devices schedule their pending events again */
+    schedule_init(gb);
+
+    /* Memory and banks first, the CPU drops what it decoded from the old ones */
+    memory_load_state(gb, &state->memory);
+    cart_load_state(gb, &state->cart);
+    interrupt_load_state(gb, &state->interrupt);
+    serial_load_state(gb, &state->serial);
+    cpu_load_state(gb, &state->cpu);
+}
 
 /**
  *  Emulator core loop, this is an infinite 
- *  superloop that advances the global tick by 1 
- *  every iteration of the loop.
+ *  superloop that advances the global tick 
+ *  (in M-cycles) along with the CPU.
  * 
  *  This acts as the central scheduling system for 
- *  every device within the gameboy device. 
- * 
+ *  every device within the gameboy device. Device events 
+ *  are executed once the global tick reaches them, and the 
+ *  CPU runs in slices up to the next event.
  */
-static void emulator_loop()
+static void emulator_loop(gb_instance_t *gb)
 {
     while(true) 
     {
-        /* Tick every device in the emulator */
-        
-        global_tick++;
+        emulator_run_frame(gb);
     }
 }
-
-
-
-
@@ -0,0 +1,221 @@
+#include <rewind.h>
+
+#if REWIND_ENABLED
+
+#include <gb_instance.h>
+#include <emulator.h>
+#include <core/cpu.h>
+#include <string.h>
+
+_Static_assert(REWIND_MEMORY_CAP > REWIND_FIXED_SIZE + REWIND_DELTA_MAX_SIZE,
+               "REWIND_MEMORY_CAP can't hold a single delta");
+_Static_assert(REWIND_STATE_SIZE < (1u << 21), "Delta varints are at most 3 bytes");
+
+static inline uint8_t *put_varint(uint8_t *out, uint32_t value)
+{
+    while (value >= 0x80){
+        *out++ = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t) value;
+    return out;
+}
+
+static inline const uint8_t *get_varint(const uint8_t *in, uint32_t *value)
+{
+    uint32_t result = 0;
+    unsigned shift = 0;
+
+    while (*in & 0x80){
+        result |= (uint32_t) (*in++ & 0x7F) << shift;
+        shift += 7;
+    }
+    *value = result | ((uint32_t) *in++ << shift);
+    return in;
+}
+
+/**
+ *  Encodes `a ^ b` into `out`, returns the encoded size.
+ *  Zero runs are skipped 8 bytes at a time.
+ */
+static size_t encode_delta(const uint8_t *a, const uint8_t *b, size_t size, uint8_t *out)
+{
+    uint8_t *start = out;
+    size_t i = 0;
+
+    while (i < size){
+        size_t zero_start = i;
+        while (i + 8 <= size){
+            uint64_t x, y;
+            memcpy(&x, a + i, 8);
+            memcpy(&y, b + i, 8);
+            if (x != y) break;
+            i += 8;
+        }
+        while (i < size && a[i] == b[i]) i++;
+
+        /* Literals run until REWIND_MIN_ZERO_RUN equal bytes, or the end */
+        size_t literal_start = i;
+        size_t equal = 0;
+        while (i < size && equal < REWIND_MIN_ZERO_RUN){
+            equal = (a[i] == b[i]) ? equal + 1 : 0;
+            i++;
+        }
+        if (equal == REWIND_MIN_ZERO_RUN) i -= equal;
+
+        out = put_varint(out, (uint32_t) (literal_start - zero_start));
+        out = put_varint(out, (uint32_t) (i - literal_start));
+        for (size_t j = literal_start; j < i; ++j){
+            *out++ = a[j] ^ b[j];
+        }
+    }
+
+    return (size_t) (out - start);
+}
+
+/**
+ *  XORs an encoded delta into `state`.
+ */
+static void apply_delta(uint8_t *state, size_t size, const uint8_t *delta)
+{
+    size_t i = 0;
+
+    while (i < size){
+        uint32_t zeros, literals;
+        delta = get_varint(delta, &zeros);
+        delta = get_varint(delta, &literals);
+
+        i += zeros;
+        assert(i + literals <= size);
+        for (uint32_t j = 0; j < literals; ++j){
+            state[i++] ^= *delta++;
+        }
+    }
+}
+
+static void drop_oldest(rewind_context_t *ctx)
+{
+    ctx->delta_bytes -= ctx->entries[ctx->first].size;
+    ctx->first = (ctx->first + 1) % REWIND_MAX_SNAPSHOTS;
+    ctx->count--;
+    if (ctx->count == 0) ctx->ring_end = 0;
+}
+
+/**
+ *  Finds room for `size` bytes after the newest delta, dropping the
+ *  oldest ones in the way. Returns the offset in the ring.
+ */
+static uint32_t ring_alloc(rewind_context_t *ctx, uint32_t size)
+{
+    if (ctx->count == REWIND_MAX_SNAPSHOTS) drop_oldest(ctx);
+
+    while (ctx->count > 0){
+        uint32_t oldest = ctx->entries[ctx->first].offset;
+
+        if (oldest >= ctx->ring_end){
+            /* Deltas wrapped around, the free space is up to the oldest */
+            if (ctx->ring_end + size <= oldest) return ctx->ring_end;
+        } else {
+            /* Free space at the end, or at the start up to the oldest */
+            if (ctx->ring_end + size <= REWIND_RING_SIZE) return ctx->ring_end;
+            if (size <= oldest) return 0;
+        }
+        drop_oldest(ctx);
+    }
+
+    return 0;
+}
+
+void rewind_init(gb_instance_t *gb, unsigned interval_frames)
+{
+    rewind_context_t *ctx = &gb->rewind;
+
+    ctx->head = &ctx->states[0];
+    ctx->scratch = &ctx->states[1];
+    ctx->head_valid = false;
+    ctx->interval_frames = interval_frames ? interval_frames : 1;
+    ctx->frame_count = 0;
+    ctx->first = 0;
+    ctx->count = 0;
+    ctx->ring_end = 0;
+    ctx->delta_bytes = 0;
+}
+
+void rewind_capture(gb_instance_t *gb)
+{
+    rewind_context_t *ctx = &gb->rewind;
+
+    emulator_save_state(gb, ctx->scratch);
+
+    if (ctx->head_valid){
+        size_t size = encode_delta((const uint8_t *) ctx->head, (const uint8_t *) ctx->scratch,
+                                   REWIND_STATE_SIZE, ctx->encoded);
+        uint32_t offset = ring_alloc(ctx, (uint32_t) size);
+
+        memcpy(&ctx->ring[offset], ctx->encoded, size);
+        ctx->entries[(ctx->first + ctx->count) % REWIND_MAX_SNAPSHOTS] = (rewind_entry_t) {
+            .offset = offset,
+            .size = (uint32_t) size
+        };
+        ctx->count++;
+        ctx->ring_end = offset + (uint32_t) size;
+        ctx->delta_bytes += size;
+    }
+
+    emulator_state_t *prev_head = ctx->head;
+    ctx->head = ctx->scratch;
+    ctx->scratch = prev_head;
+    ctx->head_valid = true;
+}
+
+void rewind_on_frame(gb_instance_t *gb)
+{
+    rewind_context_t *ctx = &gb->rewind;
+
+    if (++ctx->frame_count < ctx->interval_frames) return;
+
+    ctx->frame_count = 0;
+    rewind_capture(gb);
+}
+
+error_code_t rewind_step_back(gb_instance_t *gb)
+{
+    rewind_context_t *ctx = &gb->rewind;
+
+    if (!ctx->head_valid) return STATUS_EMPTY_CONTAINER;
+
+    /* Ran past the newest snapshot, go back to it first */
+    if (cpu_get_cycles(gb) != ctx->head->cpu.cycles){
+        emulator_load_state(gb, ctx->head);
+        ctx->frame_count = 0;
+        return STATUS_OK;
+    }
+
+    if (ctx->count == 0) return STATUS_EMPTY_CONTAINER;
+
+    unsigned newest = (ctx->first + ctx->count - 1) % REWIND_MAX_SNAPSHOTS;
+    apply_delta((uint8_t *) ctx->head, REWIND_STATE_SIZE, &ctx->ring[ctx->entries[newest].offset]);
+
+    ctx->delta_bytes -= ctx->entries[newest].size;
+    ctx->count--;
+    if (ctx->count > 0){
+        const rewind_entry_t *entry = &ctx->entries[(ctx->first + ctx->count - 1) % REWIND_MAX_SNAPSHOTS];
+        ctx->ring_end = entry->offset + entry->size;
+    } else ctx->ring_end = 0;
+
+    emulator_load_state(gb, ctx->head);
+    ctx->frame_count = 0;
+    return STATUS_OK;
+}
+
+unsigned rewind_get_count(gb_instance_t *gb)
+{
+    return gb->rewind.count + (gb->rewind.head_valid ? 1 : 0);
+}
+
+size_t rewind_get_delta_bytes(gb_instance_t *gb)
+{
+    return gb->rewind.delta_bytes;
+}
+
+#endif // REWIND_ENABLED
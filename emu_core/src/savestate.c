@@ -0,0 +1,306 @@
+#include <savestate.h>
+#include <emulator.h>
+#include <core/cartridge/cart.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Sections are the in-memory structs, the format is little-endian */
+_Static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Savestates assume a little-endian host");
+_Static_assert(sizeof(savestate_header_t) == 64, "Header layout changed");
+_Static_assert(sizeof(savestate_section_t) == 24, "Section table layout changed");
+_Static_assert(sizeof(cpu_state_t) == 24, "CPU section layout changed, bump its version");
+_Static_assert(sizeof(serial_state_t) == 16, "Serial section layout changed, bump its version");
+_Static_assert(sizeof(cart_state_t) == 8, "Cart section layout changed, bump its version");
+
+/* Offset of the checksum field, zeroed while computing it */
+#define SAVESTATE_CHECKSUM_OFFSET   offsetof(savestate_header_t, checksum)
+
+/* Section tables larger than this are refused as corrupt */
+#define SAVESTATE_MAX_SECTIONS      64
+
+#define SAVESTATE_ALIGN(value, align)   (((value) + (align) - 1) / (align) * (align))
+
+/**
+ *  Where each section comes from in `emulator_state_t`.
+ */
+typedef struct savestate_layout {
+    uint32_t id;
+    uint32_t version;
+    size_t state_offset;
+    size_t size;
+    bool page_aligned;
+} savestate_layout_t;
+
+static const savestate_layout_t savestate_layout[] = {
+    { SAVESTATE_SECTION_EMULATOR,  1, offsetof(emulator_state_t, global_tick),  sizeof(uint64_t),           false },
+    { SAVESTATE_SECTION_CPU,       1, offsetof(emulator_state_t, cpu),          sizeof(cpu_state_t),        false },
+    { SAVESTATE_SECTION_INTERRUPT, 1, offsetof(emulator_state_t, interrupt),    sizeof(interrupt_state_t),  false },
+    { SAVESTATE_SECTION_SERIAL,    1, offsetof(emulator_state_t, serial),       sizeof(serial_state_t),     false },
+    { SAVESTATE_SECTION_CART,      2, offsetof(emulator_state_t, cart),         sizeof(cart_state_t),       false },
+    { SAVESTATE_SECTION_WRAM,      1, offsetof(emulator_state_t, memory.wram),  WRAM_SIZE,                  true  },
+    { SAVESTATE_SECTION_VRAM,      1, offsetof(emulator_state_t, memory.vram),  VRAM_SIZE,                  true  },
+    { SAVESTATE_SECTION_OAM,       1, offsetof(emulator_state_t, memory.oam),   OAM_SIZE,                   true  },
+    { SAVESTATE_SECTION_HRAM,      1, offsetof(emulator_state_t, memory.hram),  HRAM_SIZE,                  true  },
+};
+
+#define SAVESTATE_SECTION_COUNT     (sizeof(savestate_layout) / sizeof(savestate_layout[0]))
+
+/* Shared by every instance, filled once */
+static uint32_t crc32_table[256];
+static pthread_once_t crc32_once = PTHREAD_ONCE_INIT;
+
+static void crc32_init()
+{
+    for (uint32_t i = 0; i < 256; ++i){
+        uint32_t crc = i;
+        for (unsigned bit = 0; bit < 8; ++bit){
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+        }
+        crc32_table[i] = crc;
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t size)
+{
+    pthread_once(&crc32_once, crc32_init);
+
+    for (size_t i = 0; i < size; ++i){
+        crc = crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+/**
+ *  CRC-32 of a state, with the checksum field taken as 0.
+ */
+static uint32_t state_checksum(const uint8_t *buffer, size_t size)
+{
+    static const uint8_t zero[sizeof(uint32_t)] = { 0 };
+    uint32_t crc = 0xFFFFFFFFu;
+
+    crc = crc32_update(crc, buffer, SAVESTATE_CHECKSUM_OFFSET);
+    crc = crc32_update(crc, zero, sizeof(zero));
+    crc = crc32_update(crc, buffer + SAVESTATE_CHECKSUM_OFFSET + sizeof(zero),
+                       size - SAVESTATE_CHECKSUM_OFFSET - sizeof(zero));
+    return ~crc;
+}
+
+/**
+ *  Places every section, returns the file size.
+ */
+static size_t layout_sections(uint64_t offsets[SAVESTATE_SECTION_COUNT])
+{
+    size_t offset = sizeof(savestate_header_t) + SAVESTATE_SECTION_COUNT * sizeof(savestate_section_t);
+
+    for (unsigned i = 0; i < SAVESTATE_SECTION_COUNT; ++i){
+        size_t align = savestate_layout[i].page_aligned ? SAVESTATE_PAGE_SIZE : SAVESTATE_SECTION_ALIGN;
+        offset = SAVESTATE_ALIGN(offset, align);
+        offsets[i] = offset;
+        offset += savestate_layout[i].size;
+    }
+
+    return offset;
+}
+
+size_t savestate_get_size()
+{
+    uint64_t offsets[SAVESTATE_SECTION_COUNT];
+    return layout_sections(offsets);
+}
+
+size_t savestate_write_buffer(gb_instance_t *gb, uint8_t *buffer, size_t size)
+{
+    uint64_t offsets[SAVESTATE_SECTION_COUNT];
+    size_t file_size = layout_sections(offsets);
+    const cart_meta_t *meta = cart_get_metadata(gb);
+    emulator_state_t state;
+
+    assert(size >= file_size);
+    (void) size;
+
+    emulator_save_state(gb, &state);
+    memset(buffer, 0, file_size);
+
+    savestate_header_t header = {
+        .version_major = SAVESTATE_VERSION_MAJOR,
+        .version_minor = SAVESTATE_VERSION_MINOR,
+        .header_size = sizeof(savestate_header_t) + SAVESTATE_SECTION_COUNT * sizeof(savestate_section_t),
+        .section_count = SAVESTATE_SECTION_COUNT,
+        .file_size = file_size,
+        .rom_header_checksum = meta->header_checksum,
+    };
+    memcpy(header.magic, SAVESTATE_MAGIC, sizeof(header.magic));
+    memcpy(header.rom_title, meta->title, sizeof(header.rom_title));
+
+    savestate_section_t *table = (savestate_section_t *) (buffer + sizeof(savestate_header_t));
+    for (unsigned i = 0; i < SAVESTATE_SECTION_COUNT; ++i){
+        const savestate_layout_t *layout = &savestate_layout[i];
+
+        table[i] = (savestate_section_t) {
+            .id = layout->id,
+            .version = layout->version,
+            .offset = offsets[i],
+            .size = layout->size
+        };
+        memcpy(buffer + offsets[i], (const uint8_t *) &state + layout->state_offset, layout->size);
+    }
+
+    memcpy(buffer, &header, sizeof(header));
+    header.checksum = state_checksum(buffer, file_size);
+    memcpy(buffer + SAVESTATE_CHECKSUM_OFFSET, &header.checksum, sizeof(header.checksum));
+
+    return file_size;
+}
+
+error_code_t savestate_validate(gb_instance_t *gb, const uint8_t *buffer, size_t size)
+{
+    savestate_header_t header;
+
+    if (size < sizeof(header)) return STATUS_INVALID_FORMAT;
+    memcpy(&header, buffer, sizeof(header));
+
+    if (memcmp(header.magic, SAVESTATE_MAGIC, sizeof(header.magic)) != 0) return STATUS_INVALID_FORMAT;
+    if (header.version_major != SAVESTATE_VERSION_MAJOR) return STATUS_INVALID_FORMAT;
+    if (header.file_size > size || header.file_size < header.header_size) return STATUS_INVALID_FORMAT;
+    if (header.section_count > SAVESTATE_MAX_SECTIONS) return STATUS_INVALID_FORMAT;
+    if (header.header_size < sizeof(header) + header.section_count * sizeof(savestate_section_t)){
+        return STATUS_INVALID_FORMAT;
+    }
+    if (state_checksum(buffer, header.file_size) != header.checksum) return STATUS_INVALID_FORMAT;
+
+    const savestate_section_t *table = (const savestate_section_t *) (buffer + sizeof(header));
+    for (uint32_t i = 0; i < header.section_count; ++i){
+        if (table[i].offset > header.file_size || table[i].size > header.file_size - table[i].offset){
+            return STATUS_INVALID_FORMAT;
+        }
+    }
+
+    /* Saved from another game */
+    const cart_meta_t *meta = cart_get_metadata(gb);
+    if (memcmp(header.rom_title, meta->title, sizeof(header.rom_title)) != 0
+        || header.rom_header_checksum != meta->header_checksum){
+        return STATUS_INVALID_FORMAT;
+    }
+
+    return STATUS_OK;
+}
+
+const void *savestate_find_section(const uint8_t *buffer, uint32_t id, size_t *section_size)
+{
+    savestate_header_t header;
+    memcpy(&header, buffer, sizeof(header));
+
+    const savestate_section_t *table = (const savestate_section_t *) (buffer + sizeof(header));
+    for (uint32_t i = 0; i < header.section_count; ++i){
+        if (table[i].id == id){
+            *section_size = (size_t) table[i].size;
+            return buffer + table[i].offset;
+        }
+    }
+
+    return NULL;
+}
+
+error_code_t savestate_read_buffer(gb_instance_t *gb, const uint8_t *buffer, size_t size)
+{
+    emulator_state_t state;
+    error_code_t status = savestate_validate(gb, buffer, size);
+    if (status != STATUS_OK) return status;
+
+    const savestate_section_t *table = (const savestate_section_t *) (buffer + sizeof(savestate_header_t));
+    uint32_t section_count = ((const savestate_header_t *) buffer)->section_count;
+
+    /* Every known section must be there, in a version we know */
+    for (unsigned i = 0; i < SAVESTATE_SECTION_COUNT; ++i){
+        const savestate_layout_t *layout = &savestate_layout[i];
+        const savestate_section_t *section = NULL;
+
+        for (uint32_t j = 0; j < section_count && section == NULL; ++j){
+            if (table[j].id == layout->id) section = &table[j];
+        }
+        if (section == NULL || section->version != layout->version || section->size != layout->size){
+            return STATUS_INVALID_FORMAT;
+        }
+
+        memcpy((uint8_t *) &state + layout->state_offset, buffer + section->offset, layout->size);
+    }
+
+    emulator_load_state(gb, &state);
+    return STATUS_OK;
+}
+
+error_code_t savestate_save(gb_instance_t *gb, const char *path)
+{
+    char tmp_path[PATH_MAX];
+    size_t size = savestate_get_size();
+
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int) sizeof(tmp_path)){
+        return STATUS_IO_ERROR;
+    }
+
+    int fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return STATUS_IO_ERROR;
+
+    if (ftruncate(fd, (off_t) size) != 0){
+        close(fd);
+        unlink(tmp_path);
+        return STATUS_IO_ERROR;
+    }
+
+    uint8_t *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED){
+        close(fd);
+        unlink(tmp_path);
+        return STATUS_IO_ERROR;
+    }
+
+    savestate_write_buffer(gb, mem, size);
+    munmap(mem, size);
+
+    if (close(fd) != 0 || rename(tmp_path, path) != 0){
+        unlink(tmp_path);
+        return STATUS_IO_ERROR;
+    }
+
+    return STATUS_OK;
+}
+
+error_code_t savestate_load(gb_instance_t *gb, const char *path)
+{
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return STATUS_IO_ERROR;
+
+    if (fstat(fd, &st) != 0){
+        close(fd);
+        return STATUS_IO_ERROR;
+    }
+    if (st.st_size < (off_t) sizeof(savestate_header_t)){
+        close(fd);
+        return STATUS_INVALID_FORMAT;
+    }
+
+    const uint8_t *mem = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return STATUS_IO_ERROR;
+
+    error_code_t status = savestate_read_buffer(gb, mem, (size_t) st.st_size);
+    munmap((void *) mem, (size_t) st.st_size);
+
+    return status;
+}
+
+error_code_t savestate_warm_start(gb_instance_t *gb, const char *path, m_cycle_t warmup_cycles)
+{
+    if (savestate_load(gb, path) == STATUS_OK) return STATUS_OK;
+
+    /* Missing, stale or from another game, made again */
+    emulator_run(gb, warmup_cycles);
+    return savestate_save(gb, path);
+}
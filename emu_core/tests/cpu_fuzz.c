@@ -0,0 +1,600 @@
+/**
+ *  Differential fuzzer for the instruction handlers.
+ *
+ *  Each case is a random CPU state, random memory and one random legal
+ *  instruction at PC. The instruction runs through the dispatch table
+ *  (CPU_OPTABLE, plus the generic `optable` when the specialized handlers
+ *  are built) and through the reference model in sm83_ref.c. Registers,
+ *  flags, IME, HALT/STOP, the memory writes and the M-cycles must match.
+ *
+ *  The HALT bug spans two instructions, so it gets a directed case run
+ *  through `cpu_run` instead, reported as a failure of HALT.
+ *
+ *  Failing cases are minimized (registers and memory simplified while the
+ *  failure stays the same) and the first one per opcode is printed.
+ *
+ *  The fuzzer memory is shared by the callbacks, so cases are sharded over
+ *  forked worker processes, one per core by default.
+ *
+ *  Build from emu_core (host only):
+ *      gcc -std=gnu11 -O2 -Iinclude -Iinclude/core -Ipy_scripts \
+ *          tests/cpu_fuzz.c tests/sm83_ref.c src/core/{bus,cart,interrupt,schedule}.c \
+ *          src/core/cpu/{alu_tables,block_cache,cpu,cpu_instrs,profiler,tracer}.c \
+ *          src/platform/pc/error_handling.c -lpthread -o cpu_fuzz
+ *
+ *  Usage:
+ *      cpu_fuzz [--cases n] [--seed n] [-j jobs] [--opcode XX | --opcode CBXX]
+ */
+
+#define _GNU_SOURCE
+#include <common.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/cpu_instrs.h>
+#include <core/interrupt.h>
+#include <gb_instance.h>
+#include <schedule.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sm83_ref.h"
+
+#define FUZZ_DEFAULT_CASES          1000000ull
+#define FUZZ_MAX_JOBS               256
+
+/* Memory writes of one instruction, CALL/PUSH/LD (a16),SP make two */
+#define FUZZ_MAX_WRITES             8
+
+/* Preset code bytes + writes */
+#define FUZZ_MAX_OVERLAY            (4 + FUZZ_MAX_WRITES)
+
+/* Any opcode */
+#define FUZZ_ANY_OPCODE             (-1)
+
+/**
+ *  One test case: everything needed to replay it.
+ */
+typedef struct fuzz_case {
+    sm83_state_t state;
+
+    /* Instruction bytes at PC */
+    uint8_t code[3];
+
+    /* Memory outside the code bytes, 0 when `mem_zero` is set */
+    uint64_t mem_seed;
+    bool mem_zero;
+
+} fuzz_case_t;
+
+typedef struct fuzz_write {
+    uint16_t addr;
+    uint8_t value;
+} fuzz_write_t;
+
+/**
+ *  What an instruction did, from either side.
+ */
+typedef struct fuzz_outcome {
+    sm83_state_t state;
+    unsigned cycles;
+    fuzz_write_t writes[FUZZ_MAX_WRITES];
+    unsigned writes_size;
+} fuzz_outcome_t;
+
+/**
+ *  Memory of the running case: a hash of the address, under the code
+ *  bytes and whatever got written.
+ */
+typedef struct fuzz_memory {
+    const fuzz_case_t *fcase;
+    fuzz_write_t overlay[FUZZ_MAX_OVERLAY];
+    unsigned overlay_size;
+    fuzz_outcome_t *outcome;
+} fuzz_memory_t;
+
+/**
+ *  Failure sent back to the parent, small enough to be written atomically.
+ */
+typedef struct fuzz_report {
+    unsigned index;
+    char text[1024];
+} fuzz_report_t;
+
+static gb_instance_t gb;
+static fuzz_memory_t memory;
+static master_slave_conn_t fuzz_conn;
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint8_t memory_read(uint16_t addr)
+{
+    for (unsigned i = memory.overlay_size; i-- > 0;){
+        if (memory.overlay[i].addr == addr) return memory.overlay[i].value;
+    }
+    if (memory.fcase->mem_zero) return 0;
+
+    uint64_t state = memory.fcase->mem_seed ^ ((uint64_t) addr << 32);
+    return (uint8_t) splitmix64(&state);
+}
+
+static void memory_write(uint16_t addr, uint8_t value)
+{
+    fuzz_outcome_t *outcome = memory.outcome;
+
+    if (outcome->writes_size < FUZZ_MAX_WRITES){
+        outcome->writes[outcome->writes_size++] = (fuzz_write_t) { addr, value };
+    }
+    if (memory.overlay_size < FUZZ_MAX_OVERLAY){
+        memory.overlay[memory.overlay_size++] = (fuzz_write_t) { addr, value };
+    }
+}
+
+/**
+ *  Fresh memory for `fcase`, with its code bytes at PC.
+ */
+static void memory_reset(const fuzz_case_t *fcase, fuzz_outcome_t *outcome)
+{
+    memory.fcase = fcase;
+    memory.overlay_size = 0;
+    memory.outcome = outcome;
+
+    for (unsigned i = 0; i < sizeof(fcase->code); ++i){
+        memory.overlay[memory.overlay_size++] = (fuzz_write_t) { (uint16_t) (fcase->state.pc + i), fcase->code[i] };
+    }
+    *outcome = (fuzz_outcome_t) { 0 };
+}
+
+/* Bus side */
+static error_code_t conn_read(void *context, addr_t addr, uint8_t *read_val)
+{
+    (void) context;
+    *read_val = memory_read(addr);
+    return STATUS_OK;
+}
+
+static error_code_t conn_write(void *context, addr_t addr, uint8_t value)
+{
+    (void) context;
+    memory_write(addr, value);
+    return STATUS_OK;
+}
+
+/* Reference side */
+static uint8_t ref_read(void *context, uint16_t addr)
+{
+    (void) context;
+    return memory_read(addr);
+}
+
+static void ref_write(void *context, uint16_t addr, uint8_t value)
+{
+    (void) context;
+    memory_write(addr, value);
+}
+
+static void fuzz_init()
+{
+    /* No direct memory, so every access goes through the callbacks */
+    fuzz_conn = (master_slave_conn_t) {
+        .start_addr = 0x0000,
+        .end_addr = 0xFFFF,
+        .slave_read = conn_read,
+        .slave_write = conn_write,
+    };
+
+    schedule_init(&gb);
+    interrupt_init(&gb);
+    if (bus_connect(&gb, &fuzz_conn) != STATUS_OK){
+        fprintf(stderr, "Can't connect the fuzzer memory\n");
+        exit(EXIT_FAILURE);
+    }
+    bus_init(&gb);
+    cpu_init(&gb);
+}
+
+static void run_reference(const fuzz_case_t *fcase, fuzz_outcome_t *outcome)
+{
+    static const sm83_bus_t bus = { .read = ref_read, .write = ref_write };
+
+    memory_reset(fcase, outcome);
+    outcome->state = fcase->state;
+    outcome->cycles = sm83_step(&outcome->state, &bus);
+}
+
+static void run_core(const fuzz_case_t *fcase, INSTR_FUNC *table, fuzz_outcome_t *outcome)
+{
+    cpu_context_t *context = cpu_get_context(&gb);
+    const sm83_state_t *s = &fcase->state;
+
+    memory_reset(fcase, outcome);
+
+    context->af.hi = s->a;
+    context->af.lo = s->f;
+    context->bc.hi = s->b;
+    context->bc.lo = s->c;
+    context->de.hi = s->d;
+    context->de.lo = s->e;
+    context->hl.hi = s->h;
+    context->hl.lo = s->l;
+    context->sp = s->sp;
+    context->pc = s->pc;
+    context->lazy_flags.op = CPU_FLAG_OP_NONE;
+    context->cycles = 0;
+    context->instr_mcycles = 0;
+    context->ime = s->ime;
+    context->ei_delay = 0;
+    context->sleep_state = CPU_SLEEP_NONE;
+    context->imm_ptr = NULL;
+    context->fetch.size = 0;
+    interrupt_set_ime(&gb, s->ime);
+
+    uint8_t opcode = cpu_fetch_pc(context);
+    table[opcode](context, opcode);
+    cpu_flags_sync(context);
+
+    outcome->cycles = (unsigned) context->cycles;
+    outcome->state = (sm83_state_t) {
+        .a = context->af.hi, .f = context->af.lo,
+        .b = context->bc.hi, .c = context->bc.lo,
+        .d = context->de.hi, .e = context->de.lo,
+        .h = context->hl.hi, .l = context->hl.lo,
+        .sp = context->sp,
+        .pc = context->pc,
+        /* The core sets IME right away and holds interrupts off with ei_delay */
+        .ime = context->ime && !context->ei_delay,
+        .ime_pending = context->ei_delay != 0,
+        .halted = context->sleep_state == CPU_SLEEP_HALT,
+        .stopped = context->sleep_state == CPU_SLEEP_STOP,
+    };
+}
+
+/**
+ *  Appends `name: expected/got` for every differing field. Returns the
+ *  number of differences.
+ */
+static unsigned diff_outcomes(const fuzz_outcome_t *ref, const fuzz_outcome_t *core, char *buf, size_t size)
+{
+    const sm83_state_t *a = &ref->state, *b = &core->state;
+    unsigned diffs = 0;
+    size_t len = strlen(buf);
+
+#define FUZZ_DIFF(name, fmt, x, y) \
+    if ((x) != (y)){ \
+        len += (size_t) snprintf(buf + len, (len < size) ? size - len : 0, " " name ":" fmt "/" fmt, x, y); \
+        diffs++; \
+    }
+
+    FUZZ_DIFF("A", "%02X", a->a, b->a);
+    FUZZ_DIFF("F", "%02X", a->f, b->f);
+    FUZZ_DIFF("B", "%02X", a->b, b->b);
+    FUZZ_DIFF("C", "%02X", a->c, b->c);
+    FUZZ_DIFF("D", "%02X", a->d, b->d);
+    FUZZ_DIFF("E", "%02X", a->e, b->e);
+    FUZZ_DIFF("H", "%02X", a->h, b->h);
+    FUZZ_DIFF("L", "%02X", a->l, b->l);
+    FUZZ_DIFF("SP", "%04X", a->sp, b->sp);
+    FUZZ_DIFF("PC", "%04X", a->pc, b->pc);
+    FUZZ_DIFF("IME", "%d", a->ime, b->ime);
+    FUZZ_DIFF("EI", "%d", a->ime_pending, b->ime_pending);
+    FUZZ_DIFF("HALT", "%d", a->halted, b->halted);
+    FUZZ_DIFF("STOP", "%d", a->stopped, b->stopped);
+    FUZZ_DIFF("cycles", "%u", ref->cycles, core->cycles);
+    FUZZ_DIFF("writes", "%u", ref->writes_size, core->writes_size);
+
+    for (unsigned i = 0; i < ref->writes_size && i < core->writes_size; ++i){
+        FUZZ_DIFF("write.addr", "%04X", ref->writes[i].addr, core->writes[i].addr);
+        FUZZ_DIFF("write.value", "%02X", ref->writes[i].value, core->writes[i].value);
+    }
+
+#undef FUZZ_DIFF
+    return diffs;
+}
+
+/**
+ *  Runs the case on the reference and on `table`. Returns true when they
+ *  agree, `buf` gets the differences otherwise.
+ */
+static bool check_case(const fuzz_case_t *fcase, INSTR_FUNC *table, char *buf, size_t size)
+{
+    fuzz_outcome_t ref, core;
+
+    run_reference(fcase, &ref);
+    run_core(fcase, table, &core);
+
+    buf[0] = '\0';
+    return diff_outcomes(&ref, &core, buf, size) == 0;
+}
+
+static void random_case(fuzz_case_t *fcase, uint64_t seed, int opcode)
+{
+    uint64_t rng = seed;
+    uint64_t r = splitmix64(&rng);
+
+    *fcase = (fuzz_case_t) {
+        .state = {
+            .a = (uint8_t) r, .f = (uint8_t) ((r >> 8) & 0xF0),
+            .b = (uint8_t) (r >> 16), .c = (uint8_t) (r >> 24),
+            .d = (uint8_t) (r >> 32), .e = (uint8_t) (r >> 40),
+            .h = (uint8_t) (r >> 48), .l = (uint8_t) (r >> 56),
+        },
+        .mem_seed = splitmix64(&rng),
+    };
+
+    r = splitmix64(&rng);
+    fcase->state.sp = (uint16_t) r;
+    fcase->state.pc = (uint16_t) (r >> 16);
+    fcase->state.ime = (r >> 32) & 1;
+    fcase->code[1] = (uint8_t) (r >> 40);
+    fcase->code[2] = (uint8_t) (r >> 48);
+
+    if (opcode == FUZZ_ANY_OPCODE){
+        do {
+            fcase->code[0] = (uint8_t) splitmix64(&rng);
+        } while (!sm83_is_legal(fcase->code[0]));
+    } else if (opcode >= 256){
+        fcase->code[0] = 0xCB;
+        fcase->code[1] = (uint8_t) opcode;
+    } else {
+        fcase->code[0] = (uint8_t) opcode;
+    }
+}
+
+/**
+ *  Simplifies a failing case field by field, keeping every change that
+ *  still fails.
+ */
+static void minimize_case(fuzz_case_t *fcase, INSTR_FUNC *table)
+{
+    char buf[512];
+    bool changed = true;
+
+    while (changed){
+        changed = false;
+
+        fuzz_case_t attempt = *fcase;
+        if (!attempt.mem_zero){
+            attempt.mem_zero = true;
+            if (!check_case(&attempt, table, buf, sizeof(buf))){
+                *fcase = attempt;
+                changed = true;
+            }
+        }
+
+        static const size_t regs[] = {
+            offsetof(sm83_state_t, a), offsetof(sm83_state_t, f), offsetof(sm83_state_t, b),
+            offsetof(sm83_state_t, c), offsetof(sm83_state_t, d), offsetof(sm83_state_t, e),
+            offsetof(sm83_state_t, h), offsetof(sm83_state_t, l),
+        };
+        for (unsigned i = 0; i < sizeof(regs) / sizeof(regs[0]); ++i){
+            attempt = *fcase;
+            uint8_t *reg = (uint8_t *) &attempt.state + regs[i];
+            if (*reg == 0) continue;
+
+            *reg = 0;
+            if (!check_case(&attempt, table, buf, sizeof(buf))){
+                *fcase = attempt;
+                changed = true;
+            }
+        }
+
+        /* Immediates (not the CB opcode) */
+        for (unsigned i = (fcase->code[0] == 0xCB) ? 2 : 1; i < sizeof(fcase->code); ++i){
+            attempt = *fcase;
+            if (attempt.code[i] == 0) continue;
+
+            attempt.code[i] = 0;
+            if (!check_case(&attempt, table, buf, sizeof(buf))){
+                *fcase = attempt;
+                changed = true;
+            }
+        }
+
+        attempt = *fcase;
+        if (attempt.state.sp != 0xC000){
+            attempt.state.sp = 0xC000;
+            if (!check_case(&attempt, table, buf, sizeof(buf))){
+                *fcase = attempt;
+                changed = true;
+            }
+        }
+        attempt = *fcase;
+        if (attempt.state.pc != 0x0100){
+            attempt.state.pc = 0x0100;
+            if (!check_case(&attempt, table, buf, sizeof(buf))){
+                *fcase = attempt;
+                changed = true;
+            }
+        }
+        attempt = *fcase;
+        if (attempt.state.ime){
+            attempt.state.ime = false;
+            if (!check_case(&attempt, table, buf, sizeof(buf))){
+                *fcase = attempt;
+                changed = true;
+            }
+        }
+    }
+}
+
+/**
+ *  Directed case for the HALT bug: HALT; INC A with IME cleared, run
+ *  through `cpu_run` with and without an interrupt pending. Returns true
+ *  when the core agrees, `buf` gets the differences otherwise.
+ */
+static bool check_halt_bug(char *buf, size_t size)
+{
+    cpu_context_t *context = cpu_get_context(&gb);
+    fuzz_case_t fcase = { .state = { .pc = 0xC000 }, .code = { 0x76, 0x3C, 0x00 }, .mem_zero = true };
+    fuzz_outcome_t outcome;
+    size_t len = 0;
+
+    buf[0] = '\0';
+    for (int pending = 0; pending < 2; ++pending){
+        memory_reset(&fcase, &outcome);
+        cpu_load_state(&gb, &(cpu_state_t) { .pc = fcase.state.pc });
+        if (pending) interrupt_set_flag(&gb, INTERRUPT_TYPE_VBLANK);
+
+        /* Pending: no sleep, INC A runs twice as the byte after HALT is fetched twice */
+        cpu_run(&gb, 3);
+        cpu_flags_sync(context);
+        interrupt_clear_flag(&gb, INTERRUPT_TYPE_VBLANK);
+
+        uint8_t a = pending ? 2 : 0;
+        uint16_t pc = pending ? 0xC002 : 0xC001;
+        bool halted = !pending;
+
+        if (context->af.hi != a || context->pc != pc || (context->sleep_state == CPU_SLEEP_HALT) != halted){
+            len += (size_t) snprintf(buf + len, (len < size) ? size - len : 0,
+                                     " pending:%d A:%02X/%02X PC:%04X/%04X HALT:%d/%d", pending, a, context->af.hi,
+                                     pc, context->pc, halted, context->sleep_state == CPU_SLEEP_HALT);
+        }
+    }
+    return len == 0;
+}
+
+static void format_report(fuzz_report_t *report, const fuzz_case_t *fcase, const char *table_name, INSTR_FUNC *table)
+{
+    const sm83_state_t *s = &fcase->state;
+    char diffs[512];
+
+    check_case(fcase, table, diffs, sizeof(diffs));
+    snprintf(report->text, sizeof(report->text),
+             "%s%02X [%s] code:%02X,%02X,%02X A:%02X F:%02X B:%02X C:%02X D:%02X E:%02X H:%02X L:%02X "
+             "SP:%04X PC:%04X IME:%d mem:%s\n    expected/got:%s\n",
+             (fcase->code[0] == 0xCB) ? "CB " : "", (fcase->code[0] == 0xCB) ? fcase->code[1] : fcase->code[0],
+             table_name, fcase->code[0], fcase->code[1], fcase->code[2], s->a, s->f, s->b, s->c, s->d, s->e,
+             s->h, s->l, s->sp, s->pc, s->ime, fcase->mem_zero ? "zero" : "random", diffs);
+}
+
+/**
+ *  Runs cases `worker`, `worker + jobs`, ... and writes the first failure
+ *  of each opcode to `fd`. Returns the number of failing cases.
+ */
+static uint64_t run_worker(unsigned worker, unsigned jobs, uint64_t cases, uint64_t seed, int opcode, int fd)
+{
+    struct {
+        const char *name;
+        INSTR_FUNC *table;
+    } tables[] = {
+        { "dispatch", CPU_OPTABLE },
+#if CPU_SPECIALIZED_HANDLERS
+        { "generic", optable },
+#endif
+    };
+    bool reported[512] = { false };
+    uint64_t failures = 0;
+    char buf[512];
+
+    fuzz_init();
+
+    if (worker == 0 && (opcode == FUZZ_ANY_OPCODE || opcode == 0x76) && !check_halt_bug(buf, sizeof(buf))){
+        fuzz_report_t report = { .index = 0x76 };
+        snprintf(report.text, sizeof(report.text), "76 [halt bug]\n    expected/got:%s\n", buf);
+        failures++;
+        reported[0x76] = true;
+        if (write(fd, &report, sizeof(report)) != (ssize_t) sizeof(report)) return failures;
+    }
+
+    for (uint64_t i = worker; i < cases; i += jobs){
+        fuzz_case_t fcase;
+        random_case(&fcase, seed + i * 0x9E3779B97F4A7C15ull, opcode);
+
+        for (unsigned t = 0; t < sizeof(tables) / sizeof(tables[0]); ++t){
+            if (check_case(&fcase, tables[t].table, buf, sizeof(buf))) continue;
+
+            failures++;
+            unsigned index = (fcase.code[0] == 0xCB) ? 256u + fcase.code[1] : fcase.code[0];
+            if (reported[index]) continue;
+            reported[index] = true;
+
+            fuzz_report_t report = { .index = index };
+            minimize_case(&fcase, tables[t].table);
+            format_report(&report, &fcase, tables[t].name, tables[t].table);
+            if (write(fd, &report, sizeof(report)) != (ssize_t) sizeof(report)) break;
+        }
+    }
+
+    return failures;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [--cases n] [--seed n] [-j jobs] [--opcode XX | --opcode CBXX]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t cases = FUZZ_DEFAULT_CASES, seed = 1;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int opcode = FUZZ_ANY_OPCODE;
+
+    for (int i = 1; i < argc; ++i){
+        if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc) cases = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) jobs = atol(argv[++i]);
+        else if (strcmp(argv[i], "--opcode") == 0 && i + 1 < argc){
+            const char *arg = argv[++i];
+            bool prefixed = (strncasecmp(arg, "CB", 2) == 0 && strlen(arg) > 2);
+            opcode = (int) strtol(prefixed ? arg + 2 : arg, NULL, 16) + (prefixed ? 256 : 0);
+            if (opcode < 0 || opcode >= 512 || (opcode < 256 && (!sm83_is_legal((uint8_t) opcode) || opcode == 0xCB))){
+                fprintf(stderr, "Not a fuzzable opcode: %s\n", arg);
+                return 2;
+            }
+        }
+        else usage(argv[0]);
+    }
+    if (jobs < 1) jobs = 1;
+    if (jobs > FUZZ_MAX_JOBS) jobs = FUZZ_MAX_JOBS;
+
+    int fds[2];
+    if (pipe(fds) != 0){
+        perror("pipe");
+        return EXIT_FAILURE;
+    }
+
+    fflush(stdout);
+    for (long w = 0; w < jobs; ++w){
+        pid_t pid = fork();
+        if (pid < 0){
+            perror("fork");
+            return EXIT_FAILURE;
+        }
+        if (pid == 0){
+            close(fds[0]);
+            uint64_t failures = run_worker((unsigned) w, (unsigned) jobs, cases, seed, opcode, fds[1]);
+            _exit(failures ? 1 : 0);
+        }
+    }
+    close(fds[1]);
+
+    /* First failure per opcode across every worker */
+    bool reported[512] = { false };
+    unsigned reported_size = 0;
+    fuzz_report_t report;
+    while (read(fds[0], &report, sizeof(report)) == (ssize_t) sizeof(report)){
+        if (report.index >= 512 || reported[report.index]) continue;
+        reported[report.index] = true;
+        reported_size++;
+        fputs(report.text, stdout);
+    }
+
+    bool failed = false;
+    int status;
+    while (wait(&status) > 0){
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed = true;
+    }
+
+    printf("%llu cases, seed %llu, %ld jobs: %s (%u opcodes failing)\n", (unsigned long long) cases,
+           (unsigned long long) seed, jobs, failed ? "FAILED" : "ok", reported_size);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,421 @@
+/**
+ *  Headless test-ROM runner.
+ *
+ *  Runs every .gb/.gbc file under a directory and reports pass/fail, as
+ *  JUnit XML and/or JSON, with the emulated cycles and wall time per ROM.
+ *
+ *  - Blargg ROMs (cpu_instrs, ...) print their result on the serial port,
+ *    "Passed" or "Failed" ends the run.
+ *  - Mooneye ROMs load the Fibonacci numbers 3/5/8/13/21/34 into
+ *    B/C/D/E/H/L when they pass, 0x42 in all of them when they fail.
+ *
+ *  emu_die ends the whole process, so each ROM runs in a forked child
+ *  process, up to one per core at a time. A child that dies (emu_die,
+ *  crash) is reported as an error.
+ *
+ *  Build from emu_core (host only):
+ *      gcc -std=gnu11 -O2 -Iinclude -Iinclude/core -Ipy_scripts \
+ *          tests/rom_runner.c src/emulator.c src/rewind.c src/core/{bus,cart,interrupt,memory,schedule,serial}.c \
+ *          src/core/cpu/{alu_tables,block_cache,cpu,cpu_instrs,profiler,tracer}.c \
+ *          src/platform/pc/error_handling.c -lpthread -o rom_runner
+ *
+ *  Usage:
+ *      rom_runner <rom dir> [-j jobs] [--junit out.xml] [--json out.json]
+ *                 [--max-seconds emulated seconds]
+ */
+
+#define _GNU_SOURCE
+#include <common.h>
+#include <emulator.h>
+#include <gb_instance.h>
+#include <core/cpu.h>
+#include <core/serial.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* M-cycles per emulated second */
+#define RUNNER_CYCLES_PER_SECOND    1048576ull
+
+#define RUNNER_DEFAULT_MAX_SECONDS  120
+
+/* Results are checked between slices of one frame */
+#define RUNNER_SLICE_CYCLES         17556
+
+#define RUNNER_MAX_ROMS             4096
+#define RUNNER_MAX_ROM_SIZE         (8u * 1024 * 1024)
+#define RUNNER_MAX_JOBS             256
+
+/* Tail of the serial output kept for the report */
+#define RUNNER_SERIAL_LEN           512
+
+typedef enum runner_status {
+    RUNNER_PASS = 0,
+    RUNNER_FAIL,
+    RUNNER_TIMEOUT,
+    RUNNER_ERROR,
+} runner_status_t;
+
+static const char *const runner_status_names[] = {
+    [RUNNER_PASS]       = "pass",
+    [RUNNER_FAIL]       = "fail",
+    [RUNNER_TIMEOUT]    = "timeout",
+    [RUNNER_ERROR]      = "error",
+};
+
+/**
+ *  Result of one ROM, sent back by the child through a pipe.
+ *  Small enough to be written atomically.
+ */
+typedef struct runner_result {
+    uint8_t status;
+    m_cycle_t cycles;
+    uint64_t wall_ns;
+    char serial[RUNNER_SERIAL_LEN];
+} runner_result_t;
+
+typedef struct runner_rom {
+    char *path;
+    pid_t pid;
+    int pipe_fd;
+    runner_result_t result;
+} runner_rom_t;
+
+typedef struct runner {
+    runner_rom_t roms[RUNNER_MAX_ROMS];
+    unsigned roms_size;
+
+    /* Serial output of the ROM running in this process (child side) */
+    char serial[RUNNER_SERIAL_LEN];
+    unsigned serial_size;
+} runner_t;
+
+static runner_t runner;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static int collect_rom(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+    (void) st;
+    (void) ftw;
+
+    const char *ext = strrchr(path, '.');
+    if (type != FTW_F || ext == NULL || (strcmp(ext, ".gb") != 0 && strcmp(ext, ".gbc") != 0)) return 0;
+
+    if (runner.roms_size == RUNNER_MAX_ROMS){
+        fprintf(stderr, "Too many ROMs, only the first %u are run\n", RUNNER_MAX_ROMS);
+        return 1;
+    }
+    runner.roms[runner.roms_size++].path = strdup(path);
+    return 0;
+}
+
+static int compare_roms(const void *a, const void *b)
+{
+    return strcmp(((const runner_rom_t *) a)->path, ((const runner_rom_t *) b)->path);
+}
+
+static void serial_output(gb_instance_t *gb, uint8_t value)
+{
+    (void) gb;
+
+    /* Keeps the tail, where the verdict is */
+    if (runner.serial_size == RUNNER_SERIAL_LEN - 1){
+        memmove(runner.serial, runner.serial + 1, RUNNER_SERIAL_LEN - 2);
+        runner.serial_size--;
+    }
+    runner.serial[runner.serial_size++] = (char) value;
+    runner.serial[runner.serial_size] = '\0';
+}
+
+static bool mooneye_signature(const cpu_context_t *context, uint8_t b, uint8_t c, uint8_t d,
+                              uint8_t e, uint8_t h, uint8_t l)
+{
+    return context->bc.hi == b && context->bc.lo == c && context->de.hi == d
+        && context->de.lo == e && context->hl.hi == h && context->hl.lo == l;
+}
+
+/**
+ *  Runs one ROM in this process until it reports a result or times out.
+ */
+static runner_result_t run_rom(const char *path, m_cycle_t max_cycles)
+{
+    runner_result_t result = { .status = RUNNER_ERROR };
+    uint64_t start_ns = now_ns();
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL){
+        snprintf(result.serial, sizeof(result.serial), "can't open ROM");
+        return result;
+    }
+
+    uint8_t *rom = calloc(RUNNER_MAX_ROM_SIZE, 1);
+    size_t rom_size = (rom != NULL) ? fread(rom, 1, RUNNER_MAX_ROM_SIZE, file) : 0;
+    fclose(file);
+
+    /* The cartridge expects at least both ROM banks */
+    if (rom_size < 0x8000){
+        snprintf(result.serial, sizeof(result.serial), "ROM too small");
+        return result;
+    }
+
+    gb_instance_t *gb = emulator_create();
+    if (gb == NULL){
+        snprintf(result.serial, sizeof(result.serial), "out of memory");
+        return result;
+    }
+
+    emulator_init(gb, rom, rom_size);
+    serial_set_output_hook(gb, serial_output);
+
+    result.status = RUNNER_TIMEOUT;
+    while (result.cycles < max_cycles){
+        result.cycles += emulator_run(gb, RUNNER_SLICE_CYCLES);
+
+        const cpu_context_t *context = cpu_get_context(gb);
+        if (strstr(runner.serial, "Passed") != NULL || mooneye_signature(context, 3, 5, 8, 13, 21, 34)){
+            result.status = RUNNER_PASS;
+            break;
+        }
+        if (strstr(runner.serial, "Failed") != NULL || mooneye_signature(context, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42)){
+            result.status = RUNNER_FAIL;
+            break;
+        }
+    }
+
+    result.wall_ns = now_ns() - start_ns;
+    memcpy(result.serial, runner.serial, sizeof(result.serial));
+    return result;
+}
+
+/**
+ *  Forks a child running `rom`, its result comes back through `rom->pipe_fd`.
+ */
+static bool start_rom(runner_rom_t *rom, m_cycle_t max_cycles)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0){
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0){
+        close(fds[0]);
+
+        /* emu_die prints to stdout, keep it off the report */
+        if (freopen("/dev/null", "w", stdout) == NULL) _exit(RUNNER_ERROR);
+
+        runner_result_t result = run_rom(rom->path, max_cycles);
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit((written == (ssize_t) sizeof(result)) ? 0 : RUNNER_ERROR);
+    }
+
+    close(fds[1]);
+    rom->pid = pid;
+    rom->pipe_fd = fds[0];
+    return true;
+}
+
+/**
+ *  Reaps the child of `rom`. A child that died without a result is an error.
+ */
+static void finish_rom(runner_rom_t *rom, int wait_status, uint64_t start_ns)
+{
+    ssize_t size = 0, got;
+    uint8_t *out = (uint8_t *) &rom->result;
+
+    while ((got = read(rom->pipe_fd, out + size, sizeof(rom->result) - (size_t) size)) > 0){
+        size += got;
+    }
+    close(rom->pipe_fd);
+
+    if (size != (ssize_t) sizeof(rom->result)){
+        memset(&rom->result, 0, sizeof(rom->result));
+        rom->result.status = RUNNER_ERROR;
+        rom->result.wall_ns = now_ns() - start_ns;
+
+        if (WIFSIGNALED(wait_status)){
+            snprintf(rom->result.serial, sizeof(rom->result.serial), "killed by signal %d", WTERMSIG(wait_status));
+        } else {
+            snprintf(rom->result.serial, sizeof(rom->result.serial), "exited with status %d", WEXITSTATUS(wait_status));
+        }
+    }
+
+    rom->result.serial[RUNNER_SERIAL_LEN - 1] = '\0';
+    printf("%-7s %-60s %12llu cycles %9.3f s\n", runner_status_names[rom->result.status], rom->path,
+           (unsigned long long) rom->result.cycles, rom->result.wall_ns / 1e9);
+}
+
+static void write_escaped(FILE *file, const char *text, bool json)
+{
+    for (const char *c = text; *c != '\0'; ++c){
+        unsigned char ch = (unsigned char) *c;
+
+        if (json && (ch == '"' || ch == '\\')) fprintf(file, "\\%c", ch);
+        else if (json && ch < 0x20) fprintf(file, "\\u%04x", ch);
+        else if (!json && ch == '<') fputs("&lt;", file);
+        else if (!json && ch == '>') fputs("&gt;", file);
+        else if (!json && ch == '&') fputs("&amp;", file);
+        else if (!json && ch == '"') fputs("&quot;", file);
+        /* Not allowed in XML 1.0 */
+        else if (!json && ch < 0x20 && ch != '\n' && ch != '\t') fputc('?', file);
+        else fputc(ch, file);
+    }
+}
+
+static bool write_junit(const char *path, unsigned *counts, uint64_t wall_ns)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(file, "<testsuite name=\"test-roms\" tests=\"%u\" failures=\"%u\" errors=\"%u\" time=\"%.3f\">\n",
+            runner.roms_size, counts[RUNNER_FAIL], counts[RUNNER_TIMEOUT] + counts[RUNNER_ERROR], wall_ns / 1e9);
+
+    for (unsigned i = 0; i < runner.roms_size; ++i){
+        const runner_rom_t *rom = &runner.roms[i];
+
+        fprintf(file, "  <testcase classname=\"test-roms\" name=\"");
+        write_escaped(file, rom->path, false);
+        fprintf(file, "\" time=\"%.3f\">\n", rom->result.wall_ns / 1e9);
+        fprintf(file, "    <properties><property name=\"cycles\" value=\"%llu\"/></properties>\n",
+                (unsigned long long) rom->result.cycles);
+
+        if (rom->result.status != RUNNER_PASS){
+            const char *tag = (rom->result.status == RUNNER_FAIL) ? "failure" : "error";
+            fprintf(file, "    <%s message=\"%s\"/>\n", tag, runner_status_names[rom->result.status]);
+        }
+        if (rom->result.serial[0] != '\0'){
+            fprintf(file, "    <system-out>");
+            write_escaped(file, rom->result.serial, false);
+            fprintf(file, "</system-out>\n");
+        }
+        fprintf(file, "  </testcase>\n");
+    }
+    fprintf(file, "</testsuite>\n");
+
+    return fclose(file) == 0;
+}
+
+static bool write_json(const char *path, unsigned *counts, uint64_t wall_ns)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "{\n  \"total\": %u, \"passed\": %u, \"failed\": %u, \"timeouts\": %u, \"errors\": %u,"
+            " \"wall_s\": %.3f,\n  \"roms\": [\n", runner.roms_size, counts[RUNNER_PASS], counts[RUNNER_FAIL],
+            counts[RUNNER_TIMEOUT], counts[RUNNER_ERROR], wall_ns / 1e9);
+
+    for (unsigned i = 0; i < runner.roms_size; ++i){
+        const runner_rom_t *rom = &runner.roms[i];
+
+        fprintf(file, "    {\"rom\": \"");
+        write_escaped(file, rom->path, true);
+        fprintf(file, "\", \"status\": \"%s\", \"cycles\": %llu, \"wall_s\": %.3f, \"serial\": \"",
+                runner_status_names[rom->result.status], (unsigned long long) rom->result.cycles,
+                rom->result.wall_ns / 1e9);
+        write_escaped(file, rom->result.serial, true);
+        fprintf(file, "\"}%s\n", (i + 1 < runner.roms_size) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    return fclose(file) == 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s <rom dir> [-j jobs] [--junit out.xml] [--json out.json] [--max-seconds n]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *rom_dir = NULL, *junit_path = NULL, *json_path = NULL;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    m_cycle_t max_cycles = RUNNER_DEFAULT_MAX_SECONDS * RUNNER_CYCLES_PER_SECOND;
+
+    for (int i = 1; i < argc; ++i){
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) jobs = atol(argv[++i]);
+        else if (strcmp(argv[i], "--junit") == 0 && i + 1 < argc) junit_path = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_path = argv[++i];
+        else if (strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) max_cycles = strtoull(argv[++i], NULL, 10) * RUNNER_CYCLES_PER_SECOND;
+        else if (argv[i][0] != '-' && rom_dir == NULL) rom_dir = argv[i];
+        else usage(argv[0]);
+    }
+    if (rom_dir == NULL) usage(argv[0]);
+    if (jobs < 1) jobs = 1;
+    if (jobs > RUNNER_MAX_JOBS) jobs = RUNNER_MAX_JOBS;
+
+    if (nftw(rom_dir, collect_rom, 16, FTW_PHYS) < 0){
+        perror(rom_dir);
+        return 2;
+    }
+    qsort(runner.roms, runner.roms_size, sizeof(runner_rom_t), compare_roms);
+
+    uint64_t start_ns = now_ns();
+    uint64_t rom_start_ns[RUNNER_MAX_ROMS];
+    unsigned next = 0, running = 0;
+
+    /* Keeps `jobs` children busy, reaping whichever ends first */
+    while (next < runner.roms_size || running > 0){
+        while (next < runner.roms_size && running < (unsigned) jobs){
+            runner_rom_t *rom = &runner.roms[next];
+            rom_start_ns[next] = now_ns();
+
+            if (start_rom(rom, max_cycles)){
+                running++;
+            } else {
+                rom->pid = 0;
+                rom->result = (runner_result_t) { .status = RUNNER_ERROR };
+                snprintf(rom->result.serial, sizeof(rom->result.serial), "fork failed");
+            }
+            next++;
+        }
+        if (running == 0) continue;
+
+        int wait_status;
+        pid_t pid = wait(&wait_status);
+        if (pid < 0) break;
+
+        for (unsigned i = 0; i < next; ++i){
+            if (runner.roms[i].pid == pid){
+                finish_rom(&runner.roms[i], wait_status, rom_start_ns[i]);
+                runner.roms[i].pid = 0;
+                running--;
+                break;
+            }
+        }
+    }
+
+    uint64_t wall_ns = now_ns() - start_ns;
+    unsigned counts[4] = { 0 };
+    for (unsigned i = 0; i < runner.roms_size; ++i){
+        counts[runner.roms[i].result.status]++;
+    }
+
+    printf("\n%u ROMs: %u passed, %u failed, %u timed out, %u errors in %.3f s\n", runner.roms_size,
+           counts[RUNNER_PASS], counts[RUNNER_FAIL], counts[RUNNER_TIMEOUT], counts[RUNNER_ERROR], wall_ns / 1e9);
+
+    if (junit_path != NULL && !write_junit(junit_path, counts, wall_ns)){
+        perror(junit_path);
+    }
+    if (json_path != NULL && !write_json(json_path, counts, wall_ns)){
+        perror(json_path);
+    }
+
+    return (counts[RUNNER_PASS] == runner.roms_size) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
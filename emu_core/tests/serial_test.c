@@ -0,0 +1,96 @@
+/**
+ *  Serial transfer restarts.
+ *
+ *  A ROM starts a transfer, then stops and restarts it more times than the
+ *  event queue has slots (MAX_DEVICE_NUMBER), all inside one transfer
+ *  period, and finally restarts it once more. Exactly one byte must go out,
+ *  one transfer period after the last restart, and the queue must not fill
+ *  up (which ends the process in emu_die).
+ *
+ *  Build from emu_core (host only):
+ *      gcc -std=gnu11 -O2 -Iinclude -Iinclude/core -Ipy_scripts \
+ *          tests/serial_test.c src/emulator.c src/rewind.c src/core/{bus,cart,interrupt,memory,schedule,serial}.c \
+ *          src/core/cpu/{alu_tables,block_cache,cpu,cpu_instrs,profiler,tracer}.c \
+ *          src/platform/pc/error_handling.c -lpthread -o serial_test
+ *
+ *  Usage:
+ *      serial_test
+ */
+
+#include <common.h>
+#include <emulator.h>
+#include <gb_instance.h>
+#include <core/serial.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROM_SIZE        0x8000
+#define CODE_ADDR       0x0150
+
+/* More than the event queue holds */
+#define RESTARTS        (MAX_DEVICE_NUMBER + 5)
+
+/* M-cycles of the code before the last restart completes, see `code` */
+#define RESTART_LOOP_CYCLES     (2 + 3 + 1 + 3 + 1 + 3)
+#define LAST_RESTART_CYCLES     (4 + 2 + 3 + 2 + RESTARTS * RESTART_LOOP_CYCLES - 1 + 2 + 3)
+
+/* The event runs at the first instruction boundary after the transfer end */
+#define MAX_EVENT_LATENESS      4
+
+static unsigned bytes_out;
+static uint8_t last_byte;
+static m_cycle_t last_byte_cycles;
+
+static void on_serial_output(gb_instance_t *gb, uint8_t value)
+{
+    bytes_out++;
+    last_byte = value;
+    last_byte_cycles = cpu_get_cycles(gb);
+}
+
+int main(void)
+{
+    static uint8_t rom[ROM_SIZE];
+
+    /* JP CODE_ADDR */
+    const uint8_t entry[] = { 0xC3, CODE_ADDR & 0xFF, CODE_ADDR >> 8 };
+
+    const uint8_t code[] = {
+        0x3E, 0x41,             /* LD A, 0x41 */
+        0xE0, 0x01,             /* LDH (SB), A */
+        0x06, RESTARTS,         /* LD B, RESTARTS */
+        0x3E, 0x81,             /* loop: LD A, 0x81 */
+        0xE0, 0x02,             /* LDH (SC), A      start */
+        0xAF,                   /* XOR A */
+        0xE0, 0x02,             /* LDH (SC), A      stop */
+        0x05,                   /* DEC B */
+        0x20, 0xF6,             /* JR NZ, loop */
+        0x3E, 0x81,             /* LD A, 0x81 */
+        0xE0, 0x02,             /* LDH (SC), A      last start */
+        0x18, 0xFE              /* JR $ */
+    };
+
+    memcpy(&rom[0x100], entry, sizeof(entry));
+    memcpy(&rom[CODE_ADDR], code, sizeof(code));
+
+    gb_instance_t *gb = emulator_create();
+    emulator_init(gb, rom, ROM_SIZE);
+    serial_set_output_hook(gb, on_serial_output);
+
+    m_cycle_t start = cpu_get_cycles(gb);
+    emulator_run_frame(gb);
+
+    m_cycle_t expected = start + LAST_RESTART_CYCLES + SERIAL_TRANSFER_CYCLES;
+    bool ok = bytes_out == 1 && last_byte == 0x41
+        && last_byte_cycles + MAX_EVENT_LATENESS >= expected
+        && last_byte_cycles <= expected + MAX_EVENT_LATENESS;
+
+    printf("%d restarts: %u byte(s) out, last 0x%02X at +%llu, expected +%llu: %s\n",
+        RESTARTS, bytes_out, last_byte,
+        (unsigned long long) (last_byte_cycles - start), (unsigned long long) (expected - start),
+        ok ? "ok" : "FAILED");
+
+    emulator_destroy(gb);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
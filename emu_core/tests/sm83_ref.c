@@ -0,0 +1,448 @@
+#include "sm83_ref.h"
+
+/*
+    M-cycles per opcode, conditional branches not taken.
+    Taken branches use `cycles_taken` instead.
+*/
+static const uint8_t cycles[256] = {
+/*        0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F */
+/* 0 */   1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,
+/* 1 */   1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
+/* 2 */   2, 3, 2, 2, 1, 1, 2, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+/* 3 */   2, 3, 2, 2, 3, 3, 3, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+/* 4 */   1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+/* 5 */   1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+/* 6 */   1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+/* 7 */   2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1,
+/* 8 */   1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+/* 9 */   1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+/* A */   1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+/* B */   1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+/* C */   2, 3, 3, 4, 3, 4, 2, 4, 2, 4, 3, 0, 3, 6, 2, 4,
+/* D */   2, 3, 3, 0, 3, 4, 2, 4, 2, 4, 3, 0, 3, 0, 2, 4,
+/* E */   3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,
+/* F */   3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4,
+};
+
+/* Taken JR/JP/CALL/RET cc */
+static const uint8_t cycles_taken[4] = {
+    [0] = 3,    /* JR cc */
+    [1] = 5,    /* RET cc */
+    [2] = 4,    /* JP cc */
+    [3] = 6,    /* CALL cc */
+};
+
+/* Locks up the CPU */
+static const uint8_t illegal_opcodes[] = { 0xD3, 0xDB, 0xDD, 0xE3, 0xE4, 0xEB, 0xEC, 0xED, 0xF4, 0xFC, 0xFD };
+
+typedef struct ref {
+    sm83_state_t *s;
+    const sm83_bus_t *bus;
+} ref_t;
+
+bool sm83_is_legal(uint8_t opcode)
+{
+    for (unsigned i = 0; i < sizeof(illegal_opcodes); ++i){
+        if (illegal_opcodes[i] == opcode) return false;
+    }
+    return true;
+}
+
+static uint8_t rd(ref_t *r, uint16_t addr)
+{
+    return r->bus->read(r->bus->context, addr);
+}
+
+static void wr(ref_t *r, uint16_t addr, uint8_t value)
+{
+    r->bus->write(r->bus->context, addr, value);
+}
+
+static uint8_t imm8(ref_t *r)
+{
+    return rd(r, r->s->pc++);
+}
+
+static uint16_t imm16(ref_t *r)
+{
+    uint8_t lo = imm8(r);
+    return (uint16_t) (lo | (imm8(r) << 8));
+}
+
+static uint16_t get_bc(ref_t *r) { return (uint16_t) ((r->s->b << 8) | r->s->c); }
+static uint16_t get_de(ref_t *r) { return (uint16_t) ((r->s->d << 8) | r->s->e); }
+static uint16_t get_hl(ref_t *r) { return (uint16_t) ((r->s->h << 8) | r->s->l); }
+static void set_bc(ref_t *r, uint16_t v) { r->s->b = (uint8_t) (v >> 8); r->s->c = (uint8_t) v; }
+static void set_de(ref_t *r, uint16_t v) { r->s->d = (uint8_t) (v >> 8); r->s->e = (uint8_t) v; }
+static void set_hl(ref_t *r, uint16_t v) { r->s->h = (uint8_t) (v >> 8); r->s->l = (uint8_t) v; }
+
+/* r8 operand: B C D E H L (HL) A */
+static uint8_t get_r8(ref_t *r, unsigned index)
+{
+    switch (index){
+        case 0: return r->s->b;
+        case 1: return r->s->c;
+        case 2: return r->s->d;
+        case 3: return r->s->e;
+        case 4: return r->s->h;
+        case 5: return r->s->l;
+        case 6: return rd(r, get_hl(r));
+        default: return r->s->a;
+    }
+}
+
+static void set_r8(ref_t *r, unsigned index, uint8_t v)
+{
+    switch (index){
+        case 0: r->s->b = v; break;
+        case 1: r->s->c = v; break;
+        case 2: r->s->d = v; break;
+        case 3: r->s->e = v; break;
+        case 4: r->s->h = v; break;
+        case 5: r->s->l = v; break;
+        case 6: wr(r, get_hl(r), v); break;
+        default: r->s->a = v; break;
+    }
+}
+
+/* r16 operand: BC DE HL SP */
+static uint16_t get_r16(ref_t *r, unsigned index)
+{
+    switch (index){
+        case 0: return get_bc(r);
+        case 1: return get_de(r);
+        case 2: return get_hl(r);
+        default: return r->s->sp;
+    }
+}
+
+static void set_r16(ref_t *r, unsigned index, uint16_t v)
+{
+    switch (index){
+        case 0: set_bc(r, v); break;
+        case 1: set_de(r, v); break;
+        case 2: set_hl(r, v); break;
+        default: r->s->sp = v; break;
+    }
+}
+
+static uint8_t flags(bool z, bool n, bool h, bool c)
+{
+    return (uint8_t) ((z ? SM83_FLAG_Z : 0) | (n ? SM83_FLAG_N : 0) | (h ? SM83_FLAG_H : 0) | (c ? SM83_FLAG_C : 0));
+}
+
+static bool carry(ref_t *r)
+{
+    return (r->s->f & SM83_FLAG_C) != 0;
+}
+
+/* NZ Z NC C */
+static bool condition(ref_t *r, unsigned cc)
+{
+    switch (cc & 3){
+        case 0: return !(r->s->f & SM83_FLAG_Z);
+        case 1: return (r->s->f & SM83_FLAG_Z) != 0;
+        case 2: return !carry(r);
+        default: return carry(r);
+    }
+}
+
+static void push16(ref_t *r, uint16_t v)
+{
+    wr(r, --r->s->sp, (uint8_t) (v >> 8));
+    wr(r, --r->s->sp, (uint8_t) v);
+}
+
+static uint16_t pop16(ref_t *r)
+{
+    uint8_t lo = rd(r, r->s->sp++);
+    return (uint16_t) (lo | (rd(r, r->s->sp++) << 8));
+}
+
+/* ADD ADC SUB SBC AND XOR OR CP */
+static void alu(ref_t *r, unsigned op, uint8_t b)
+{
+    uint8_t a = r->s->a;
+    unsigned c = 0, result;
+
+    switch (op){
+        case 1: c = carry(r); /* fall through */
+        case 0:
+            result = a + b + c;
+            r->s->f = flags((uint8_t) result == 0, false, (a & 0xF) + (b & 0xF) + c > 0xF, result > 0xFF);
+            r->s->a = (uint8_t) result;
+            break;
+        case 3: c = carry(r); /* fall through */
+        case 2:
+        case 7:
+            result = a - b - c;
+            r->s->f = flags((uint8_t) result == 0, true, (a & 0xF) < (b & 0xF) + c, a < b + c);
+            if (op != 7) r->s->a = (uint8_t) result;
+            break;
+        case 4:
+            r->s->a = a & b;
+            r->s->f = flags(r->s->a == 0, false, true, false);
+            break;
+        case 5:
+            r->s->a = a ^ b;
+            r->s->f = flags(r->s->a == 0, false, false, false);
+            break;
+        default:
+            r->s->a = a | b;
+            r->s->f = flags(r->s->a == 0, false, false, false);
+            break;
+    }
+}
+
+/* RLC RRC RL RR SLA SRA SWAP SRL, Z/C flags set, N/H cleared */
+static uint8_t rotate(ref_t *r, unsigned op, uint8_t v, bool *out)
+{
+    switch (op){
+        case 0: *out = v >> 7; return (uint8_t) ((v << 1) | (v >> 7));
+        case 1: *out = v & 1; return (uint8_t) ((v >> 1) | (v << 7));
+        case 2: *out = v >> 7; return (uint8_t) ((v << 1) | carry(r));
+        case 3: *out = v & 1; return (uint8_t) ((v >> 1) | (carry(r) << 7));
+        case 4: *out = v >> 7; return (uint8_t) (v << 1);
+        case 5: *out = v & 1; return (uint8_t) ((v >> 1) | (v & 0x80));
+        case 6: *out = false; return (uint8_t) ((v << 4) | (v >> 4));
+        default: *out = v & 1; return (uint8_t) (v >> 1);
+    }
+}
+
+static unsigned step_cb(ref_t *r)
+{
+    uint8_t op = imm8(r);
+    unsigned index = op & 7, bit = (op >> 3) & 7;
+    uint8_t v = get_r8(r, index);
+    bool out;
+
+    switch (op >> 6){
+        case 0:
+            v = rotate(r, bit, v, &out);
+            r->s->f = flags(v == 0, false, false, out);
+            set_r8(r, index, v);
+            return (index == 6) ? 4 : 2;
+        case 1:
+            r->s->f = (uint8_t) (flags(!(v & (1u << bit)), false, true, false) | (r->s->f & SM83_FLAG_C));
+            return (index == 6) ? 3 : 2;
+        case 2:
+            set_r8(r, index, (uint8_t) (v & ~(1u << bit)));
+            return (index == 6) ? 4 : 2;
+        default:
+            set_r8(r, index, (uint8_t) (v | (1u << bit)));
+            return (index == 6) ? 4 : 2;
+    }
+}
+
+static uint16_t add_sp_e8(ref_t *r)
+{
+    uint8_t e = imm8(r);
+    uint16_t sp = r->s->sp;
+    r->s->f = flags(false, false, (sp & 0xF) + (e & 0xF) > 0xF, (sp & 0xFF) + e > 0xFF);
+    return (uint16_t) (sp + (int8_t) e);
+}
+
+static void daa(ref_t *r)
+{
+    uint8_t a = r->s->a, f = r->s->f, adjust = 0;
+    bool c = f & SM83_FLAG_C;
+
+    if (f & SM83_FLAG_N){
+        if (f & SM83_FLAG_H) adjust |= 0x06;
+        if (c) adjust |= 0x60;
+        a -= adjust;
+    } else {
+        if ((f & SM83_FLAG_H) || (a & 0xF) > 9) adjust |= 0x06;
+        if (c || a > 0x99){
+            adjust |= 0x60;
+            c = true;
+        }
+        a += adjust;
+    }
+
+    r->s->a = a;
+    r->s->f = (uint8_t) (flags(a == 0, false, false, c) | (f & SM83_FLAG_N));
+}
+
+unsigned sm83_step(sm83_state_t *state, const sm83_bus_t *bus)
+{
+    ref_t ref = { .s = state, .bus = bus };
+    ref_t *r = &ref;
+    sm83_state_t *s = state;
+
+    /* EI takes effect after the instruction that follows it */
+    bool enable_ime = s->ime_pending;
+    s->ime_pending = false;
+
+    uint8_t op = imm8(r);
+    unsigned taken = 0;
+    unsigned x = op >> 6, y = (op >> 3) & 7, z = op & 7, p = y >> 1;
+
+    if (op == 0xCB){
+        unsigned cb_cycles = step_cb(r);
+        if (enable_ime) s->ime = true;
+        return cb_cycles;
+    }
+
+    switch (x){
+    case 0:
+        switch (z){
+        case 0:
+            if (op == 0x00) break;
+            if (op == 0x08){
+                uint16_t addr = imm16(r);
+                wr(r, addr, (uint8_t) s->sp);
+                wr(r, (uint16_t) (addr + 1), (uint8_t) (s->sp >> 8));
+            } else if (op == 0x10){
+                imm8(r);
+                s->stopped = true;
+            } else {
+                int8_t e = (int8_t) imm8(r);
+                if (op == 0x18 || condition(r, y - 4)){
+                    s->pc = (uint16_t) (s->pc + e);
+                    if (op != 0x18) taken = cycles_taken[0];
+                }
+            }
+            break;
+        case 1:
+            if (y & 1){
+                uint16_t hl = get_hl(r), v = get_r16(r, p);
+                s->f = (uint8_t) ((s->f & SM83_FLAG_Z) | flags(false, false, (hl & 0xFFF) + (v & 0xFFF) > 0xFFF, hl + v > 0xFFFF));
+                set_hl(r, (uint16_t) (hl + v));
+            } else {
+                set_r16(r, p, imm16(r));
+            }
+            break;
+        case 2: {
+            uint16_t addr = (p == 0) ? get_bc(r) : (p == 1) ? get_de(r) : get_hl(r);
+            if (y & 1) s->a = rd(r, addr);
+            else wr(r, addr, s->a);
+            if (p == 2) set_hl(r, (uint16_t) (addr + 1));
+            if (p == 3) set_hl(r, (uint16_t) (addr - 1));
+            break;
+        }
+        case 3:
+            set_r16(r, p, (uint16_t) (get_r16(r, p) + ((y & 1) ? -1 : 1)));
+            break;
+        case 4: {
+            uint8_t v = (uint8_t) (get_r8(r, y) + 1);
+            s->f = (uint8_t) ((s->f & SM83_FLAG_C) | flags(v == 0, false, (v & 0xF) == 0, false));
+            set_r8(r, y, v);
+            break;
+        }
+        case 5: {
+            uint8_t v = (uint8_t) (get_r8(r, y) - 1);
+            s->f = (uint8_t) ((s->f & SM83_FLAG_C) | flags(v == 0, true, (v & 0xF) == 0xF, false));
+            set_r8(r, y, v);
+            break;
+        }
+        case 6:
+            set_r8(r, y, imm8(r));
+            break;
+        default: {
+            bool out;
+            switch (y){
+                case 4: daa(r); break;
+                case 5: s->a = (uint8_t) ~s->a; s->f |= SM83_FLAG_N | SM83_FLAG_H; break;
+                case 6: s->f = (uint8_t) ((s->f & SM83_FLAG_Z) | SM83_FLAG_C); break;
+                case 7: s->f = (uint8_t) ((s->f & SM83_FLAG_Z) | (carry(r) ? 0 : SM83_FLAG_C)); break;
+                default:
+                    /* RLCA RRCA RLA RRA: like the CB ones, Z always cleared */
+                    s->a = rotate(r, y, s->a, &out);
+                    s->f = flags(false, false, false, out);
+                    break;
+            }
+            break;
+        }
+        }
+        break;
+
+    case 1:
+        if (op == 0x76) s->halted = true;
+        else set_r8(r, y, get_r8(r, z));
+        break;
+
+    case 2:
+        alu(r, y, get_r8(r, z));
+        break;
+
+    default:
+        switch (op){
+        case 0xC0: case 0xC8: case 0xD0: case 0xD8:
+            if (condition(r, y)){
+                s->pc = pop16(r);
+                taken = cycles_taken[1];
+            }
+            break;
+        case 0xC1: case 0xD1: case 0xE1:
+            set_r16(r, p, pop16(r));
+            break;
+        case 0xF1: {
+            uint16_t v = pop16(r);
+            s->a = (uint8_t) (v >> 8);
+            s->f = (uint8_t) (v & 0xF0);
+            break;
+        }
+        case 0xC2: case 0xCA: case 0xD2: case 0xDA: {
+            uint16_t addr = imm16(r);
+            if (condition(r, y)){
+                s->pc = addr;
+                taken = cycles_taken[2];
+            }
+            break;
+        }
+        case 0xC3: s->pc = imm16(r); break;
+        case 0xC4: case 0xCC: case 0xD4: case 0xDC: {
+            uint16_t addr = imm16(r);
+            if (condition(r, y)){
+                push16(r, s->pc);
+                s->pc = addr;
+                taken = cycles_taken[3];
+            }
+            break;
+        }
+        case 0xC5: case 0xD5: case 0xE5:
+            push16(r, get_r16(r, p));
+            break;
+        case 0xF5:
+            push16(r, (uint16_t) ((s->a << 8) | s->f));
+            break;
+        case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+            alu(r, y, imm8(r));
+            break;
+        case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+            push16(r, s->pc);
+            s->pc = (uint16_t) (y * 8);
+            break;
+        case 0xC9: s->pc = pop16(r); break;
+        case 0xD9: s->pc = pop16(r); s->ime = true; break;
+        case 0xCD: {
+            uint16_t addr = imm16(r);
+            push16(r, s->pc);
+            s->pc = addr;
+            break;
+        }
+        case 0xE0: wr(r, (uint16_t) (0xFF00 | imm8(r)), s->a); break;
+        case 0xF0: s->a = rd(r, (uint16_t) (0xFF00 | imm8(r))); break;
+        case 0xE2: wr(r, (uint16_t) (0xFF00 | s->c), s->a); break;
+        case 0xF2: s->a = rd(r, (uint16_t) (0xFF00 | s->c)); break;
+        case 0xEA: wr(r, imm16(r), s->a); break;
+        case 0xFA: s->a = rd(r, imm16(r)); break;
+        case 0xE8: s->sp = add_sp_e8(r); break;
+        case 0xF8: set_hl(r, add_sp_e8(r)); break;
+        case 0xE9: s->pc = get_hl(r); break;
+        case 0xF9: s->sp = get_hl(r); break;
+        case 0xF3: s->ime = false; enable_ime = false; break;
+        case 0xFB: s->ime_pending = !s->ime; break;
+        default:
+            /* Illegal, the CPU hangs */
+            s->pc--;
+            s->halted = true;
+            return 1;
+        }
+        break;
+    }
+
+    if (enable_ime) s->ime = true;
+    return taken ? taken : cycles[op];
+}
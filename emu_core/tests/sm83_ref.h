@@ -0,0 +1,51 @@
+#ifndef SM83_REF_H
+#define SM83_REF_H
+
+/**
+ *  Reference model of the SM83 instruction set, for the differential
+ *  fuzzer. Written from the documented semantics and kept independent of
+ *  the core: plain registers, flags computed eagerly, cycle counts from
+ *  its own tables.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SM83_FLAG_Z                 0x80
+#define SM83_FLAG_N                 0x40
+#define SM83_FLAG_H                 0x20
+#define SM83_FLAG_C                 0x10
+
+typedef struct sm83_state {
+    uint8_t a, f, b, c, d, e, h, l;
+    uint16_t sp;
+    uint16_t pc;
+
+    /* IME, and IME set by EI but not in effect yet */
+    bool ime;
+    bool ime_pending;
+
+    bool halted;
+    bool stopped;
+} sm83_state_t;
+
+typedef uint8_t (*sm83_read_t)(void *context, uint16_t addr);
+typedef void (*sm83_write_t)(void *context, uint16_t addr, uint8_t value);
+
+typedef struct sm83_bus {
+    sm83_read_t read;
+    sm83_write_t write;
+    void *context;
+} sm83_bus_t;
+
+/**
+ *  Returns false for the opcodes that lock up the CPU (0xD3, 0xDB, ...).
+ */
+bool sm83_is_legal(uint8_t opcode);
+
+/**
+ *  Runs the instruction at PC. Returns the M-cycles it took.
+ */
+unsigned sm83_step(sm83_state_t *state, const sm83_bus_t *bus);
+
+#endif // SM83_REF_H